@@ -0,0 +1,140 @@
+/*
+  ==============================================================================
+
+    AnalysisDisplay.h
+    Created: 23 Oct 2026 11:20:09am
+    Author:  70
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include <cmath>
+#include "SignalAnalyser.h"
+
+/**
+ * @class AnalysisDisplay
+ *
+ * @brief Oscilloscope, spectrum and voice activity of the plugin output, side by side.
+ *
+ * The analysis runs on the thread of its SignalAnalyser, which only exists while the display does, so
+ * a closed editor costs nothing but the copy into the AnalysisFeed. The display polls for new results
+ * at the frame rate of the analyser and only repaints when there is one.
+ */
+class AnalysisDisplay : public juce::Component,
+                        private juce::Timer
+{
+public:
+    static constexpr int framesPerSecond = 30;
+
+    explicit AnalysisDisplay (AnalysisFeed& feed)
+        : analyser (feed, framesPerSecond)
+    {
+        setOpaque (true);
+        startTimerHz (framesPerSecond);
+    }
+
+    void paint (juce::Graphics& g) override
+    {
+        g.fillAll (juce::Colours::black);
+
+        auto area = getLocalBounds().reduced (4);
+        auto voiceArea = area.removeFromRight (area.getWidth() / 5);
+        auto scopeArea = area.removeFromLeft (area.getWidth() / 2);
+        paintScope (g, scopeArea.reduced (4).toFloat());
+        paintSpectrum (g, area.reduced (4).toFloat());
+        paintVoices (g, voiceArea.reduced (4).toFloat());
+    }
+
+private:
+    SignalAnalyser analyser;
+    SignalAnalyser::Snapshot snapshot;
+    juce::Path path;
+
+    void timerCallback() override
+    {
+        if (analyser.getLatest (snapshot))
+            repaint();
+    }
+
+    void paintScope (juce::Graphics& g, juce::Rectangle<float> area)
+    {
+        g.setColour (juce::Colours::darkgrey);
+        g.drawRect (area);
+        g.drawHorizontalLine ((int) area.getCentreY(), area.getX(), area.getRight());
+
+        // The voices output +-0.25 at most before the effects, so +-0.5 fills the scope with headroom
+        path.clear();
+        for (int i = 0; i < SignalAnalyser::scopeSize; ++i)
+        {
+            float x = area.getX() + area.getWidth() * i / (SignalAnalyser::scopeSize - 1);
+            float y = area.getCentreY() - area.getHeight() * juce::jlimit (-0.5f, 0.5f, snapshot.scope[(size_t) i]);
+            if (i == 0)
+                path.startNewSubPath (x, y);
+            else
+                path.lineTo (x, y);
+        }
+        g.setColour (juce::Colours::lime);
+        g.strokePath (path, juce::PathStrokeType (1.5f));
+    }
+
+    /// Draws the spectrum from 20 Hz to 20 kHz on a log axis, -100 to 0 dB, with a line every 20 dB.
+    void paintSpectrum (juce::Graphics& g, juce::Rectangle<float> area)
+    {
+        g.setColour (juce::Colours::darkgrey);
+        g.drawRect (area);
+        for (int db = -20; db > -100; db -= 20)
+            g.drawHorizontalLine ((int) (area.getY() - area.getHeight() * db / 100.0f), area.getX(), area.getRight());
+
+        const float minHz = 20.0f, maxHz = 20000.0f;
+        float binHz = (float) snapshot.sampleRate / SignalAnalyser::fftSize;
+        path.clear();
+        bool started = false;
+        for (int bin = 1; bin < SignalAnalyser::fftSize / 2; ++bin)
+        {
+            float hz = bin * binHz;
+            if (hz < minHz || hz > maxHz)
+                continue;
+
+            float x = area.getX() + area.getWidth() * std::log (hz / minHz) / std::log (maxHz / minHz);
+            float y = area.getY() - area.getHeight() * snapshot.spectrumDb[(size_t) bin] / 100.0f;
+            if (started)
+                path.lineTo (x, y);
+            else
+                path.startNewSubPath (x, y);
+            started = true;
+        }
+        g.setColour (juce::Colours::orange);
+        g.strokePath (path, juce::PathStrokeType (1.0f));
+    }
+
+    /// Draws one bar per voice, as high as its envelope level, labelled with the note it plays.
+    void paintVoices (juce::Graphics& g, juce::Rectangle<float> area)
+    {
+        g.setColour (juce::Colours::darkgrey);
+        g.drawRect (area);
+        if (snapshot.numVoices == 0)
+            return;
+
+        float barWidth = area.getWidth() / snapshot.numVoices;
+        g.setFont (10.0f);
+        for (int i = 0; i < snapshot.numVoices; ++i)
+        {
+            float x = area.getX() + barWidth * i;
+            float height = (area.getHeight() - 12.0f) * juce::jlimit (0.0f, 1.0f, snapshot.voiceLevels[(size_t) i]);
+            g.setColour (juce::Colours::cyan);
+            g.fillRect (x + 1.0f, area.getBottom() - 12.0f - height, barWidth - 2.0f, height);
+
+            if (snapshot.voiceNotes[(size_t) i] >= 0)
+            {
+                g.setColour (juce::Colours::white);
+                g.drawText (juce::String (snapshot.voiceNotes[(size_t) i]),
+                            juce::Rectangle<float> (x, area.getBottom() - 12.0f, barWidth, 12.0f),
+                            juce::Justification::centred);
+            }
+        }
+    }
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AnalysisDisplay)
+};
@@ -0,0 +1,89 @@
+/*
+  ==============================================================================
+
+    ChiptuneState.h
+    Created: 18 Oct 2026 2:40:03pm
+    Author:  70
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include "Core/ChiptuneParameters.h"
+#include "Core/KeyZoneMap.h"
+
+/**
+ * @brief Conversions between the JUCE-free core types and the plugin's saved state.
+ *
+ * The core (Source/Core) has no dependency on JUCE, so everything that touches a juce::ValueTree
+ * lives here, on the plugin side.
+ */
+namespace ChiptuneState
+{
+    /**
+     * @brief Reads the parameters from a saved state tree.
+     *
+     * The tree is expected in the format written by `AudioProcessorValueTreeState::copyState()`, which
+     * is also what the plugin's presets contain: a list of `PARAM` children with `id` and `value`
+     * properties. Parameters missing from the tree keep their default value.
+     */
+    inline ChiptuneParameters parametersFromValueTree(const juce::ValueTree& state)
+    {
+        ChiptuneParameters parameters;
+        for (int i = 0; i < state.getNumChildren(); ++i)
+        {
+            auto child = state.getChild(i);
+            if (child.hasType("PARAM"))
+                parameters.set(child.getProperty("id").toString().toRawUTF8(), static_cast<float>(child.getProperty("value")));
+        }
+        return parameters;
+    }
+
+    /// Writes a parameter snapshot as a tree of `PARAM` children, in the same format as the plugin state.
+    inline juce::ValueTree parametersToValueTree(const ChiptuneParameters& parameters, const juce::Identifier& type)
+    {
+        juce::ValueTree state(type);
+        for (int i = 0; i < ChiptuneParameters::numParameters; ++i)
+        {
+            juce::ValueTree param("PARAM");
+            param.setProperty("id", ChiptuneParameters::getId(i), nullptr);
+            param.setProperty("value", parameters.get(static_cast<ChiptuneParameters::Index>(i)), nullptr);
+            state.appendChild(param, nullptr);
+        }
+        return state;
+    }
+
+    /// Writes the key zones as a "KeyZones" tree, each zone holding its parameters as a preset tree.
+    inline juce::ValueTree keyZonesToValueTree(const KeyZoneMap& keyZones)
+    {
+        juce::ValueTree tree("KeyZones");
+        for (int i = 0; i < keyZones.getNumZones(); ++i)
+        {
+            const auto& zone = keyZones.getZone(i);
+            juce::ValueTree zoneTree("Zone");
+            zoneTree.setProperty("name", juce::String(zone.name), nullptr);
+            zoneTree.setProperty("lowNote", zone.lowNote, nullptr);
+            zoneTree.setProperty("highNote", zone.highNote, nullptr);
+            zoneTree.appendChild(parametersToValueTree(zone.parameters, "ParamTree"), nullptr);
+            tree.appendChild(zoneTree, nullptr);
+        }
+        return tree;
+    }
+
+    /// Replaces the zones with those stored in a tree written by keyZonesToValueTree().
+    inline void keyZonesFromValueTree(KeyZoneMap& keyZones, const juce::ValueTree& tree)
+    {
+        keyZones.clear();
+        for (int i = 0; i < tree.getNumChildren(); ++i)
+        {
+            auto zoneTree = tree.getChild(i);
+            if (! zoneTree.hasType("Zone"))
+                continue;
+
+            keyZones.addZone(zoneTree.getProperty("lowNote"), zoneTree.getProperty("highNote"),
+                             parametersFromValueTree(zoneTree.getChildWithName("ParamTree")),
+                             zoneTree.getProperty("name").toString().toStdString());
+        }
+    }
+}
@@ -0,0 +1,289 @@
+/*
+  ==============================================================================
+
+    AdpcmEncoder.h
+    Created: 20 Oct 2026 2:14:36pm
+    Author:  70
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <string>
+
+/**
+ * @class AdpcmEncoder
+ *
+ * @brief Streams mono float audio to a 4-bit IMA ADPCM WAV file, a quarter of the size of 16-bit PCM.
+ *
+ * Samples are encoded as they arrive, in WAV blocks of 256 bytes (505 samples) that each start with the
+ * predictor state, so the file can be decoded from any block. Only the block being filled is kept in
+ * memory. An optional loop is stored in a `smpl` chunk.
+ *
+ * Pulse waves are hard on IMA ADPCM: its step size adapts slowly to their edges. Instead of the usual
+ * greedy quantizer, each nibble is picked by trying all 16 against the next sample too, which lets the
+ * step grow before an edge and shrink after it. This costs one sample of latency.
+ *
+ * The encoder runs the decoder alongside, so getSnr() reports the signal-to-noise ratio of the encode.
+ */
+class AdpcmEncoder
+{
+public:
+    AdpcmEncoder() = default;
+    ~AdpcmEncoder() { close(); }
+
+    AdpcmEncoder(const AdpcmEncoder&) = delete;
+    AdpcmEncoder& operator=(const AdpcmEncoder&) = delete;
+
+    /**
+     * @brief Creates or overwrites a file. Returns false if it cannot be opened.
+     *
+     * @param loopStart  first sample of the loop, or -1 for no loop
+     * @param loopEnd    last sample of the loop, inclusive
+     */
+    bool open(const std::string& path, double sampleRate, int64_t loopStart = -1, int64_t loopEnd = -1)
+    {
+        close();
+        file = std::fopen(path.c_str(), "wb");
+        if (file == nullptr)
+            return false;
+
+        rate = static_cast<uint32_t>(sampleRate);
+        loop[0] = loopStart;
+        loop[1] = loopEnd;
+        numSamples = 0;
+        dataBytes = 0;
+        blockFill = 0;
+        hasPending = false;
+        predictor = 0;
+        stepIndex = 0;
+        signalEnergy = 0.0;
+        errorEnergy = 0.0;
+        writeHeader();
+        return true;
+    }
+
+    /// Encodes samples in [-1, 1] and writes every completed block.
+    void write(const float* samples, int count)
+    {
+        if (file == nullptr)
+            return;
+
+        for (int i = 0; i < count; ++i)
+        {
+            int sample = static_cast<int>(std::lrint(std::clamp(samples[i], -1.0f, 1.0f) * 32767.0f));
+            if (hasPending)
+                encodeSample(pendingSample, &sample);
+            pendingSample = sample;
+            hasPending = true;
+        }
+    }
+
+    /// Writes the last partial block and the loop, patches the header sizes and closes the file.
+    void close()
+    {
+        if (file == nullptr)
+            return;
+
+        if (hasPending)
+            encodeSample(pendingSample, nullptr);
+        hasPending = false;
+        flushBlock();
+        if ((dataBytes & 1) != 0)
+            std::fputc(0, file); // Chunks are padded to an even size
+
+        uint32_t smplBytes = 0;
+        if (loop[0] >= 0 && loop[1] > loop[0])
+        {
+            // smpl chunk: manufacturer, product, period, unity note, pitch fraction, SMPTE format and
+            // offset, one loop, no extra data, then the loop: id, forward, start, end, fraction, count
+            const uint32_t fields[] = { 0, 0, 1000000000u / std::max(1u, rate), 60, 0, 0, 0, 1, 0,
+                                        0, 0, static_cast<uint32_t>(loop[0]), static_cast<uint32_t>(loop[1]), 0, 0 };
+            std::fwrite("smpl", 1, 4, file);
+            writeUint32(sizeof(fields));
+            for (uint32_t field : fields)
+                writeUint32(field);
+            smplBytes = 8 + sizeof(fields);
+        }
+
+        std::fseek(file, 4, SEEK_SET);
+        writeUint32(static_cast<uint32_t>(headerBytes - 8 + dataBytes + (dataBytes & 1) + smplBytes));
+        std::fseek(file, factOffset, SEEK_SET);
+        writeUint32(static_cast<uint32_t>(numSamples));
+        std::fseek(file, headerBytes - 4, SEEK_SET);
+        writeUint32(static_cast<uint32_t>(dataBytes));
+        std::fclose(file);
+        file = nullptr;
+    }
+
+    /// Returns the number of samples encoded so far.
+    int64_t getNumSamplesWritten() const { return numSamples; }
+
+    /// Returns the signal-to-noise ratio of the encode so far in dB, infinite if it is lossless.
+    double getSnr() const
+    {
+        if (errorEnergy <= 0.0)
+            return std::numeric_limits<double>::infinity();
+        return 10.0 * std::log10(std::max(signalEnergy, 1.0e-30) / errorEnergy);
+    }
+
+private:
+    static constexpr int blockBytes = 256;
+    static constexpr int samplesPerBlock = (blockBytes - 4) * 2 + 1;
+    static constexpr long factOffset = 48;   // Offset of the sample count in the fact chunk.
+    static constexpr long headerBytes = 60;  // RIFF, fmt (20 bytes), fact and data chunk headers.
+
+    std::FILE* file = nullptr;
+    uint32_t rate = 44100;
+    int64_t loop[2] = { -1, -1 };
+    int64_t numSamples = 0;
+    uint64_t dataBytes = 0;
+    uint8_t block[blockBytes] = {};
+    int blockFill = 0;       // Samples in the current block.
+    int predictor = 0;       // Decoder state, tracked to encode each difference against what will be decoded.
+    int stepIndex = 0;
+    int pendingSample = 0;   // Sample waiting for the next one, which its encoding looks ahead to.
+    bool hasPending = false;
+    double signalEnergy = 0.0;
+    double errorEnergy = 0.0;
+
+    static int getStep(int index)
+    {
+        static const int16_t steps[89] = {
+            7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45, 50, 55, 60, 66, 73, 80, 88, 97,
+            107, 118, 130, 143, 157, 173, 190, 209, 230, 253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658, 724, 796,
+            876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428,
+            4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899, 15289, 16818, 18500, 20350,
+            22385, 24623, 27086, 29794, 32767
+        };
+        return steps[index];
+    }
+
+    /// Decodes one nibble, updating the predictor and step index like a decoder.
+    static void decodeNibble(int nibble, int& predictor, int& stepIndex)
+    {
+        static const int8_t indexAdjust[8] = { -1, -1, -1, -1, 2, 4, 6, 8 };
+        int step = getStep(stepIndex);
+        int difference = step >> 3;
+        if ((nibble & 4) != 0) difference += step;
+        if ((nibble & 2) != 0) difference += step >> 1;
+        if ((nibble & 1) != 0) difference += step >> 2;
+
+        predictor = std::clamp(predictor + ((nibble & 8) != 0 ? -difference : difference), -32768, 32767);
+        stepIndex = std::clamp(stepIndex + indexAdjust[nibble & 7], 0, 88);
+    }
+
+    /// Picks the nibble whose error, plus the best error reachable on the next sample, is the smallest.
+    int chooseNibble(int sample, const int* next) const
+    {
+        int bestNibble = 0;
+        double bestError = std::numeric_limits<double>::max();
+        for (int nibble = 0; nibble < 16; ++nibble)
+        {
+            int nextPredictor = predictor, nextIndex = stepIndex;
+            decodeNibble(nibble, nextPredictor, nextIndex);
+            double error = double(sample - nextPredictor) * (sample - nextPredictor);
+
+            if (next != nullptr && error < bestError)
+            {
+                double bestNextError = std::numeric_limits<double>::max();
+                for (int nextNibble = 0; nextNibble < 16; ++nextNibble)
+                {
+                    int p = nextPredictor, index = nextIndex;
+                    decodeNibble(nextNibble, p, index);
+                    bestNextError = std::min(bestNextError, double(*next - p) * (*next - p));
+                }
+                error += bestNextError;
+            }
+
+            if (error < bestError)
+            {
+                bestError = error;
+                bestNibble = nibble;
+            }
+        }
+        return bestNibble;
+    }
+
+    /// Encodes one sample into the current block, looking ahead to the next one if there is one.
+    void encodeSample(int sample, const int* next)
+    {
+        int decoded;
+        if (blockFill == 0)
+        {
+            // The first sample of a block is stored verbatim in its header, with the step index
+            predictor = sample;
+            decoded = sample;
+            block[0] = uint8_t(sample);
+            block[1] = uint8_t(sample >> 8);
+            block[2] = uint8_t(stepIndex);
+            block[3] = 0;
+            std::fill(block + 4, block + blockBytes, uint8_t(0));
+        }
+        else
+        {
+            int nibble = chooseNibble(sample, next);
+            decodeNibble(nibble, predictor, stepIndex);
+            int position = blockFill - 1;
+            block[4 + position / 2] |= uint8_t(nibble << ((position & 1) * 4)); // Low nibble first
+            decoded = predictor;
+        }
+
+        signalEnergy += double(sample) * sample;
+        errorEnergy += double(sample - decoded) * (sample - decoded);
+        ++numSamples;
+
+        if (++blockFill == samplesPerBlock)
+            flushBlock();
+    }
+
+    /// Writes the current block, which may be partial at the end of the stream.
+    void flushBlock()
+    {
+        if (blockFill == 0)
+            return;
+
+        size_t bytes = 4 + static_cast<size_t>(blockFill) / 2; // A partial block holds only its own nibbles
+        dataBytes += std::fwrite(block, 1, bytes, file);
+        blockFill = 0;
+    }
+
+    void writeUint32(uint32_t value)
+    {
+        uint8_t bytes[] = { uint8_t(value), uint8_t(value >> 8), uint8_t(value >> 16), uint8_t(value >> 24) };
+        std::fwrite(bytes, 1, 4, file);
+    }
+
+    void writeUint16(uint16_t value)
+    {
+        uint8_t bytes[] = { uint8_t(value), uint8_t(value >> 8) };
+        std::fwrite(bytes, 1, 2, file);
+    }
+
+    /// Writes the RIFF, fmt, fact and data chunk headers, with zero sizes until close().
+    void writeHeader()
+    {
+        std::fwrite("RIFF", 1, 4, file);
+        writeUint32(0);
+        std::fwrite("WAVEfmt ", 1, 8, file);
+        writeUint32(20);
+        writeUint16(0x11); // WAVE_FORMAT_IMA_ADPCM
+        writeUint16(1);
+        writeUint32(rate);
+        writeUint32(rate * blockBytes / samplesPerBlock);
+        writeUint16(blockBytes);
+        writeUint16(4);
+        writeUint16(2);
+        writeUint16(samplesPerBlock);
+        std::fwrite("fact", 1, 4, file);
+        writeUint32(4);
+        writeUint32(0);
+        std::fwrite("data", 1, 4, file);
+        writeUint32(0);
+    }
+};
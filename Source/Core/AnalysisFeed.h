@@ -0,0 +1,100 @@
+/*
+  ==============================================================================
+
+    AnalysisFeed.h
+    Created: 23 Oct 2026 9:58:02am
+    Author:  70
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include "ChiptuneEngine.h"
+#include "TripleBuffer.h"
+
+/**
+ * @brief A window of output samples and the state of the voices at its end, for the visualisations.
+ */
+struct AnalysisFrame
+{
+    static constexpr int size = 2048;   // Samples per frame, also the FFT size of the spectrum
+    static constexpr int maxVoices = 16;
+
+    float samples[size];          // Left channel
+    float voiceLevels[maxVoices]; // Envelope level of each voice, 0 when free
+    int voiceNotes[maxVoices];    // MIDI note of each voice, -1 when free
+    int numVoices;
+    double sampleRate;
+    uint64_t frameIndex;          // Counts the frames published since the plugin was created
+};
+
+/**
+ * @class AnalysisFeed
+ *
+ * @brief Carries the engine output from the audio thread to the visualisations without slowing it down.
+ *
+ * The audio thread copies each block into the frame being filled with memcpy, two copies when the block
+ * straddles the end of a frame. Full frames are handed over through a TripleBuffer, which never blocks
+ * or allocates. The analysis thread picks up the latest full frame whenever it wants; frames it misses
+ * are simply dropped.
+ */
+class AnalysisFeed
+{
+public:
+    /// Called before playback starts, not concurrently with push().
+    void prepare(double newSampleRate)
+    {
+        sampleRate = newSampleRate;
+        writePosition = 0;
+    }
+
+    /// Audio thread: appends a block of output samples, publishing each frame as it fills up.
+    void push(const float* samples, int numSamples, const ChiptuneEngine& engine)
+    {
+        while (numSamples > 0)
+        {
+            AnalysisFrame& frame = frames.getWriteBuffer();
+            int count = std::min(numSamples, AnalysisFrame::size - writePosition);
+            std::memcpy(frame.samples + writePosition, samples, sizeof(float) * static_cast<size_t>(count));
+            writePosition += count;
+            samples += count;
+            numSamples -= count;
+
+            if (writePosition == AnalysisFrame::size)
+            {
+                captureVoices(frame, engine);
+                frame.sampleRate = sampleRate;
+                frame.frameIndex = nextFrameIndex++;
+                frames.publish();
+                writePosition = 0;
+            }
+        }
+    }
+
+    /// Analysis thread: picks up the latest frame, if a new one was published. Returns true if so.
+    bool update() { return frames.update(); }
+
+    /// Analysis thread: returns the frame picked up by the last successful update().
+    const AnalysisFrame& getFrame() const { return frames.getReadBuffer(); }
+
+private:
+    TripleBuffer<AnalysisFrame> frames;
+    int writePosition = 0;       // Samples already in the frame being filled
+    uint64_t nextFrameIndex = 0;
+    double sampleRate = 44100.0;
+
+    static void captureVoices(AnalysisFrame& frame, const ChiptuneEngine& engine)
+    {
+        frame.numVoices = std::min(engine.getNumVoices(), AnalysisFrame::maxVoices);
+        for (int i = 0; i < frame.numVoices; ++i)
+        {
+            const ChiptuneVoice& voice = engine.getVoice(i);
+            bool active = voice.isActive();
+            frame.voiceLevels[i] = active ? voice.getLevel() : 0.0f;
+            frame.voiceNotes[i] = active ? voice.getCurrentNote() : -1;
+        }
+    }
+};
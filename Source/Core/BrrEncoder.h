@@ -0,0 +1,244 @@
+/*
+  ==============================================================================
+
+    BrrEncoder.h
+    Created: 20 Oct 2026 3:02:51pm
+    Author:  70
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <string>
+
+/**
+ * @class BrrEncoder
+ *
+ * @brief Streams mono float audio to an SNES BRR file: 9-byte blocks of 16 samples at 4 bits each.
+ *
+ * Each block is encoded as soon as its 16 samples have arrived, trying every filter and shift against
+ * the decoder state and keeping the one with the least error. One encoded block is held back, so the
+ * last one can be given the end flag on close(); nothing else is buffered.
+ *
+ * The SNES can only loop back to the start of a block, so the encoder pads the beginning with silence
+ * to bring the loop start onto a block boundary, see getPadding(). The loop must run to the end of the
+ * stream and its length must be a multiple of 16. The loop block uses filter 0, so it decodes the same
+ * whether it is reached from the start or by looping. Looped files start with the loop offset in bytes,
+ * as a 2-byte header.
+ *
+ * getSnr() reports the signal-to-noise ratio of the encode.
+ */
+class BrrEncoder
+{
+public:
+    static constexpr int samplesPerBlock = 16;
+
+    BrrEncoder() = default;
+    ~BrrEncoder() { close(); }
+
+    BrrEncoder(const BrrEncoder&) = delete;
+    BrrEncoder& operator=(const BrrEncoder&) = delete;
+
+    /**
+     * @brief Creates or overwrites a file. Returns false if it cannot be opened.
+     *
+     * @param loopStart  first sample of the loop, which runs to the end of the stream, or -1 for no loop
+     */
+    bool open(const std::string& path, int64_t loopStart = -1)
+    {
+        close();
+        file = std::fopen(path.c_str(), "wb");
+        if (file == nullptr)
+            return false;
+
+        looped = loopStart >= 0;
+        padding = looped ? static_cast<int>((samplesPerBlock - loopStart % samplesPerBlock) % samplesPerBlock) : 0;
+        loopBlock = looped ? (loopStart + padding) / samplesPerBlock : -1;
+        numBlocks = 0;
+        fill = 0;
+        pending = false;
+        previous[0] = previous[1] = 0;
+        signalEnergy = 0.0;
+        errorEnergy = 0.0;
+
+        if (looped)
+        {
+            auto offset = static_cast<uint16_t>(loopBlock * 9);
+            uint8_t header[] = { uint8_t(offset), uint8_t(offset >> 8) };
+            std::fwrite(header, 1, 2, file);
+        }
+
+        for (int i = 0; i < padding; ++i)
+            input[fill++] = 0;
+        return true;
+    }
+
+    /// Encodes samples in [-1, 1] and writes every completed block.
+    void write(const float* samples, int count)
+    {
+        if (file == nullptr)
+            return;
+
+        for (int i = 0; i < count; ++i)
+        {
+            // The SNES decodes to 15 bits
+            input[fill++] = static_cast<int>(std::lrint(std::clamp(samples[i], -1.0f, 1.0f) * 16383.0f));
+            if (fill == samplesPerBlock)
+                encodeBlock();
+        }
+    }
+
+    /// Pads and encodes the last partial block, writes it with the end flag and closes the file.
+    void close()
+    {
+        if (file == nullptr)
+            return;
+
+        if (fill > 0 || (! pending && numBlocks == 0))
+        {
+            std::fill(input + fill, input + samplesPerBlock, 0);
+            fill = samplesPerBlock;
+            encodeBlock();
+        }
+
+        pendingBlock[0] |= looped ? 0x03 : 0x01; // End flag, and loop flag to jump back to the loop block
+        std::fwrite(pendingBlock, 1, 9, file);
+        std::fclose(file);
+        file = nullptr;
+    }
+
+    /// Returns the number of silent samples inserted at the start to align the loop.
+    int getPadding() const { return padding; }
+
+    /// Returns the signal-to-noise ratio of the encode so far in dB, infinite if it is lossless.
+    double getSnr() const
+    {
+        if (errorEnergy <= 0.0)
+            return std::numeric_limits<double>::infinity();
+        return 10.0 * std::log10(std::max(signalEnergy, 1.0e-30) / errorEnergy);
+    }
+
+private:
+    std::FILE* file = nullptr;
+    bool looped = false;
+    int padding = 0;
+    int64_t loopBlock = -1;
+    int64_t numBlocks = 0;
+    int input[samplesPerBlock] = {};
+    int fill = 0;
+    uint8_t pendingBlock[9] = {};  // Encoded block waiting to learn whether it is the last one.
+    bool pending = false;
+    int previous[2] = { 0, 0 };    // Last two decoded samples, most recent first.
+    double signalEnergy = 0.0;
+    double errorEnergy = 0.0;
+
+    /// The decoder's prediction from the last two samples, for filters 0~3.
+    static int predict(int filter, int p1, int p2)
+    {
+        switch (filter)
+        {
+            case 1:  return p1 + ((-p1) >> 4);
+            case 2:  return p1 * 2 + ((-p1 * 3) >> 5) - p2 + (p2 >> 4);
+            case 3:  return p1 * 2 + ((-p1 * 13) >> 6) - p2 + ((p2 * 3) >> 4);
+            default: return 0;
+        }
+    }
+
+    /// Decodes one nibble the way the SNES does: scale, add the prediction, clamp to 16 bits and wrap to 15.
+    static int decode(int nibble, int shift, int filter, int p1, int p2)
+    {
+        int sample = (nibble << shift) >> 1;
+        sample = std::clamp(sample + predict(filter, p1, p2), -32768, 32767);
+        return static_cast<int16_t>(sample * 2) / 2;
+    }
+
+    /**
+     * @brief Encodes the 16 input samples with one filter and shift.
+     *
+     * @return the squared error, with the nibbles and decoded samples written to the arrays
+     */
+    double tryEncode(int filter, int shift, int* nibbles, int* decoded) const
+    {
+        int p1 = previous[0], p2 = previous[1];
+        double error = 0.0;
+        for (int i = 0; i < samplesPerBlock; ++i)
+        {
+            int residual = input[i] - predict(filter, p1, p2);
+            int nibble = std::clamp(static_cast<int>(std::lrint(residual * 2.0 / (1 << shift))), -8, 7);
+
+            // Rounding can land on the wrong side of the 15-bit wrap, check the neighbour too
+            int sample = decode(nibble, shift, filter, p1, p2);
+            for (int other : { nibble - 1, nibble + 1 })
+            {
+                if (other < -8 || other > 7)
+                    continue;
+                int otherSample = decode(other, shift, filter, p1, p2);
+                if (std::abs(otherSample - input[i]) < std::abs(sample - input[i]))
+                {
+                    nibble = other;
+                    sample = otherSample;
+                }
+            }
+
+            nibbles[i] = nibble;
+            decoded[i] = sample;
+            error += double(sample - input[i]) * (sample - input[i]);
+            p2 = p1;
+            p1 = sample;
+        }
+        return error;
+    }
+
+    /// Picks the best filter and shift for the buffered samples and queues the block.
+    void encodeBlock()
+    {
+        // The first block and the loop block cannot depend on samples before them
+        int maxFilter = (numBlocks == 0 || numBlocks == loopBlock) ? 0 : 3;
+
+        int bestNibbles[samplesPerBlock], bestDecoded[samplesPerBlock];
+        int nibbles[samplesPerBlock], decoded[samplesPerBlock];
+        int bestFilter = 0, bestShift = 0;
+        double bestError = std::numeric_limits<double>::max();
+        for (int filter = 0; filter <= maxFilter; ++filter)
+        {
+            for (int shift = 0; shift <= 12; ++shift)
+            {
+                double error = tryEncode(filter, shift, nibbles, decoded);
+                if (error < bestError)
+                {
+                    bestError = error;
+                    bestFilter = filter;
+                    bestShift = shift;
+                    std::copy(nibbles, nibbles + samplesPerBlock, bestNibbles);
+                    std::copy(decoded, decoded + samplesPerBlock, bestDecoded);
+                }
+            }
+        }
+
+        for (int i = 0; i < samplesPerBlock; ++i)
+        {
+            if (numBlocks * samplesPerBlock + i >= padding)
+            {
+                signalEnergy += double(input[i]) * input[i];
+                errorEnergy += double(bestDecoded[i] - input[i]) * (bestDecoded[i] - input[i]);
+            }
+        }
+        previous[0] = bestDecoded[samplesPerBlock - 1];
+        previous[1] = bestDecoded[samplesPerBlock - 2];
+
+        if (pending)
+            std::fwrite(pendingBlock, 1, 9, file);
+
+        pendingBlock[0] = uint8_t((bestShift << 4) | (bestFilter << 2));
+        for (int i = 0; i < samplesPerBlock; i += 2)
+            pendingBlock[1 + i / 2] = uint8_t(((bestNibbles[i] & 0x0f) << 4) | (bestNibbles[i + 1] & 0x0f)); // High nibble first
+        pending = true;
+        ++numBlocks;
+        fill = 0;
+    }
+};
@@ -0,0 +1,164 @@
+/*
+  ==============================================================================
+
+    ChiptuneCAPI.cpp
+    Created: 18 Oct 2026 2:14:26pm
+    Author:  70
+
+  ==============================================================================
+*/
+
+#include "ChiptuneCAPI.h"
+#include "ChiptuneEngine.h"
+#include "SfxRuntime.h"
+#include <new>
+
+/// The C handle is the engine itself, so every call is a direct call into the engine.
+struct ChiptuneSynth
+{
+    explicit ChiptuneSynth(int numVoices) : engine(numVoices) {}
+
+    ChiptuneEngine engine;
+};
+
+struct ChiptuneSfx
+{
+    ChiptuneSfx(int numRealVoices, int maxInstances) : runtime(numRealVoices, maxInstances) {}
+
+    SfxRuntime runtime;
+};
+
+ChiptuneSynth* chiptune_create (double sampleRate, int numVoices)
+{
+    if (sampleRate <= 0.0 || numVoices <= 0)
+        return nullptr;
+
+    auto* synth = new (std::nothrow) ChiptuneSynth (numVoices);
+    if (synth != nullptr)
+        synth->engine.prepare (sampleRate);
+    return synth;
+}
+
+void chiptune_destroy (ChiptuneSynth* synth)
+{
+    delete synth;
+}
+
+void chiptune_note_on (ChiptuneSynth* synth, int midiNoteNumber, float velocity)
+{
+    if (midiNoteNumber >= 0 && midiNoteNumber < 128)
+        synth->engine.noteOn (midiNoteNumber, velocity);
+}
+
+void chiptune_note_off (ChiptuneSynth* synth, int midiNoteNumber)
+{
+    synth->engine.noteOff (midiNoteNumber, true);
+}
+
+void chiptune_all_notes_off (ChiptuneSynth* synth)
+{
+    synth->engine.allNotesOff (true);
+}
+
+int chiptune_find_param (const char* parameterId)
+{
+    return parameterId != nullptr ? ChiptuneParameters::indexOf (parameterId) : -1;
+}
+
+int chiptune_set_param (ChiptuneSynth* synth, int parameterIndex, float value)
+{
+    if (parameterIndex < 0 || parameterIndex >= ChiptuneParameters::numParameters)
+        return 0;
+
+    synth->engine.setParameter (static_cast<ChiptuneParameters::Index> (parameterIndex), value);
+    return 1;
+}
+
+void chiptune_set_seed (ChiptuneSynth* synth, unsigned long long seed)
+{
+    synth->engine.setRandomSeed (seed);
+}
+
+void chiptune_set_quality (ChiptuneSynth* synth, int tier)
+{
+    synth->engine.setRenderQuality (RenderQuality::forTier (tier));
+}
+
+void chiptune_render (ChiptuneSynth* synth, float* left, float* right, int numSamples)
+{
+    float* outputs[] = { left, right };
+    synth->engine.render (outputs, right != nullptr ? 2 : 1, numSamples);
+}
+
+//==============================================================================
+ChiptuneSfx* chiptune_sfx_create (double sampleRate, int maxBlockSize, int numRealVoices, int maxInstances)
+{
+    if (sampleRate <= 0.0 || maxBlockSize <= 0 || numRealVoices <= 0 || maxInstances <= 0)
+        return nullptr;
+
+    auto* sfx = new (std::nothrow) ChiptuneSfx (numRealVoices, maxInstances);
+    if (sfx != nullptr)
+        sfx->runtime.prepare (sampleRate, maxBlockSize);
+    return sfx;
+}
+
+void chiptune_sfx_destroy (ChiptuneSfx* sfx)
+{
+    delete sfx;
+}
+
+int chiptune_sfx_add_sound (ChiptuneSfx* sfx)
+{
+    return sfx->runtime.addSound (ChiptuneParameters());
+}
+
+int chiptune_sfx_set_sound_param (ChiptuneSfx* sfx, int soundIndex, int parameterIndex, float value)
+{
+    if (soundIndex < 0 || soundIndex >= sfx->runtime.getNumSounds()
+        || parameterIndex < 0 || parameterIndex >= ChiptuneParameters::numParameters)
+        return 0;
+
+    sfx->runtime.getSound (soundIndex).set (static_cast<ChiptuneParameters::Index> (parameterIndex), value);
+    return 1;
+}
+
+int chiptune_sfx_play (ChiptuneSfx* sfx, int soundIndex, int midiNoteNumber, float gain, int priority, float holdSeconds)
+{
+    return sfx->runtime.play (soundIndex, midiNoteNumber, gain, priority, holdSeconds);
+}
+
+void chiptune_sfx_precache (ChiptuneSfx* sfx, int soundIndex, int midiNoteNumber, float holdSeconds)
+{
+    sfx->runtime.precache (soundIndex, midiNoteNumber, holdSeconds);
+}
+
+void chiptune_sfx_fill_cache (ChiptuneSfx* sfx)
+{
+    sfx->runtime.fillCache();
+}
+
+double chiptune_sfx_get_cache_hit_rate (ChiptuneSfx* sfx)
+{
+    return sfx->runtime.getCacheStats().getHitRate();
+}
+
+void chiptune_sfx_release (ChiptuneSfx* sfx, int handle)
+{
+    sfx->runtime.release (handle);
+}
+
+void chiptune_sfx_stop (ChiptuneSfx* sfx, int handle)
+{
+    sfx->runtime.stop (handle);
+}
+
+void chiptune_sfx_set_cpu_budget (ChiptuneSfx* sfx, double microsecondsPerBlock)
+{
+    sfx->runtime.setCpuBudget (microsecondsPerBlock);
+}
+
+void chiptune_sfx_render (ChiptuneSfx* sfx, float* left, float* right, int numSamples)
+{
+    float* outputs[] = { left, right };
+    sfx->runtime.render (outputs, right != nullptr ? 2 : 1, numSamples);
+}
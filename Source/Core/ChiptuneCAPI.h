@@ -0,0 +1,104 @@
+/*
+  ==============================================================================
+
+    ChiptuneCAPI.h
+    Created: 18 Oct 2026 2:14:26pm
+    Author:  70
+
+    Minimal C interface to ChiptuneEngine, for embedding the synthesizer in
+    game engines and other hosts that cannot use C++ or JUCE.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Opaque handle to one synthesizer instance. */
+typedef struct ChiptuneSynth ChiptuneSynth;
+
+/** Creates a synthesizer with the given number of voices (10 in the plugin). Returns NULL on failure. */
+ChiptuneSynth* chiptune_create (double sampleRate, int numVoices);
+
+/** Destroys a synthesizer created by chiptune_create. */
+void chiptune_destroy (ChiptuneSynth* synth);
+
+/** Starts a note. Velocity is in the range 0~1. */
+void chiptune_note_on (ChiptuneSynth* synth, int midiNoteNumber, float velocity);
+
+/** Releases a note, letting its envelope tail off. */
+void chiptune_note_off (ChiptuneSynth* synth, int midiNoteNumber);
+
+/** Releases every note. */
+void chiptune_all_notes_off (ChiptuneSynth* synth);
+
+/** Returns the index of a parameter ID (the plugin's IDs, e.g. "oscType"), or -1 if unknown. */
+int chiptune_find_param (const char* parameterId);
+
+/** Sets a parameter to a raw value, as stored in the plugin's presets. Returns 0 if the index is invalid. */
+int chiptune_set_param (ChiptuneSynth* synth, int parameterIndex, float value);
+
+/** Sets the seed of all random generators, making renders reproducible. */
+void chiptune_set_seed (ChiptuneSynth* synth, unsigned long long seed);
+
+/** Sets the quality tier: 0 eco, 1 standard (the default), 2 high. See RenderQuality.h for their costs. */
+void chiptune_set_quality (ChiptuneSynth* synth, int tier);
+
+/** Renders numSamples samples into left and right, overwriting them. right may be NULL for mono output. */
+void chiptune_render (ChiptuneSynth* synth, float* left, float* right, int numSamples);
+
+/*==============================================================================
+    Sound effect runtime (see SfxRuntime.h): many short sounds, few real voices.
+
+    Threads: the runtime runs on two of the game's threads. The render thread calls
+    chiptune_sfx_render and the other calls marked "render thread". The cache worker calls
+    chiptune_sfx_fill_cache, which may run at the same time as chiptune_sfx_render. The calls marked
+    "any thread" only queue a command for the next chiptune_sfx_render, and never wait for it. The
+    setup calls must not run at the same time as any other call.
+==============================================================================*/
+
+/** Opaque handle to one sound effect runtime. */
+typedef struct ChiptuneSfx ChiptuneSfx;
+
+/** Creates a runtime rendering at most numRealVoices sounds, and tracking at most maxInstances. Returns NULL on failure. Setup. */
+ChiptuneSfx* chiptune_sfx_create (double sampleRate, int maxBlockSize, int numRealVoices, int maxInstances);
+
+/** Destroys a runtime created by chiptune_sfx_create. Setup. */
+void chiptune_sfx_destroy (ChiptuneSfx* sfx);
+
+/** Registers a sound with default parameters and returns its index. Setup: do this before playing. */
+int chiptune_sfx_add_sound (ChiptuneSfx* sfx);
+
+/** Sets a parameter of a registered sound (see chiptune_find_param). Returns 0 if an index is invalid. Setup. */
+int chiptune_sfx_set_sound_param (ChiptuneSfx* sfx, int soundIndex, int parameterIndex, float value);
+
+/** Plays a sound from the next chiptune_sfx_render. Returns a handle, or -1 if an index is invalid or too many commands are queued. Any thread. */
+int chiptune_sfx_play (ChiptuneSfx* sfx, int soundIndex, int midiNoteNumber, float gain, int priority, float holdSeconds);
+
+/** Renders a sound into the cache ahead of time, so that its first play is cheap. Cache worker, or setup. */
+void chiptune_sfx_precache (ChiptuneSfx* sfx, int soundIndex, int midiNoteNumber, float holdSeconds);
+
+/** Renders the sounds that were played live because they were missing from the cache into it, e.g. once per frame. Cache worker. */
+void chiptune_sfx_fill_cache (ChiptuneSfx* sfx);
+
+/** Returns the fraction of cacheable plays served from the render cache. Any thread. */
+double chiptune_sfx_get_cache_hit_rate (ChiptuneSfx* sfx);
+
+/** Releases a playing sound early. Stale handles are ignored. A sound playing from the cache is released 50 ms later. Any thread. */
+void chiptune_sfx_release (ChiptuneSfx* sfx, int handle);
+
+/** Stops a playing sound immediately. Stale handles are ignored, as are those of sounds dropped in favour of higher priority ones. Any thread. */
+void chiptune_sfx_stop (ChiptuneSfx* sfx, int handle);
+
+/** Limits the time spent rendering voices, in microseconds per chiptune_sfx_render call. 0 removes the limit. Render thread. */
+void chiptune_sfx_set_cpu_budget (ChiptuneSfx* sfx, double microsecondsPerBlock);
+
+/** Renders the playing sounds into left and right, overwriting them. right may be NULL for mono output. Render thread. */
+void chiptune_sfx_render (ChiptuneSfx* sfx, float* left, float* right, int numSamples);
+
+#ifdef __cplusplus
+}
+#endif
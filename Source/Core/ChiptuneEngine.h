@@ -0,0 +1,643 @@
+/*
+  ==============================================================================
+
+    ChiptuneEngine.h
+    Created: 18 Oct 2026 11:36:52am
+    Author:  70
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <vector>
+#include "ChiptuneVoice.h"
+#include "ChiptuneParameters.h"
+#include "ChiptuneRandom.h"
+#include "KeyZoneMap.h"
+#include "Bitcrusher.h"
+#include "Delay.h"
+#include "FixedPointDsp.h"
+#include "NesMixer.h"
+#include "RenderQuality.h"
+#include "StateArchive.h"
+
+/**
+ * @class ChiptuneEngine
+ *
+ * @brief The complete synthesizer: voice pool, note allocation, mixer and the bitcrusher/delay effects chain.
+ *
+ * The engine has no dependency on JUCE or any other framework. Hosts set the parameters through a
+ * plain ChiptuneParameters snapshot, send note events, and call render() for each stretch of samples
+ * between events. The JUCE plugin and the C API (ChiptuneCAPI.h) are both thin wrappers around it.
+ *
+ * Voice allocation: a note that is still ringing is released before being retriggered, and a free voice
+ * is used if there is one. When the polyphony is reached (the number of voices, or RenderQuality::maxVoices
+ * if lower), a voice is stolen: the quietest released voice, going by the envelope level each voice
+ * publishes once per block, or the oldest voice if every key is still held. The stolen voice is never
+ * cut, it fades out over 5 ms, and the new note starts on one of the spare voices the pool keeps over
+ * the polyphony for that. If those are busy fading too, the note waits for the first fade to end, and
+ * render() starts it at that sample. The sustain pedal keeps released notes playing until it is lifted.
+ *
+ * The voices are summed, or with the NES mixer parameter, rendered to one bus per oscillator type and
+ * mixed by a NesMixer, a chunk of busBlockSize samples at a time. An oscillator type can also be given
+ * an aux output of its own, which its voices render into directly (see render()).
+ */
+class ChiptuneEngine
+{
+public:
+    static constexpr int maxChannels = 2; // The effects chain is stereo, extra channels are left silent.
+    static constexpr int numOscTypes = 3; // Pulse, triangle and noise, see ChiptuneVoice::getOscType()
+
+    /// Channels that the voices of one oscillator type render straight into, instead of the main outputs.
+    struct AuxOutput
+    {
+        float* const* channels = nullptr; // nullptr to play through the main outputs
+        int numChannels = 0;
+    };
+
+    /// Constructs an engine playing up to numVoices notes at once, plus the spare voices that stolen notes fade out on.
+    explicit ChiptuneEngine(int numVoices = 10)
+        : polyphony(std::max(1, numVoices))
+    {
+        voices.resize(static_cast<size_t>(polyphony + numSpareVoices)); // Created by prepare()
+        prepare(sampleRate);
+    }
+
+    /**
+     * @brief Prepares the engine for playback. Allocates the delay lines, so call it off the audio thread.
+     *
+     * Also rebuilds the voices and restarts every random generator from the seed, so that each render
+     * starts from the same state, whatever played before. A session capture relies on this, see SessionLog.
+     */
+    void prepare(double newSampleRate)
+    {
+        sampleRate = newSampleRate;
+        for (auto& voice : voices)
+        {
+            // A new voice: no oscillator phase, envelope or noise register carries over
+            voice = std::make_unique<ChiptuneVoice>(parameters, keyZones);
+            voice->setSampleRate(sampleRate);
+            voice->setRenderQuality(quality);
+        }
+        sustainPedalDown = false;
+        numPendingNotes = 0;
+
+        for (int i = 0; i < maxChannels; i++)
+        {
+            delays[i] = DelayType();
+            delays[i].setSize(static_cast<int>(sampleRate * 3));
+            delays[i].setDelayTime(static_cast<float>(sampleRate * 0.5));
+            delays[i].setFeedback(0.1f);
+            delays[i].setDryWetMix(0.2f);
+
+            bitcrushers[i] = BitcrusherType();
+            bitcrushers[i].setSampleRateReduction(1);
+            bitcrushers[i].setBitDepth(24);
+        }
+        crusherWatch.invalidate();
+        nesMixer.setSampleRate(sampleRate);
+
+        reseedVoices();
+    }
+
+    //==============================================================================
+    /// Returns the live parameters. The host may write them between render() calls.
+    ChiptuneParameters& getParameters() { return parameters; }
+
+    /// Sets one live parameter.
+    void setParameter(ChiptuneParameters::Index index, float value)
+    {
+        parameters.set(index, value);
+    }
+
+    /// Sets every live parameter from a snapshot, e.g. a program. Only copies values, so it is safe while rendering.
+    void setParameters(const ChiptuneParameters& snapshot)
+    {
+        for (int i = 0; i < ChiptuneParameters::numParameters; ++i)
+            parameters.set(static_cast<ChiptuneParameters::Index>(i), snapshot.get(static_cast<ChiptuneParameters::Index>(i)));
+    }
+
+    /// Returns the key zones. Only edit them between render() calls.
+    KeyZoneMap& getKeyZones() { return keyZones; }
+
+    /// Sets the seed every voice derives its random streams from, and restarts the streams.
+    void setRandomSeed(uint64_t newSeed)
+    {
+        randomSeed = newSeed;
+        reseedVoices();
+    }
+
+    /// Returns the seed of the random streams.
+    uint64_t getRandomSeed() const { return randomSeed; }
+
+    /**
+     * @brief Sets the quality settings of every voice. Can be called between render() calls.
+     *
+     * If the new voice limit is below the number of sounding voices, the extra voices fade out.
+     */
+    void setRenderQuality(const RenderQuality& newQuality)
+    {
+        quality = newQuality;
+        for (auto& voice : voices)
+            voice->setRenderQuality(quality);
+
+        while (getNumSoundingVoices() + numPendingNotes > getPolyphony())
+        {
+            ChiptuneVoice* victim = findVoiceToSteal();
+            if (victim == nullptr)
+                break;
+            victim->fadeOut(getFadeOutSamples());
+        }
+    }
+
+    /// Returns the quality settings.
+    const RenderQuality& getRenderQuality() const { return quality; }
+
+    //==============================================================================
+    /**
+     * @brief Appends the running state: the voices, the notes waiting for one, the effects and the live parameters.
+     *
+     * With the seed, key zones, quality and sample rate, which are set separately, it is everything the
+     * next render() depends on, so an engine prepared at the same sample rate continues from it bit for
+     * bit after loadState(). Call between render() calls. Without an output, only counts the bytes.
+     *
+     * @return the size of the state in bytes
+     */
+    size_t saveState(std::vector<uint8_t>* out)
+    {
+        StateWriter writer(out);
+        transferState(writer);
+        return writer.getSize();
+    }
+
+    /**
+     * @brief Restores a state saved by saveState(), in the same build. Call after prepare().
+     *
+     * @return false if the data does not fit this engine, which is then prepared again
+     */
+    bool loadState(const uint8_t* data, size_t size)
+    {
+        StateReader reader(data, size);
+        transferState(reader);
+        if (reader.isComplete())
+            return true;
+
+        prepare(sampleRate);
+        return false;
+    }
+
+    //==============================================================================
+    /// Starts a note, stealing a voice if none is free.
+    void noteOn(int midiNoteNumber, float velocity)
+    {
+        // If hitting a note that's still ringing, stop it first
+        for (auto& voice : voices)
+        {
+            if (voice->getCurrentNote() == midiNoteNumber && voice->isActive())
+            {
+                voice->keyDown = false;
+                voice->sustainPedalDown = false;
+                voice->stopNote(true);
+            }
+        }
+
+        removePendingNote(midiNoteNumber);
+
+        // At the polyphony, fade out the voice whose loss will be heard least. Notes waiting for a voice
+        // count as sounding, each has a voice fading out for it already.
+        if (getNumSoundingVoices() + numPendingNotes >= getPolyphony())
+            if (ChiptuneVoice* victim = findVoiceToSteal())
+                victim->fadeOut(getFadeOutSamples());
+
+        if (ChiptuneVoice* voice = findFreeVoice())
+            startVoice(*voice, { midiNoteNumber, velocity, true, false });
+        else
+            addPendingNote({ midiNoteNumber, velocity, true, false });
+    }
+
+    /// Releases a note. With the sustain pedal down, the note keeps playing until the pedal is lifted.
+    void noteOff(int midiNoteNumber, bool allowTailOff = true)
+    {
+        // A note still waiting for a voice is dropped, or kept for the pedal
+        for (int i = 0; i < numPendingNotes; ++i)
+        {
+            auto& pending = pendingNotes[i];
+            if (pending.note == midiNoteNumber && pending.keyDown)
+            {
+                pending.keyDown = false;
+                pending.sustainPedalDown = sustainPedalDown;
+            }
+        }
+        removeReleasedPendingNotes();
+
+        for (auto& voice : voices)
+        {
+            if (voice->getCurrentNote() == midiNoteNumber && voice->keyDown)
+            {
+                voice->keyDown = false;
+                if (sustainPedalDown)
+                    voice->sustainPedalDown = true;
+                else
+                    voice->stopNote(allowTailOff);
+            }
+        }
+    }
+
+    /// Releases every note.
+    void allNotesOff(bool allowTailOff = true)
+    {
+        for (auto& voice : voices)
+        {
+            voice->keyDown = false;
+            voice->sustainPedalDown = false;
+            voice->stopNote(allowTailOff);
+        }
+        sustainPedalDown = false;
+        numPendingNotes = 0;
+    }
+
+    /// Presses or lifts the sustain pedal.
+    void setSustainPedal(bool isDown)
+    {
+        sustainPedalDown = isDown;
+        if (isDown)
+            return;
+
+        for (int i = 0; i < numPendingNotes; ++i)
+            pendingNotes[i].sustainPedalDown = false;
+        removeReleasedPendingNotes();
+
+        for (auto& voice : voices)
+        {
+            if (voice->sustainPedalDown)
+            {
+                voice->sustainPedalDown = false;
+                voice->stopNote(true);
+            }
+        }
+    }
+
+    /**
+     * @brief Plays a raw MIDI message: note on and off, the sustain pedal, all notes off and all sound off.
+     *
+     * Follows juce::MidiMessage: a note on with velocity 0 is a note off, and the pedal is down from 64.
+     *
+     * @return false if the message is not one of those, e.g. a program change, which the caller handles
+     */
+    bool handleMidi(const uint8_t* data, int size)
+    {
+        if (size < 3)
+            return false;
+
+        int status = data[0] & 0xf0;
+        if (status == 0x90 && data[2] != 0)
+            noteOn(data[1], data[2] * (1.0f / 127.0f));
+        else if (status == 0x80 || status == 0x90)
+            noteOff(data[1], true);
+        else if (status == 0xb0 && (data[1] == 123 || data[1] == 120))
+            allNotesOff(true);
+        else if (status == 0xb0 && data[1] == 64)
+            setSustainPedal(data[2] >= 64);
+        else
+            return false;
+        return true;
+    }
+
+    //==============================================================================
+    /**
+     * @brief Renders the voices and the effects chain, overwriting the output buffers.
+     *
+     * @param outputs      array of channel pointers
+     * @param numChannels  number of channels, the voices are mono and written to every channel
+     * @param numSamples   number of samples to render
+     */
+    void render(float* const* outputs, int numChannels, int numSamples)
+    {
+        render(outputs, numChannels, numSamples, nullptr);
+    }
+
+    /**
+     * @brief Renders like render(), with the voices of some oscillator types on their own outputs.
+     *
+     * Each voice adds itself straight into the aux output of its oscillator type when that type has one,
+     * so there is no extra copy. Aux outputs are dry: they skip the mixer and the effects chain.
+     * They are overwritten too.
+     *
+     * @param auxOutputs   numOscTypes aux outputs indexed by oscillator type, or nullptr for none
+     */
+    void render(float* const* outputs, int numChannels, int numSamples, const AuxOutput* auxOutputs)
+    {
+        for (int chan = 0; chan < numChannels; ++chan)
+            std::fill(outputs[chan], outputs[chan] + numSamples, 0.0f);
+
+        for (int type = 0; auxOutputs != nullptr && type < numOscTypes; ++type)
+            for (int chan = 0; auxOutputs[type].channels != nullptr && chan < auxOutputs[type].numChannels; ++chan)
+                std::fill(auxOutputs[type].channels[chan], auxOutputs[type].channels[chan] + numSamples, 0.0f);
+
+        // The filters of the NES mixer start from rest when it is switched on
+        bool useNesMixer = parameters.get(ChiptuneParameters::mixer) > 0.5f;
+        if (useNesMixer && ! nesMixerOn)
+            nesMixer.reset();
+        nesMixerOn = useNesMixer;
+
+        // Notes waiting for a voice start as soon as a fade frees one, so the block is split there
+        for (int start = 0; start < numSamples;)
+        {
+            int segmentSize = numSamples - start;
+            if (numPendingNotes > 0)
+                segmentSize = std::min(segmentSize, getSamplesUntilFadeEnds());
+
+            if (nesMixerOn)
+            {
+                renderThroughNesMixer(outputs, std::min(numChannels, maxChannels), start, segmentSize, auxOutputs);
+            }
+            else
+            {
+                for (auto& voice : voices)
+                {
+                    if (const AuxOutput* aux = findAuxOutput(*voice, auxOutputs))
+                        voice->renderNextBlock(aux->channels, aux->numChannels, start, segmentSize);
+                    else
+                        voice->renderNextBlock(outputs, numChannels, start, segmentSize);
+                }
+            }
+            start += segmentSize;
+            startPendingNotes();
+        }
+
+        processEffects(outputs, std::min(numChannels, maxChannels), numSamples);
+    }
+
+    /// Returns the number of voices, spare voices included.
+    int getNumVoices() const { return static_cast<int>(voices.size()); }
+
+    /// Returns the number of notes that can sound at once: the voices the engine was built with, or RenderQuality::maxVoices if lower.
+    int getPolyphony() const { return quality.maxVoices > 0 ? std::min(quality.maxVoices, polyphony) : polyphony; }
+
+    /// Returns a voice, e.g. to display its state.
+    const ChiptuneVoice& getVoice(int index) const { return *voices[index]; }
+
+    /// Returns the number of voices playing that are not fading out.
+    int getNumSoundingVoices() const
+    {
+        return static_cast<int>(std::count_if(voices.begin(), voices.end(), [](const auto& voice)
+                                              { return voice->isActive() && ! voice->isFadingOut(); }));
+    }
+
+private:
+   #if CHIPTUNE_FIXED_POINT
+    using DelayType = FixedDelay;
+    using BitcrusherType = FixedBitcrusher;
+   #else
+    using DelayType = Delay;
+    using BitcrusherType = Bitcrusher;
+   #endif
+
+    static constexpr int numSpareVoices = 2;   // Voices over the polyphony, for new notes while stolen ones fade out
+    static constexpr int maxPendingNotes = 16;
+
+    /// A note waiting for a fade to free a voice.
+    struct PendingNote
+    {
+        int note;
+        float velocity;
+        bool keyDown;
+        bool sustainPedalDown;
+    };
+
+    ChiptuneParameters parameters;    // Live parameters, shared by the voices
+    KeyZoneMap keyZones;              // Per-key parameter snapshots
+    std::vector<std::unique_ptr<ChiptuneVoice>> voices;
+    DelayType delays[maxChannels];
+    BitcrusherType bitcrushers[maxChannels];
+
+    double sampleRate = 44100.0;
+    uint64_t randomSeed = 0x43686970;
+    uint64_t lastNoteOnCounter = 0;   // Incremented at every note-on, to find the oldest voice
+    int polyphony = 10;
+    PendingNote pendingNotes[maxPendingNotes]; // Oldest first
+    int numPendingNotes = 0;
+    bool sustainPedalDown = false;
+    RenderQuality quality;
+    ParameterWatch<2> crusherWatch { ChiptuneParameters::rateReduction, ChiptuneParameters::bitDepth };
+
+    static constexpr int busBlockSize = 256;
+    NesMixer nesMixer;
+    bool nesMixerOn = false;
+    float busBuffers[NesMixer::numBuses][maxChannels][busBlockSize]; // Voices by oscillator type, for the NES mixer
+
+    /// Lengthof the fade of a voice over the limit: 5 ms, short but click-free.
+    int getFadeOutSamples() const { return static_cast<int>(sampleRate * 0.005); }
+
+    /// Saves or restores the running state, see saveState(). Starts with the layout, so that another build does not match.
+    template <typename Archive>
+    void transferState(Archive& archive)
+    {
+        uint32_t layout[] = { static_cast<uint32_t>(voices.size()), static_cast<uint32_t>(sizeof(ChiptuneVoice)),
+                              static_cast<uint32_t>(CHIPTUNE_FIXED_POINT) };
+        uint32_t savedLayout[] = { layout[0], layout[1], layout[2] };
+        archive(savedLayout);
+        if (! std::equal(layout, layout + 3, savedLayout))
+            return;
+
+        for (auto& voice : voices)
+            archive(*voice);
+        archive(pendingNotes, numPendingNotes, lastNoteOnCounter, sustainPedalDown);
+        archive(delays, bitcrushers, crusherWatch, nesMixer, nesMixerOn, parameters);
+    }
+
+    /// Starts a note on a free voice.
+    void startVoice(ChiptuneVoice& voice, const PendingNote& note)
+    {
+        voice.startNote(note.note, note.velocity);
+        voice.keyDown = note.keyDown;
+        voice.sustainPedalDown = note.sustainPedalDown;
+        voice.noteOnTime = ++lastNoteOnCounter;
+    }
+
+    /// Queues a note until a voice is free, dropping the oldest waiting note if the queue is full.
+    void addPendingNote(const PendingNote& note)
+    {
+        if (numPendingNotes == maxPendingNotes)
+        {
+            std::copy(pendingNotes + 1, pendingNotes + numPendingNotes, pendingNotes);
+            --numPendingNotes;
+        }
+        pendingNotes[numPendingNotes++] = note;
+    }
+
+    /// Drops the waiting notes of a key, e.g. when it is played again.
+    void removePendingNote(int midiNoteNumber)
+    {
+        auto end = std::remove_if(pendingNotes, pendingNotes + numPendingNotes,
+                                  [=](const PendingNote& pending) { return pending.note == midiNoteNumber; });
+        numPendingNotes = static_cast<int>(end - pendingNotes);
+    }
+
+    /// Drops the waiting notes that neither a key nor the pedal holds any more.
+    void removeReleasedPendingNotes()
+    {
+        auto end = std::remove_if(pendingNotes, pendingNotes + numPendingNotes,
+                                  [](const PendingNote& pending) { return ! pending.keyDown && ! pending.sustainPedalDown; });
+        numPendingNotes = static_cast<int>(end - pendingNotes);
+    }
+
+    /// Starts the waiting notes on the voices that are free.
+    void startPendingNotes()
+    {
+        int numStarted = 0;
+        while (numStarted < numPendingNotes)
+        {
+            ChiptuneVoice* voice = findFreeVoice();
+            if (voice == nullptr)
+                break;
+            startVoice(*voice, pendingNotes[numStarted++]);
+        }
+        std::copy(pendingNotes + numStarted, pendingNotes + numPendingNotes, pendingNotes);
+        numPendingNotes -= numStarted;
+    }
+
+    /// Returns the number of samples until the first fading voice is free, at least 1.
+    int getSamplesUntilFadeEnds() const
+    {
+        int samples = std::numeric_limits<int>::max();
+        for (auto& voice : voices)
+            if (voice->isActive() && voice->isFadingOut())
+                samples = std::min(samples, voice->getFadeRemaining());
+        return std::max(1, samples);
+    }
+
+    /// Restarts the random generators of every voice from the engine seed.
+    void reseedVoices()
+    {
+        for (int i = 0; i < getNumVoices(); ++i)
+            voices[i]->setRandomSeed(ChiptuneRandom::deriveSeed(randomSeed, static_cast<uint64_t>(i)));
+    }
+
+    /// Returns a voice that is not playing, or nullptr if all are busy.
+    ChiptuneVoice* findFreeVoice() const
+    {
+        for (auto& voice : voices)
+        {
+            if (! voice->isActive())
+                return voice.get();
+        }
+        return nullptr;
+    }
+
+    /// Returns the quietest voice whose key and pedal are up and which is not fading out, or nullptr.
+    ChiptuneVoice* findQuietestReleasedVoice() const
+    {
+        ChiptuneVoice* quietest = nullptr;
+        for (auto& voice : voices)
+        {
+            if (voice->isActive() && ! voice->isFadingOut() && ! voice->keyDown && ! voice->sustainPedalDown
+                && (quietest == nullptr || voice->getLevel() < quietest->getLevel()))
+                quietest = voice.get();
+        }
+        return quietest;
+    }
+
+    /**
+     * @brief Returns the voice whose loss will be heard least.
+     *
+     * The quietest released voice comes first, then the oldest voice. Free voices and voices already
+     * fading out are skipped; returns nullptr if that leaves none.
+     */
+    ChiptuneVoice* findVoiceToSteal() const
+    {
+        if (ChiptuneVoice* released = findQuietestReleasedVoice())
+            return released;
+
+        ChiptuneVoice* oldest = nullptr;
+        for (auto& voice : voices)
+        {
+            if (! voice->isActive() || voice->isFadingOut())
+                continue;
+
+            if (oldest == nullptr || voice->noteOnTime < oldest->noteOnTime)
+                oldest = voice.get();
+        }
+        return oldest;
+    }
+
+    /// Returns the aux output the voice renders to, or nullptr if it plays through the main outputs.
+    static const AuxOutput* findAuxOutput(const ChiptuneVoice& voice, const AuxOutput* auxOutputs)
+    {
+        int type = voice.getOscType();
+        if (auxOutputs == nullptr || type < 0 || type >= numOscTypes || auxOutputs[type].channels == nullptr)
+            return nullptr;
+        return &auxOutputs[type];
+    }
+
+    /// Renders each voice to the bus of its oscillator type, and mixes the buses into the outputs.
+    void renderThroughNesMixer(float* const* outputs, int numChannels, int startSample, int numSamples, const AuxOutput* auxOutputs)
+    {
+        float* busChannels[NesMixer::numBuses][maxChannels];
+        float* const* buses[NesMixer::numBuses];
+        for (int bus = 0; bus < NesMixer::numBuses; ++bus)
+        {
+            for (int chan = 0; chan < maxChannels; ++chan)
+                busChannels[bus][chan] = busBuffers[bus][chan];
+            buses[bus] = busChannels[bus];
+        }
+
+        for (int start = startSample; start < startSample + numSamples; start += busBlockSize)
+        {
+            int chunkSize = std::min(busBlockSize, startSample + numSamples - start);
+            for (auto& bus : busBuffers)
+                for (int chan = 0; chan < numChannels; ++chan)
+                    std::fill(bus[chan], bus[chan] + chunkSize, 0.0f);
+
+            for (auto& voice : voices)
+            {
+                if (const AuxOutput* aux = findAuxOutput(*voice, auxOutputs))
+                    voice->renderNextBlock(aux->channels, aux->numChannels, start, chunkSize);
+                else
+                    voice->renderNextBlock(busChannels[std::clamp(voice->getOscType(), 0, NesMixer::numBuses - 1)],
+                                           numChannels, 0, chunkSize);
+            }
+
+            float* chunk[maxChannels];
+            for (int chan = 0; chan < numChannels; ++chan)
+                chunk[chan] = outputs[chan] + start;
+            nesMixer.process(buses, chunk, numChannels, chunkSize);
+        }
+    }
+
+    /// Applies the bitcrusher followed by the delay to each channel.
+    void processEffects(float* const* outputs, int numChannels, int numSamples)
+    {
+        // The bitcrusher settings cost a std::pow, so they are only applied when they change
+        if (crusherWatch.changed(parameters))
+        {
+            for (auto& bitcrusher : bitcrushers)
+            {
+                bitcrusher.setSampleRateReduction(static_cast<int>(parameters.get(ChiptuneParameters::rateReduction)));
+                bitcrusher.setBitDepth(static_cast<int>(parameters.get(ChiptuneParameters::bitDepth)));
+            }
+        }
+
+        for (int chan = 0; chan < numChannels; ++chan)
+        {
+            delays[chan].setDelayTime(static_cast<float>(sampleRate * parameters.get(ChiptuneParameters::delayTime)));
+            delays[chan].setFeedback(parameters.get(ChiptuneParameters::feedback));
+            delays[chan].setDryWetMix(parameters.get(ChiptuneParameters::dryWetMix));
+            delays[chan].setInterpolationOrder(quality.delayInterpolation);
+
+            float* samples = outputs[chan];
+            for (int i = 0; i < numSamples; ++i)
+            {
+               #if CHIPTUNE_FIXED_POINT
+                int32_t processed = bitcrushers[chan].process(FixedPoint::floatToQ15(samples[i]));
+                samples[i] = FixedPoint::q15ToFloat(delays[chan].process(processed));
+               #else
+                samples[i] = delays[chan].process(bitcrushers[chan].process(samples[i]));
+               #endif
+            }
+        }
+    }
+};
@@ -0,0 +1,245 @@
+/*
+  ==============================================================================
+
+    ChiptuneParameters.h
+    Created: 17 Oct 2026 10:02:11am
+    Author:  70
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+
+/**
+ * @class ChiptuneParameters
+ *
+ * @brief A flat snapshot of every plugin parameter value.
+ *
+ * The snapshot mirrors the parameter layout of the plugin (same IDs, same raw values as stored by
+ * the `AudioProcessorValueTreeState`), but holds plain floats so that it can be copied freely, read on
+ * the audio thread without any string lookup, and used without JUCE (see ChiptuneEngine). Voices and modulation modules read their
+ * settings from a snapshot rather than from the value tree, which lets a single instance play
+ * different sounds on different keys (see KeyZoneMap).
+ *
+ * Each parameter also has a version, bumped whenever set() changes its value. Modules compare versions
+ * once per block (see ParameterWatch) and only recompute what they derive from a parameter when it moved.
+ */
+class ChiptuneParameters
+{
+public:
+    /// Index of each parameter inside the snapshot. The order follows the plugin's parameter layout, less the
+    /// plugin-only `quality` parameter, which is read by the processor and is not part of a snapshot.
+    enum Index
+    {
+        oscType = 0,
+        pulseWidth,
+        pwmSwitch,
+        pwmSustain,
+        pwmMode,
+        pwmRate,
+        pwmShape,
+        triDistortion,
+        noiseDistortion,
+        unison,
+        unisonDetune,
+        unisonSpread,
+        pbSwitch,
+        pbInitPitch,
+        pbTime,
+        pbEndPitch,
+        pbEndTime,
+        vibSwitch,
+        vibSpeed,
+        vibAmount,
+        vibSustain,
+        arpSwitch,
+        arpPattern,
+        arpOctave,
+        arpSpeed,
+        attack,
+        decay,
+        sustain,
+        release,
+        envCurve,
+        mixer,
+        rateReduction,
+        bitDepth,
+        delayTime,
+        feedback,
+        dryWetMix,
+        numParameters
+    };
+
+    /// Constructs a snapshot holding the default value of every parameter.
+    ChiptuneParameters()
+    {
+        setToDefaults();
+    }
+
+    /// Returns the raw value of a parameter.
+    float get(Index index) const
+    {
+        return values[index];
+    }
+
+    /// Sets the raw value of a parameter, bumping its version if the value changes.
+    void set(Index index, float value)
+    {
+        if (values[index] != value)
+        {
+            values[index] = value;
+            ++versions[index];
+        }
+    }
+
+    /// Returns a number that changes every time the value of the parameter changes.
+    uint32_t getVersion(Index index) const
+    {
+        return versions[index];
+    }
+
+    /// Returns true if a switch/boolean parameter is on.
+    bool isOn(Index index) const
+    {
+        return values[index] > 0.5f;
+    }
+
+    /// Resets every parameter to the default used by the plugin's parameter layout.
+    void setToDefaults()
+    {
+        for (int i = 0; i < numParameters; ++i)
+            set(static_cast<Index>(i), getInfo(i).defaultValue);
+    }
+
+    /// Sets a parameter by its ID. Unknown IDs are ignored.
+    void set(const char* parameterId, float value)
+    {
+        int index = indexOf(parameterId);
+        if (index >= 0)
+            set(static_cast<Index>(index), value);
+    }
+
+    /// Returns the parameter ID at the given index.
+    static const char* getId(int index)
+    {
+        return getInfo(index).id;
+    }
+
+    /// Returns the index of a parameter ID, or -1 if it is not part of the layout.
+    static int indexOf(const char* parameterId)
+    {
+        for (int i = 0; i < numParameters; ++i)
+        {
+            if (std::strcmp(parameterId, getInfo(i).id) == 0)
+                return i;
+        }
+        return -1;
+    }
+
+private:
+    std::array<float, numParameters> values {};     // Raw parameter values, indexed by Index.
+    std::array<uint32_t, numParameters> versions {}; // Bumped by set() when a value changes.
+
+    struct Info
+    {
+        const char* id;     // Parameter ID used by the value tree state.
+        float defaultValue; // Default raw value, as declared in the parameter layout.
+    };
+
+    /// Table of parameter IDs and defaults, kept in the same order as Index.
+    static const Info& getInfo(int index)
+    {
+        static const Info infos[numParameters] =
+        {
+            { "oscType", 0.0f },
+            { "pulseWidth", 0.0f },
+            { "pwmSwitch", 0.0f },
+            { "pwmSustain", 0.0f },
+            { "pwmMode", 0.0f },
+            { "pwmRate", 0.5f },
+            { "pwmShape", 0.0f },
+            { "triDistortion", 1.0f },
+            { "noiseDistortion", 1.0f },
+            { "unison", 1.0f },
+            { "unisonDetune", 15.0f },
+            { "unisonSpread", 0.5f },
+            { "pbSwitch", 0.0f },
+            { "pbInitPitch", 0.0f },
+            { "pbTime", 0.01f },
+            { "pbEndPitch", 0.0f },
+            { "pbEndTime", 0.1f },
+            { "vibSwitch", 0.0f },
+            { "vibSpeed", 0.1f },
+            { "vibAmount", 0.1f },
+            { "vibSustain", 0.0f },
+            { "arpSwitch", 0.0f },
+            { "arpPattern", 0.0f },
+            { "arpOctave", 0.0f },
+            { "arpSpeed", 0.5f },
+            { "attack", 0.01f },
+            { "decay", 0.0f },
+            { "sustain", 1.0f },
+            { "release", 0.01f },
+            { "envCurve", 0.0f },
+            { "mixer", 0.0f },
+            { "rateReduction", 1.0f },
+            { "bitDepth", 24.0f },
+            { "delayTime", 0.0f },
+            { "feedback", 0.0f },
+            { "dryWetMix", 0.2f }
+        };
+        return infos[index];
+    }
+};
+
+//==============================================================================
+/**
+ * @class ParameterWatch
+ *
+ * @brief Tells a module whether any of the parameters it depends on changed since it last asked.
+ *
+ * Remembers the version of each watched parameter. A check is one integer compare per parameter, so a
+ * module can check once per block and skip recomputing its derived values when nothing moved.
+ *
+ * Versions are only comparable within one snapshot and its copies. A module whose snapshot is replaced
+ * by an unrelated one (a voice switching to a key zone, for instance) must call invalidate().
+ */
+template <int numWatched>
+class ParameterWatch
+{
+public:
+    ParameterWatch(std::initializer_list<ChiptuneParameters::Index> watchedIndices)
+    {
+        std::copy(watchedIndices.begin(), watchedIndices.end(), indices.begin());
+    }
+
+    /// Returns true if a watched parameter changed since the last call, or after invalidate().
+    bool changed(const ChiptuneParameters& params)
+    {
+        bool anyChanged = invalid;
+        invalid = false;
+        for (int i = 0; i < numWatched; ++i)
+        {
+            uint32_t version = params.getVersion(indices[i]);
+            if (version != seen[i])
+            {
+                seen[i] = version;
+                anyChanged = true;
+            }
+        }
+        return anyChanged;
+    }
+
+    /// Makes the next changed() call return true.
+    void invalidate() { invalid = true; }
+
+private:
+    std::array<ChiptuneParameters::Index, numWatched> indices {};
+    std::array<uint32_t, numWatched> seen {};
+    bool invalid = true; // The derived values have never been computed
+};
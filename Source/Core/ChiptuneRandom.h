@@ -0,0 +1,159 @@
+/*
+  ==============================================================================
+
+    ChiptuneRandom.h
+    Created: 17 Oct 2026 1:18:52pm
+    Author:  70
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <cstdint>
+#include <cstring>
+
+/**
+ * @class ChiptuneRandom
+ *
+ * @brief Seedable, deterministic random number generator for all noise and random paths.
+ *
+ * The generator runs 8 independent xoshiro128+ streams side by side, stored as one array per state
+ * word. Each step advances all 8 lanes with the same plain integer operations, which the compiler
+ * vectorizes: two passes of 4-wide instructions with the default SSE2 or NEON targets (one 8-wide pass
+ * only if the build enables AVX2), producing 8 floats at a time. Single values are served from that
+ * batch, and fillBlock() writes whole buffers, which is what the white noise of a voice uses.
+ *
+ * Unlike juce::Random or std::rand, the output depends only on the seed, so renders are reproducible.
+ * Use deriveSeed() to give each voice and each feature its own independent stream from one instance seed.
+ */
+class ChiptuneRandom
+{
+public:
+    static constexpr int numLanes = 8; // Number of values produced per step.
+
+    /// Constructs a generator with the given seed.
+    explicit ChiptuneRandom(uint64_t seed = 0)
+    {
+        setSeed(seed);
+    }
+
+    /// Restarts the generator from a seed. The same seed always produces the same sequence.
+    void setSeed(uint64_t seed)
+    {
+        uint64_t mix = seed;
+        for (int lane = 0; lane < numLanes; ++lane)
+        {
+            // Expand the seed with splitmix64, as recommended for seeding xoshiro generators
+            uint64_t a = splitMix64(mix);
+            uint64_t b = splitMix64(mix);
+            s0[lane] = static_cast<uint32_t>(a);
+            s1[lane] = static_cast<uint32_t>(a >> 32);
+            s2[lane] = static_cast<uint32_t>(b);
+            s3[lane] = static_cast<uint32_t>(b >> 32);
+        }
+        batchIndex = numLanes; // Force a new batch on the next call
+    }
+
+    /**
+     * @brief Derives the seed of an independent stream from a parent seed.
+     *
+     * @param parentSeed Seed of the plugin instance (or of the voice).
+     * @param streamId   Number identifying the stream, e.g. the voice index or a feature.
+     */
+    static uint64_t deriveSeed(uint64_t parentSeed, uint64_t streamId)
+    {
+        uint64_t mix = parentSeed ^ (streamId * 0xd1b54a32d192ed03ull);
+        return splitMix64(mix);
+    }
+
+    /// Returns the next float in the range [0, 1).
+    float nextFloat()
+    {
+        if (batchIndex >= numLanes)
+        {
+            step(batch);
+            batchIndex = 0;
+        }
+        return batch[batchIndex++];
+    }
+
+    /// Returns the next integer in the range [0, maxValue).
+    int nextInt(int maxValue)
+    {
+        int value = static_cast<int>(nextFloat() * static_cast<float>(maxValue));
+        return value < maxValue ? value : maxValue - 1;
+    }
+
+    /// Returns the next integer in the range [minValue, maxValue] (both inclusive).
+    int nextInt(int minValue, int maxValue)
+    {
+        return minValue + nextInt(maxValue - minValue + 1);
+    }
+
+    /**
+     * @brief Fills a buffer with uniformly distributed floats in [low, high).
+     *
+     * The rest of a partially used batch comes first, then whole batches of 8 are written straight into
+     * the destination, so the sequence is the same as calling nextFloat() repeatedly.
+     */
+    void fillBlock(float* dest, int numSamples, float low = 0.0f, float high = 1.0f)
+    {
+        const float range = high - low;
+
+        int i = 0;
+        for (; i < numSamples && batchIndex < numLanes; ++i)
+            dest[i] = batch[batchIndex++] * range + low;
+
+        for (; i + numLanes <= numSamples; i += numLanes)
+        {
+            step(dest + i);
+            for (int lane = 0; lane < numLanes; ++lane)
+                dest[i + lane] = dest[i + lane] * range + low;
+        }
+
+        for (; i < numSamples; ++i)
+            dest[i] = nextFloat() * range + low;
+    }
+
+private:
+    alignas(32) uint32_t s0[numLanes]; // xoshiro128+ state, one word per array, one lane per element.
+    alignas(32) uint32_t s1[numLanes];
+    alignas(32) uint32_t s2[numLanes];
+    alignas(32) uint32_t s3[numLanes];
+    alignas(32) float batch[numLanes]; // Last batch of values served by nextFloat().
+    int batchIndex = numLanes;         // Next unused value in the batch.
+
+    /// Advances all lanes once and writes one float per lane in [0, 1).
+    void step(float* out)
+    {
+        uint32_t bits[numLanes];
+        for (int lane = 0; lane < numLanes; ++lane)
+        {
+            uint32_t result = s0[lane] + s3[lane];
+            uint32_t t = s1[lane] << 9;
+
+            s2[lane] ^= s0[lane];
+            s3[lane] ^= s1[lane];
+            s1[lane] ^= s2[lane];
+            s0[lane] ^= s3[lane];
+            s2[lane] ^= t;
+            s3[lane] = (s3[lane] << 11) | (s3[lane] >> 21);
+
+            // Use the top 23 bits as the mantissa of a float in [1, 2)
+            bits[lane] = (result >> 9) | 0x3f800000u;
+        }
+
+        std::memcpy(out, bits, sizeof(bits));
+        for (int lane = 0; lane < numLanes; ++lane)
+            out[lane] -= 1.0f;
+    }
+
+    /// splitmix64 step, used to expand seeds.
+    static uint64_t splitMix64(uint64_t& state)
+    {
+        uint64_t z = (state += 0x9e3779b97f4a7c15ull);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        return z ^ (z >> 31);
+    }
+};
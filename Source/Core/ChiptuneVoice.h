@@ -0,0 +1,1137 @@
+/*
+  ==============================================================================
+
+    ChiptuneVoice.h
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include "Bitcrusher.h"
+#include "PulseWidthModulation.h"
+#include "Arpeggiator.h"
+#include "PitchBend.h"
+#include "PolyBLEPOscillator.h"
+#include "Vibrato.h"
+#include "Noise.h"
+#include "ChiptuneParameters.h"
+#include "KeyZoneMap.h"
+#include "ChiptuneRandom.h"
+#include "FixedPoint.h"
+#include "FixedPointOscillator.h"
+#include "FixedPointDsp.h"
+#include "Envelope.h"
+#include "Pitch.h"
+#include "RenderQuality.h"
+#include "Decimator.h"
+#include "UnisonOscillator.h"
+
+/**
+ * @class ChiptuneVoice
+ *
+ * @brief Implements a synthesizer voice for generating chiptune-style sounds.
+ *
+ * This class provides functionalities specific to chiptune audio synthesis, without depending on any
+ * plugin framework. It integrates various modulation and synthesis techniques, including arpeggiation,
+ * pitch bending, vibrato, and pulse width modulation (PWM). Each instance of this class is capable of
+ * handling a single voice in a synthesizer setup; ChiptuneEngine owns the voices and routes note on/off
+ * events to them.
+ *
+ * The construction of the ChiptuneVoice relies on passing the engine's live ChiptuneParameters
+ * snapshot, which the host refreshes once per block for real-time control and automation, and a
+ * KeyZoneMap. At note-on the voice looks up the zone of the note: if the note belongs to a zone, the
+ * voice plays that zone's parameter snapshot, otherwise it follows the live parameters.
+ *
+ * Key features:
+ * - Arpeggiator: Modulates the pitch of the note in a rhythmic pattern.
+ * - Pitch Bend: Allows dynamic changing of the note pitch during playback.
+ * - Vibrato: Adds a periodic modulation to the pitch for a vibrating effect.
+ * - Pulse Width Modulation: Offers control over the timbre of the note by adjusting the pulse width.
+ *
+ * The cost of a voice can be lowered with setRenderQuality(): naive pulse edges, and modulators that
+ * only run every few samples.
+ *
+ * When CHIPTUNE_FIXED_POINT is set to 1, the oscillators, the envelope and the output stage run in Q15/Q31
+ * integer arithmetic (see FixedPoint.h), and only the final sample is converted to float for the host.
+ */
+class ChiptuneVoice
+{
+public:
+    /// Constructs a ChiptuneVoice with necessary bindings to the live parameters and the key zones.
+    ChiptuneVoice(const ChiptuneParameters& liveParams, const KeyZoneMap& keyZones) : pulseWidthModulation(params), arpeggiator(params), pitchBend(params), vibrato(params), liveParams(liveParams), keyZones(keyZones)
+    {
+        periodCache.resize(maxPeriodCacheLength);
+    }
+    //--------------------------------------------------------------------------
+    /// Sets the sample rate used by the oscillators, modulators and envelope for the following notes.
+    void setSampleRate(double newSampleRate)
+    {
+        sampleRate = newSampleRate;
+    }
+    
+    /// Sets the quality settings. The pulse edges switch at once, the control rate at the next note.
+    void setRenderQuality(const RenderQuality& newQuality)
+    {
+        quality = newQuality;
+        squareOsc.setBandLimited(quality.bandLimited);
+        unison.setBandLimited(quality.bandLimited);
+       #if CHIPTUNE_FIXED_POINT
+        fixedSquareOsc.setBandLimited(quality.bandLimited);
+       #endif
+    }
+    
+    //--------------------------------------------------------------------------
+    /**
+     * @brief Begins playing a note with a given MIDI note number and velocity.
+     *
+     * This function is called when a MIDI noteOn message is received. It sets up the oscillators,
+     * pulse width modulation, pitch bending, arpeggiator, vibrato, and envelope generator according to
+     * the received note and velocity.
+     *
+     * @param midiNoteNumber The MIDI note number that corresponds to the pitch of the note.
+     * @param velocity The velocity at which the note is being played, currently unused.
+     */
+    void startNote (int midiNoteNumber, float velocity)
+    {
+        // Resolve the key zone of this note, falling back to the live parameters if the note is unmapped.
+        const ChiptuneParameters* zoneParams = keyZones.getParametersForNote(midiNoteNumber);
+        if (zoneParams != nullptr)
+        {
+            startNote(midiNoteNumber, velocity, *zoneParams);
+        }
+        else
+        {
+            usesSnapshot = false;
+            params = liveParams;
+            beginNote(midiNoteNumber);
+        }
+    }
+    
+    /// Begins playing a note with a fixed parameter snapshot, ignoring the live parameters and the key zones.
+    void startNote (int midiNoteNumber, float /*velocity*/, const ChiptuneParameters& snapshot)
+    {
+        usesSnapshot = true;
+        params = snapshot;
+        beginNote(midiNoteNumber);
+    }
+    
+    //--------------------------------------------------------------------------
+    /**
+     * @brief Runs the modulators and the envelope for a number of samples without producing any output.
+     *
+     * Used to bring a note that was only tracked logically up to its current position before it starts
+     * sounding: the arpeggiator step, pitch bend, vibrato, pulse width and envelope end up where they
+     * would be had the note been rendered all along, at a fraction of the cost. Only the oscillator phase
+     * is not advanced.
+     *
+     * @param numSamples number of samples to skip
+     */
+    void advance(int numSamples)
+    {
+        if (! playing)
+            return;
+        
+        if (! usesSnapshot)
+            params = liveParams;
+        updateModulatorParameters();
+        
+        for (int i = 0; i < numSamples; ++i)
+        {
+            if (nextControlTick())
+            {
+                updatePitchModulation();
+                if (currentOscType == 0 && updatePwmSwitch())
+                    pulseWidth = pulseWidthModulation.process();
+            }
+            
+           #if CHIPTUNE_FIXED_POINT
+            fixedEnv.getNextSample();
+            bool envActive = fixedEnv.isActive();
+           #else
+            env.getNextSample();
+            bool envActive = env.isActive();
+           #endif
+            if (! envActive)
+            {
+                clearCurrentNote();
+                return;
+            }
+        }
+        squareOsc.setPulseWidth(pulseWidth);
+       #if CHIPTUNE_FIXED_POINT
+        fixedSquareOsc.setPulseWidth(pulseWidth);
+       #endif
+    }
+    
+    //--------------------------------------------------------------------------
+    /**
+     * @brief Called when a MIDI noteOff message is received.
+     *
+     * This method handles the actions required when a note should stop playing. It triggers the
+     * release phase of the envelope, allowing for a natural decay of the sound if `allowTailOff` is true.
+     *
+     * @param allowTailOff A boolean that determines whether the note should be allowed to decay naturally (true) or stop immediately (false).
+     */
+    void stopNote(bool allowTailOff)
+    {
+        if (! allowTailOff)
+        {
+            env.reset();
+           #if CHIPTUNE_FIXED_POINT
+            fixedEnv.reset();
+           #endif
+            clearCurrentNote();
+            return;
+        }
+        
+        env.noteOff();
+       #if CHIPTUNE_FIXED_POINT
+        fixedEnv.noteOff();
+       #endif
+        
+        // Bend out to the end pitch while the note releases
+        if (updatePbSwitch())
+            pitchBend.releasePitchBend();
+    }
+    
+    /**
+     * @brief Fades the note out linearly and frees the voice, whatever its envelope is doing.
+     *
+     * Used to silence a voice quickly without the click of a hard stop, e.g. when voices are capped.
+     *
+     * @param numSamples length of the fade
+     */
+    void fadeOut(int numSamples)
+    {
+        if (! playing || fadeRemaining > 0)
+            return;
+        
+        fadeRemaining = std::max(1, numSamples);
+        fadeGain = 1.0f;
+        fadeStep = 1.0f / static_cast<float>(fadeRemaining);
+    }
+    
+    /// Returns true while the voice is fading out, see fadeOut().
+    bool isFadingOut() const { return fadeRemaining > 0; }
+
+    /// Returns the samples left in a fadeOut(), after which the voice is free; 0 when not fading.
+    int getFadeRemaining() const { return fadeRemaining; }
+    
+    /// Returns the envelope level at the end of the last rendered block, including any fade, 0 when free.
+    float getLevel() const { return level; }
+    
+    //--------------------------------------------------------------------------
+    /**
+     * @brief Renders the next block of samples for playback.
+     *
+     * This method processes and generates audio samples for the duration specified by numSamples. It calculates
+     * each sample based on the current state of the synthesizer voice, including modulations from the arpeggiator,
+     * pitch bend, and vibrato effects. It applies waveform generation and processes effects like pulse width modulation
+     * and distortion, before applying the envelope to the final output. Each channel of the output buffer is filled
+     * with the generated audio samples.
+     *
+     * @param outputs array of channel pointers, the voice adds its output to every channel
+     * @param numChannels number of channels in outputs
+     * @param startSample position of first sample in buffer
+     * @param numSamples number of smaples in output buffer
+     */
+    void renderNextBlock(float* const* outputs, int numChannels, int startSample, int numSamples)
+    {
+        if (playing) // check to see if this voice should be playing
+        {
+            // Follow parameter changes from the host, unless this note plays a fixed snapshot
+            if (! usesSnapshot)
+                params = liveParams;
+            updateModulatorParameters();
+
+           #if ! CHIPTUNE_FIXED_POINT
+            if (unisonSize > 1)
+                updateUnisonSpread();
+            
+            // Unmodulated notes become periodic once the envelope holds, see renderSteadyState()
+            bool steadyCandidate = isSteadyStateCandidate();
+            bool sweepCandidate = isPulseSweepCandidate();
+            if (periodCacheValid && ! (steadyCandidate && env.isSustaining() && periodCacheMatches() && fadeRemaining == 0))
+                leaveSteadyState();
+           #endif
+            
+            // iterate through the necessary number of samples (from startSample up to startSample + numSamples), a chunk at a time
+            for (int sampleIndex = startSample; sampleIndex < (startSample+numSamples); sampleIndex += envelopeChunkSize)
+            {
+                int remaining = startSample + numSamples - sampleIndex;
+               #if ! CHIPTUNE_FIXED_POINT
+                if (steadyCandidate && env.isSustaining() && fadeRemaining == 0 && (periodCacheValid || tryBuildPeriodCache()))
+                {
+                    renderSteadyState(outputs, numChannels, sampleIndex, remaining);
+                    break;
+                }
+                if (sweepCandidate && env.isSustaining() && fadeRemaining == 0)
+                {
+                    renderPulseSweep(outputs, numChannels, sampleIndex, remaining);
+                    break;
+                }
+               #endif
+                
+                // The chunk never goes past the end of this block, nor past the end of the note
+                int chunk = std::min(envelopeChunkSize, remaining);
+                bool noteEnds = false;
+                int numVoiced = renderChunk(chunk, noteEnds);
+                if (fadeRemaining > 0)
+                {
+                    if (fadeRemaining <= numVoiced)
+                    {
+                        numVoiced = fadeRemaining;
+                        noteEnds = true;
+                    }
+                    applyFade(numVoiced);
+                }
+                
+               #if ! CHIPTUNE_FIXED_POINT
+                if (unisonSize > 1)
+                {
+                    for (int i = 0; i < numVoiced; ++i)
+                        writeStereoSample(outputs, numChannels, sampleIndex + i, voiceBuffer[i], voiceRightBuffer[i]);
+                }
+                else
+               #endif
+                {
+                    // for each channel, add the voice output of the chunk
+                    for (int chan = 0; chan < numChannels; ++chan)
+                    {
+                        float* dest = outputs[chan] + sampleIndex;
+                        for (int i = 0; i < numVoiced; ++i)
+                            dest[i] += voiceBuffer[i];
+                    }
+                }
+                
+                // Handle note-off and clean up if the envelope has completed its release phase or the fade is over
+                if (noteEnds)
+                {
+                    clearCurrentNote();
+                    break;
+                }
+            }
+        }
+        
+        // Published once per block rather than per sample, for the voice allocation
+        publishLevel();
+    }
+    //--------------------------------------------------------------------------
+    /**
+     * @brief Restarts every random generator of this voice from a seed.
+     *
+     * The white noise, the noise wavetable and the random arpeggio each get their own stream derived from
+     * the voice seed, so rendering the same MIDI with the same seeds gives bit-identical output.
+     *
+     * @param seed Seed of this voice, usually derived from the plugin instance seed and the voice index.
+     */
+    void setRandomSeed(uint64_t seed)
+    {
+        random.setSeed(ChiptuneRandom::deriveSeed(seed, 0));
+        noise.setSeed(ChiptuneRandom::deriveSeed(seed, 1));
+        arpeggiator.setSeed(ChiptuneRandom::deriveSeed(seed, 2));
+       #if CHIPTUNE_FIXED_POINT
+        fixedNoise.setSeed(ChiptuneRandom::deriveSeed(seed, 1));
+       #endif
+    }
+    //--------------------------------------------------------------------------
+    /// Returns true while the voice is producing sound, including its release tail.
+    bool isActive() const { return playing; }
+    
+    /// Returns the MIDI note being played, or -1 if the voice is free.
+    int getCurrentNote() const { return currentNote; }
+    
+    /// Returns the oscillator of the current note: 0 for pulse, 1 for triangle, 2 for noise.
+    int getOscType() const { return currentOscType; }
+    
+    //--------------------------------------------------------------------------
+    // Voice allocation state, managed by ChiptuneEngine
+    bool keyDown = false;          // True while the key of the current note is held.
+    bool sustainPedalDown = false; // True if the note was released while the sustain pedal was held.
+    uint64_t noteOnTime = 0;       // Order in which the note started, used to steal the oldest voice.
+    
+    /// Saves or restores the running state of the voice and its modules, see StateArchive.h.
+    template <typename Archive>
+    void transferState(Archive& archive)
+    {
+        archive(keyDown, sustainPedalDown, noteOnTime, params, playing, currentNote, sampleRate, usesSnapshot);
+        archive(bitcrusher, pulseWidthModulation, arpeggiator, pitchBend, vibrato, squareOsc, triWave, noise, random, env);
+        archive(quality, controlRateDivider, controlCountdown, oversampling, decimator, unisonSize, unison, unisonFrequency,
+                bitcrusherRight, fadeRemaining, level, fadeGain, fadeStep);
+       #if CHIPTUNE_FIXED_POINT
+        archive(fixedSquareOsc, fixedTriWave, fixedNoise, fixedBitcrusher, fixedEnv, fixedMixer);
+       #endif
+        archive(periodCache, periodCacheLength, periodCachePosition, periodCachePeriods, periodCacheStartPhase, periodCacheFreq,
+                periodCachePulseWidth, periodCacheTriDistortion, periodCacheBandLimited, periodCacheValid, periodCacheTried);
+        archive(pulseWidth, freq, currentOscType, currentPwIndex);
+    }
+    
+private:
+    ChiptuneParameters params; // Parameters played by this voice. Declared first, the modules below keep a reference to it.
+    bool playing = false; // State variable to indicate whether the synth voice is currently playing.
+    int currentNote = -1; // MIDI note being played, -1 when free.
+    double sampleRate = 44100.0; // Sample rate of the host.
+    bool usesSnapshot = false; // True if the current note plays a fixed snapshot (key zone or SFX) instead of the live parameters.
+    Bitcrusher bitcrusher;
+    PulseWidthModulation pulseWidthModulation;
+    Arpeggiator arpeggiator;
+    PitchBend pitchBend;
+    Vibrato vibrato;
+    SquareOsc squareOsc;
+    TriOsc triWave;
+    Noise noise;
+    ChiptuneRandom random; // Utility for generating random numbers, used in noise synthesis.
+    Envelope env; // Envelope generator for controlling the amplitude envelope of the sound.
+    static constexpr int envelopeChunkSize = 64;              // Samples rendered at a time: the oscillators, then the envelope
+    float envLevels[envelopeChunkSize] {};                    // Envelope of the current chunk, from env.getNextBlock()
+    alignas(32) float voiceBuffer[envelopeChunkSize] {};      // Voice output of the current chunk, before it is added to the channels
+    alignas(32) float voiceRightBuffer[envelopeChunkSize] {}; // Right channel of a unison stack, which is stereo
+    alignas(32) float widthBuffer[envelopeChunkSize] {};      // Pulse width of each sample of the current chunk, see renderPulseSweep()
+    
+    RenderQuality quality;       // Quality settings from the engine.
+    int controlRateDivider = 1;  // Control rate divider of the current note, latched at note-on.
+    int controlCountdown = 0;    // Samples until the modulators run again.
+    int oversampling = 1;        // Oversampling of the pulse oscillator for the current note, latched at note-on.
+    Decimator decimator;         // Brings the oversampled pulse back to the sample rate.
+    int unisonSize = 1;          // Oscillators in the unison stack of the current note, latched at note-on. 1 for none.
+    UnisonOscillator unison;     // Detuned pulse or triangle stack, used when unisonSize > 1.
+    float unisonFrequency = 0.0f; // Frequency last given to the stack, to only update it on changes.
+    Bitcrusher bitcrusherRight;  // Triangle distortion of the right channel of a unison stack.
+    int fadeRemaining = 0;       // Samples left in a fadeOut(), 0 when not fading.
+    float level = 0.0f;          // Envelope level at the end of the last block, see getLevel().
+    float fadeGain = 1.0f;
+    float fadeStep = 0.0f;
+    
+   #if CHIPTUNE_FIXED_POINT
+    // Integer versions of the oscillators, distortion, envelope and output stage
+    FixedSquareOsc fixedSquareOsc;
+    FixedTriOsc fixedTriWave;
+    FixedNoise fixedNoise;
+    FixedBitcrusher fixedBitcrusher;
+    FixedEnvelope fixedEnv;
+    FixedMixer fixedMixer;
+   #endif
+    
+    //--------------------------------------------------------------------------
+    // Steady state: one loop of whole periods, played back instead of running the oscillator
+    static constexpr int minPeriodCacheLength = 256;
+    static constexpr int maxPeriodCacheLength = 4096;
+    std::vector<float> periodCache; // Oscillator output over periodCacheLength samples, before the envelope.
+    int periodCacheLength = 0;
+    int periodCachePosition = 0;    // Next sample to play.
+    int periodCachePeriods = 0;     // Number of whole periods in the loop.
+    float periodCacheStartPhase = 0.0f;
+    float periodCacheFreq = 0.0f;   // Settings the loop was rendered with, to notice changes.
+    float periodCachePulseWidth = 0.0f;
+    bool periodCacheTriDistortion = false;
+    bool periodCacheBandLimited = true;
+    bool periodCacheValid = false;
+    bool periodCacheTried = false;  // True once building the loop was attempted for the settings above.
+    
+    float pulseWidth = 0.5f; // Current setting for the pulse width of the square wave oscillator.
+    float freq = 440.0f;     // Current frequency of the note being played.
+    int currentOscType = 0;  // 0 for pulse, 1 for tri, 2 for noise.
+    int currentPwIndex = 0;  // 0 for 12.5%, 1 for 25%, 2 for 50%.
+    
+    //--------------------------------------------------------------------------
+    
+    const ChiptuneParameters& liveParams; // Reference to the engine's live parameters, refreshed once per block
+    const KeyZoneMap& keyZones; // Reference to the engine's key zones
+    
+    /// Marks the voice as free.
+    void clearCurrentNote()
+    {
+        playing = false;
+        currentNote = -1;
+        keyDown = false;
+        sustainPedalDown = false;
+        fadeRemaining = 0;
+        level = 0.0f;
+    }
+    
+    /// Passes the detune and stereo spread parameters to the unison stack.
+    void updateUnisonSpread()
+    {
+        unison.setDetune(params.get(ChiptuneParameters::unisonDetune));
+        unison.setSpread(params.get(ChiptuneParameters::unisonSpread));
+    }
+    
+    /// Passes the note frequency to the unison stack when it has changed.
+    void updateUnisonFrequency()
+    {
+        if (freq != unisonFrequency)
+        {
+            unison.setFrequency(freq);
+            unisonFrequency = freq;
+        }
+    }
+    
+    /// Adds a stereo sample: left and right to the first two channels, their mix to a mono output.
+    static void writeStereoSample(float* const* outputs, int numChannels, int sampleIndex, float left, float right)
+    {
+        if (numChannels == 1)
+        {
+            outputs[0][sampleIndex] += 0.5f * (left + right);
+            return;
+        }
+        outputs[0][sampleIndex] += left;
+        outputs[1][sampleIndex] += right;
+        for (int chan = 2; chan < numChannels; ++chan)
+            outputs[chan][sampleIndex] += 0.5f * (left + right);
+    }
+    
+    /// Stores the current envelope level, scaled by the fade, for getLevel().
+    void publishLevel()
+    {
+        if (! playing)
+            return;
+       #if CHIPTUNE_FIXED_POINT
+        level = fixedEnv.getLevel();
+       #else
+        level = env.getLevel();
+       #endif
+        if (fadeRemaining > 0)
+            level *= fadeGain;
+    }
+    
+    /// Sets up the oscillators, modulators and envelope for a new note, using the current parameter snapshot.
+    void beginNote(int midiNoteNumber)
+    {
+        playing = true;
+        currentNote = midiNoteNumber;
+        periodCacheValid = false;
+        periodCacheTried = false;
+        fadeRemaining = 0;
+        level = 0.0f;
+        
+        // The modulators run at the control rate, so they count time in control ticks
+        controlRateDivider = std::max(1, quality.controlRateDivider);
+        controlCountdown = 0;
+        double controlRate = sampleRate / controlRateDivider;
+        
+        // Only the float pulse is oversampled, the other waveforms alias little or on purpose
+        oversampling = 1;
+        
+        // Determine the oscillator type from parameters and configure the corresponding oscillator.
+        currentOscType = updateOscType();
+        
+        // Pulse and triangle can be stacked in unison, in the float build
+        unisonSize = 1;
+       #if ! CHIPTUNE_FIXED_POINT
+        if (currentOscType != 2)
+            unisonSize = std::clamp(static_cast<int>(params.get(ChiptuneParameters::unison)), 1, UnisonOscillator::maxOscillators);
+       #endif
+        
+        // Convert the MIDI note number to a frequency in Hz.
+        freq = Pitch::midiNoteToHertz(midiNoteNumber);
+        
+        switch (currentOscType) 
+        {
+            case 0: // Square oscillator
+               #if ! CHIPTUNE_FIXED_POINT
+                if (unisonSize == 1)
+                    oversampling = std::clamp(quality.oversampling, 1, Decimator::maxFactor);
+               #endif
+                decimator.setFactor(oversampling);
+                squareOsc.setSampleRate(sampleRate * oversampling);
+                squareOsc.setFrequency(freq);
+                break;
+            case 1: // Tri oscillator
+                triWave.setSampleRate(sampleRate);
+                triWave.setFrequency(freq);
+                break;
+            case 2: // Noise generator
+                noise.setSampleRate(sampleRate);
+                noise.setFrequency(freq);
+                break;
+        }
+       #if CHIPTUNE_FIXED_POINT
+        fixedSquareOsc.setSampleRate(sampleRate);
+        fixedTriWave.setSampleRate(sampleRate);
+        fixedNoise.setSampleRate(sampleRate);
+       #endif
+        
+        // Initialize and set the pulse width for the square oscillator based on the current setting.
+        currentPwIndex = updatePulseWidth();
+        switch (currentPwIndex)
+        {
+            case 0: // 12.5%
+                pulseWidth = 0.125f;
+                break;
+            case 1: // 25%
+                pulseWidth = 0.25f;
+                break;
+            case 2: // 50%
+                pulseWidth = 0.5f;
+                break;
+        }
+        squareOsc.setPulseWidth(pulseWidth);
+       #if CHIPTUNE_FIXED_POINT
+        fixedSquareOsc.setPulseWidth(pulseWidth);
+       #endif
+        
+        if (unisonSize > 1)
+        {
+            unison.setSampleRate(sampleRate);
+            unison.start(unisonSize);
+            updateUnisonSpread();
+            unison.setPulseWidth(pulseWidth);
+            unisonFrequency = 0.0f;
+            bitcrusherRight = bitcrusher;
+        }
+        
+        // Initialize pulse width modulation with the current sample rate and reset its state.
+        pulseWidthModulation.setSampleRate(controlRate);
+        pulseWidthModulation.setRate();
+        pulseWidthModulation.resetSustainCounter();
+        
+        // Initialize and start the pitch bend processor.
+        pitchBend.setSampleRate(controlRate);
+        pitchBend.startPitchBend(midiNoteNumber);
+        
+        // Initialize and start the arpeggiator.
+        arpeggiator.setSampleRate(controlRate);
+        arpeggiator.startArpeggio(midiNoteNumber);
+        
+        // Initialize vibrato, set its frequency, and reset its state.
+        vibrato.setSampleRate(controlRate);
+        vibrato.setFrequency();
+        vibrato.resetSustainCounter();
+        
+        // Initialize the envelope generator, reset its state, and start the note.
+        env.setSampleRate(sampleRate);
+        env.reset();
+        env.noteOn();
+       #if CHIPTUNE_FIXED_POINT
+        fixedEnv.setSampleRate(sampleRate);
+        fixedEnv.reset();
+       #endif
+        
+        // Update ADSR parameters from the plugin's parameters.
+        updateAdsrFromParameters();
+       #if CHIPTUNE_FIXED_POINT
+        fixedEnv.noteOn();
+       #endif
+    }
+    
+    /// Returns true if nothing modulates the pitch or timbre, so the oscillator output is strictly periodic.
+    bool isSteadyStateCandidate()
+    {
+        if (updateArpSwitch() || updatePbSwitch() || updateVibSwitch() || oversampling > 1 || unisonSize > 1)
+            return false;
+        return (currentOscType == 0 && ! updatePwmSwitch()) || currentOscType == 1;
+    }
+    
+    /// Returns true if only the pulse width is modulated, so the pulse can be rendered a control period at a time.
+    bool isPulseSweepCandidate()
+    {
+        return currentOscType == 0 && updatePwmSwitch() && ! updateArpSwitch() && ! updatePbSwitch() && ! updateVibSwitch()
+               && oversampling == 1 && unisonSize == 1;
+    }
+    
+    /// Returns true if the loop was rendered with the current frequency, pulse width and distortion.
+    bool periodCacheMatches()
+    {
+        return periodCacheFreq == freq && periodCachePulseWidth == pulseWidth
+               && periodCacheTriDistortion == updateTriDistortion() && periodCacheBandLimited == quality.bandLimited;
+    }
+    
+    /**
+     * @brief Renders a loop of whole periods of the current oscillator into periodCache.
+     *
+     * A period rarely lasts a whole number of samples, so the loop holds as many periods as fit in the
+     * length that comes closest to a whole number of them, and is rendered at the frequency that makes
+     * them fit exactly. If no length keeps that adjustment under half a cent, the note is played live
+     * as usual.
+     *
+     * @return true if the loop is ready to play
+     */
+    bool tryBuildPeriodCache()
+    {
+        if (periodCacheTried && periodCacheMatches())
+            return false; // Already failed with these settings
+        
+        double period = sampleRate / freq;
+        bool triDistortion = currentOscType == 1 && updateTriDistortion();
+        periodCacheTried = true;
+        periodCacheFreq = freq;
+        periodCachePulseWidth = pulseWidth;
+        periodCacheTriDistortion = updateTriDistortion();
+        periodCacheBandLimited = quality.bandLimited;
+        
+        int bestLength = 0;
+        int bestPeriods = 0;
+        double bestError = 1.0;
+        for (int length = minPeriodCacheLength; length <= maxPeriodCacheLength; ++length)
+        {
+            if (triDistortion && (length & 1) != 0)
+                continue; // The distortion holds every other sample, so the loop must have an even length
+            
+            double periods = std::round(length / period);
+            double error = std::abs(periods * period / length - 1.0);
+            if (periods >= 1.0 && error < bestError)
+            {
+                bestError = error;
+                bestLength = length;
+                bestPeriods = static_cast<int>(periods);
+                if (error < 1.0e-6)
+                    break;
+            }
+        }
+        if (bestError > 2.9e-4) // 0.5 cent
+            return false;
+        
+        // Render the loop on copies, so the live oscillator can pick up where the loop leaves off
+        float loopFreq = static_cast<float>(bestPeriods * sampleRate / bestLength);
+        if (currentOscType == 0)
+        {
+            SquareOsc loopOsc = squareOsc;
+            loopOsc.setFrequency(loopFreq);
+            for (int i = 0; i < bestLength; ++i)
+                periodCache[i] = loopOsc.process() / 2;
+            periodCacheStartPhase = squareOsc.getCurrentPhase();
+        }
+        else
+        {
+            TriOsc loopOsc = triWave;
+            Bitcrusher loopCrusher = bitcrusher;
+            loopOsc.setFrequency(loopFreq);
+            loopCrusher.setSampleRateReduction(2);
+            loopCrusher.setBitDepth(4);
+            for (int i = 0; i < bestLength; ++i)
+                periodCache[i] = (triDistortion ? loopCrusher.process(loopOsc.process()) : loopOsc.process()) * 1.2f;
+            periodCacheStartPhase = triWave.getCurrentPhase();
+        }
+        
+        periodCacheLength = bestLength;
+        periodCachePeriods = bestPeriods;
+        periodCachePosition = 0;
+        periodCacheValid = true;
+        return true;
+    }
+    
+    /// Plays the period loop with the constant sustain gain, in chunks the compiler can vectorize.
+    void renderSteadyState(float* const* outputs, int numChannels, int startSample, int numSamples)
+    {
+        float gain = 0.5f * env.getNextSample(); // The envelope holds its sustain level
+        while (numSamples > 0)
+        {
+            int chunk = std::min(numSamples, periodCacheLength - periodCachePosition);
+            const float* source = periodCache.data() + periodCachePosition;
+            for (int chan = 0; chan < numChannels; ++chan)
+            {
+                float* dest = outputs[chan] + startSample;
+                for (int i = 0; i < chunk; ++i)
+                    dest[i] += source[i] * gain;
+            }
+            
+            periodCachePosition += chunk;
+            if (periodCachePosition == periodCacheLength)
+                periodCachePosition = 0;
+            startSample += chunk;
+            numSamples -= chunk;
+        }
+    }
+    
+    /**
+     * @brief Renders the next chunk of the voice into voiceBuffer, and voiceRightBuffer for a unison stack.
+     *
+     * The oscillators run a sample at a time, since the modulators can change them on any control tick.
+     * The envelope is rendered for the whole chunk beforehand and applied after the oscillators, in a
+     * separate loop that the compiler vectorizes.
+     *
+     * @param numSamples length of the chunk, at most envelopeChunkSize
+     * @param noteEnds set to true if the envelope went idle within the chunk
+     * @return the number of samples rendered, up to the last one before the envelope went idle
+     */
+    int renderChunk(int numSamples, bool& noteEnds)
+    {
+       #if CHIPTUNE_FIXED_POINT
+        // The fixed-point envelope is part of the output stage, see renderFixedSample()
+        for (int i = 0; i < numSamples; ++i)
+        {
+            // Handle arpeggiator, pitch bend and vibrato at the control rate
+            bool controlTick = nextControlTick();
+            if (controlTick)
+                updatePitchModulation();
+            voiceBuffer[i] = FixedPoint::q15ToFloat(renderFixedSample(controlTick));
+            if (! fixedEnv.isActive())
+            {
+                noteEnds = true;
+                return i + 1;
+            }
+        }
+        return numSamples;
+       #else
+        int numActive = env.getNextBlock(envLevels, numSamples);
+        if (numActive < numSamples)
+        {
+            numSamples = std::max(numActive, 1);
+            noteEnds = true;
+        }
+        
+        // White noise does not depend on the pitch, so the whole chunk is drawn at once (-0.5 ~ 0.5), and the
+        // pitch modulators are left alone when they are all off, as in renderSteadyState(). Noise is never stacked in unison.
+        bool whiteNoise = currentOscType == 2 && ! updateNoiseDistortion();
+        if (whiteNoise)
+            random.fillBlock(voiceBuffer, numSamples, -0.5f, 0.5f);
+        
+        if (! whiteNoise || updateArpSwitch() || updatePbSwitch() || updateVibSwitch())
+        {
+            for (int i = 0; i < numSamples; ++i)
+            {
+                // Handle arpeggiator, pitch bend and vibrato at the control rate
+                bool controlTick = nextControlTick();
+                if (controlTick)
+                    updatePitchModulation();
+                if (! whiteNoise)
+                    renderOscillatorSample(controlTick, voiceBuffer[i], voiceRightBuffer[i]);
+            }
+        }
+        
+        // The output is scaled by 0.5 so that it is not too loud by default
+        for (int i = 0; i < numSamples; ++i)
+            voiceBuffer[i] = voiceBuffer[i] * 0.5f * envLevels[i];
+        if (unisonSize > 1)
+        {
+            for (int i = 0; i < numSamples; ++i)
+                voiceRightBuffer[i] = voiceRightBuffer[i] * 0.5f * envLevels[i];
+        }
+        return numSamples;
+       #endif
+    }
+    
+   #if ! CHIPTUNE_FIXED_POINT
+    /// Renders one sample of the current oscillator, before the envelope. The right channel is only used by a unison stack.
+    void renderOscillatorSample(bool controlTick, float& outputSample, float& outputRight)
+    {
+        outputSample = 0.0f;
+        outputRight = 0.0f;
+        
+        switch (currentOscType)
+        {
+            case 0: // Square oscillator
+            {
+                squareOsc.setFrequency(freq);
+                bool pwmEnabled = updatePwmSwitch();
+                if (pwmEnabled && controlTick)
+                {
+                    pulseWidth = pulseWidthModulation.process();
+                    squareOsc.setPulseWidth(pulseWidth);
+                    unison.setPulseWidth(pulseWidth);
+                }
+                if (unisonSize > 1)
+                {
+                    updateUnisonFrequency();
+                    unison.process(UnisonOscillator::Shape::pulse, outputSample, outputRight);
+                    outputSample /= 2;
+                    outputRight /= 2;
+                }
+                else if (oversampling > 1)
+                {
+                    for (int i = 0; i < oversampling; ++i)
+                        decimator.push(squareOsc.process());
+                    outputSample = decimator.output() / 2;
+                }
+                else
+                {
+                    outputSample = squareOsc.process() / 2; // reduce the volume, output range +-0.5
+                }
+                break;
+            }
+                
+            case 1: // Triangle oscillator with optional distortion
+            {
+                triWave.setFrequency(freq);
+                bool triDistortionEnabled = updateTriDistortion();
+                if (unisonSize > 1)
+                {
+                    updateUnisonFrequency();
+                    unison.process(UnisonOscillator::Shape::triangle, outputSample, outputRight);
+                    if (triDistortionEnabled)
+                    {
+                        bitcrusher.setSampleRateReduction(2);
+                        bitcrusher.setBitDepth(4);
+                        bitcrusherRight.setSampleRateReduction(2);
+                        bitcrusherRight.setBitDepth(4);
+                        outputSample = bitcrusher.process(outputSample);
+                        outputRight = bitcrusherRight.process(outputRight);
+                    }
+                    outputSample *= 1.2f;
+                    outputRight *= 1.2f;
+                }
+                else if (triDistortionEnabled)
+                {
+                    float rawSample = triWave.process();
+                    bitcrusher.setSampleRateReduction(2);
+                    bitcrusher.setBitDepth(4);
+                    outputSample = bitcrusher.process(rawSample) * 1.2; // Adjust volume
+                }
+                else
+                {
+                    outputSample = triWave.process() * 1.2; // Adjust volume
+                }
+                break;
+            }
+                
+            case 2: // Noise oscillator with optional distortion
+            {
+                noise.setFrequency(freq);
+                bool noiseDistortionEnabled = updateNoiseDistortion();
+                //std::cout << "The value is: " << noiseDistortionEnabled << std::endl;
+                if (noiseDistortionEnabled)
+                {
+                    outputSample = noise.process() * 0.5; // reduce the volume
+                }
+                // White noise, without the distortion, is drawn a chunk at a time by renderChunk()
+                break;
+            }
+        }
+    }
+   #endif
+    
+    /// Scales the first numSamples of the chunk by the fadeOut() ramp.
+    void applyFade(int numSamples)
+    {
+        for (int i = 0; i < numSamples; ++i)
+        {
+            voiceBuffer[i] *= fadeGain;
+           #if ! CHIPTUNE_FIXED_POINT
+            voiceRightBuffer[i] *= fadeGain;
+           #endif
+            fadeGain -= fadeStep;
+        }
+        fadeRemaining -= numSamples;
+    }
+    
+    /**
+     * @brief Renders a held pulse whose width is modulated, a chunk at a time.
+     *
+     * Nothing but the width changes while the envelope holds, so each chunk gets all its widths from the
+     * modulation first, then the pulse with the phase increment and sustain gain set once per block,
+     * instead of the per-sample oscillator switch and envelope of renderNextBlock(). Like
+     * renderSteadyState(), it leaves the pitch modulators alone, since they are all off.
+     */
+    void renderPulseSweep(float* const* outputs, int numChannels, int startSample, int numSamples)
+    {
+        float gain = 0.25f * env.getNextSample(); // Half the volume of the pulse, then half for the voice
+        squareOsc.setFrequency(freq);
+        while (numSamples > 0)
+        {
+            int chunk = std::min(numSamples, envelopeChunkSize);
+            if (controlRateDivider == 1)
+            {
+                pulseWidthModulation.process(widthBuffer, chunk);
+                pulseWidth = widthBuffer[chunk - 1];
+            }
+            else
+            {
+                for (int i = 0; i < chunk; ++i)
+                {
+                    if (nextControlTick())
+                        pulseWidth = pulseWidthModulation.process();
+                    widthBuffer[i] = pulseWidth;
+                }
+            }
+            squareOsc.render(voiceBuffer, widthBuffer, chunk, gain);
+            for (int chan = 0; chan < numChannels; ++chan)
+            {
+                float* dest = outputs[chan] + startSample;
+                for (int i = 0; i < chunk; ++i)
+                    dest[i] += voiceBuffer[i];
+            }
+            
+            startSample += chunk;
+            numSamples -= chunk;
+        }
+    }
+    
+    /// Stops playing the loop, moving the live oscillator to the phase the loop had reached.
+    void leaveSteadyState()
+    {
+        float elapsedCycles = static_cast<float>(periodCachePosition) * periodCachePeriods / periodCacheLength;
+        float phase = periodCacheStartPhase + elapsedCycles;
+        phase -= std::floor(phase);
+        if (currentOscType == 0)
+            squareOsc.setPhase(phase);
+        else
+            triWave.setPhase(phase);
+        periodCacheValid = false;
+        periodCacheTried = false;
+    }
+    
+    /// Returns true on the samples where the modulators run, once every controlRateDivider samples.
+    bool nextControlTick()
+    {
+        if (--controlCountdown > 0)
+            return false;
+        controlCountdown = controlRateDivider;
+        return true;
+    }
+    
+    /// Lets the modulators recompute what they derive from parameters that changed since the last block.
+    void updateModulatorParameters()
+    {
+        arpeggiator.updateParameters();
+        vibrato.updateParameters();
+        pulseWidthModulation.updateParameters();
+    }
+    
+    /// Advances the arpeggiator, pitch bend and vibrato by one control tick and updates the current frequency.
+    void updatePitchModulation()
+    {
+        // Handle arpeggiator
+        bool arpEnabled = updateArpSwitch();
+        if (arpEnabled)
+            freq = arpeggiator.getNextFrequency();
+        
+        // Handle pitch bend
+        bool pbEnabled = updatePbSwitch();
+        if (pbEnabled)
+            freq = pitchBend.process();
+        
+        // Handle vibrato
+        bool vibEnabled = updateVibSwitch();
+        float vibratoEffect = vibrato.process();
+        if (vibEnabled)
+            freq = freq * (1.0f + vibratoEffect);
+    }
+    
+    /// Updates the ADSR envelope parameters from the voice's parameter snapshot.
+    void updateAdsrFromParameters()
+    {
+        auto attackParam = params.get(ChiptuneParameters::attack);
+        auto decayParam = params.get(ChiptuneParameters::decay);
+        auto sustainParam = params.get(ChiptuneParameters::sustain);
+        auto releaseParam = params.get(ChiptuneParameters::release);
+        
+        Envelope::Parameters envParams;
+        envParams.attack = attackParam;
+        envParams.decay = decayParam;
+        envParams.sustain = sustainParam;
+        envParams.release = releaseParam;
+        
+        env.setParameters(envParams);
+        env.setCurve(static_cast<Envelope::Curve>(static_cast<int>(params.get(ChiptuneParameters::envCurve))));
+        
+       #if CHIPTUNE_FIXED_POINT
+        FixedEnvelope::Parameters fixedEnvParams;
+        fixedEnvParams.attack = attackParam;
+        fixedEnvParams.decay = decayParam;
+        fixedEnvParams.sustain = sustainParam;
+        fixedEnvParams.release = releaseParam;
+        fixedEnv.setParameters(fixedEnvParams);
+       #endif
+    }
+    
+   #if CHIPTUNE_FIXED_POINT
+    /**
+     * @brief Fixed-point counterpart of the oscillator, distortion and envelope stages of renderNextBlock.
+     *
+     * Uses the current frequency (after arpeggiator, pitch bend and vibrato) and returns the enveloped
+     * voice output as a Q15 sample. The pulse width modulation only runs on control ticks.
+     */
+    int32_t renderFixedSample(bool controlTick)
+    {
+        int32_t oscSample = 0;
+        switch (currentOscType)
+        {
+            case 0: // Square oscillator
+            {
+                fixedSquareOsc.setFrequency(freq);
+                if (updatePwmSwitch() && controlTick)
+                {
+                    pulseWidth = pulseWidthModulation.process();
+                    fixedSquareOsc.setPulseWidth(pulseWidth);
+                }
+                oscSample = fixedSquareOsc.process();
+                break;
+            }
+                
+            case 1: // Triangle oscillator with optional distortion
+            {
+                fixedTriWave.setFrequency(freq);
+                oscSample = fixedTriWave.process();
+                if (updateTriDistortion())
+                {
+                    fixedBitcrusher.setSampleRateReduction(2);
+                    fixedBitcrusher.setBitDepth(4);
+                    oscSample = fixedBitcrusher.process(oscSample);
+                }
+                break;
+            }
+                
+            case 2: // Noise oscillator with optional distortion
+            {
+                fixedNoise.setFrequency(freq);
+                if (updateNoiseDistortion())
+                    oscSample = fixedNoise.process();
+                else
+                    oscSample = static_cast<int32_t>(random.nextFloat() * 65536.0f) - FixedPoint::q15One; // Full scale, halved by the mixer
+                break;
+            }
+        }
+        
+        return fixedMixer.process(currentOscType, oscSample, fixedEnv.getNextSample());
+    }
+   #endif
+    
+    /// Retrieves and returns the current oscillator type based on user settings.
+    float updateOscType()
+    {
+        return params.get(ChiptuneParameters::oscType);
+    }
+    
+    /// Retrieves and returns the current pulse width setting from the parameters.
+    float updatePulseWidth()
+    {
+        return params.get(ChiptuneParameters::pulseWidth);
+    }
+    
+    /// Retrieves the arpeggiator speed setting from the parameters.
+    float updateArpSpeed()
+    {
+        return params.get(ChiptuneParameters::arpSpeed);
+    }
+    
+    /// Determines whether triangle wave distortion should be enabled based on the user parameter.
+    bool updateTriDistortion()
+    {
+        return params.isOn(ChiptuneParameters::triDistortion);
+    }
+    
+    /// Determines whether noise distortion should be enabled based on the user parameter.
+    bool updateNoiseDistortion()
+    {
+        return params.isOn(ChiptuneParameters::noiseDistortion);
+    }
+    
+    /// Checks if PWM should be activated based on a user-controlled switch.
+    bool updatePwmSwitch()
+    {
+        return params.isOn(ChiptuneParameters::pwmSwitch);
+    }
+    
+    /// Checks if the arpeggiator should be activated based on a user-controlled switch.
+    bool updateArpSwitch()
+    {
+        return params.isOn(ChiptuneParameters::arpSwitch);
+    }
+    
+    /// Checks if pitch bending should be activated based on a user-controlled switch.
+    bool updatePbSwitch()
+    {
+        return params.isOn(ChiptuneParameters::pbSwitch);
+    }
+    
+    /// Checks if vibrato should be activated based on a user-controlled switch.
+    bool updateVibSwitch()
+    {
+        return params.isOn(ChiptuneParameters::vibSwitch);
+    }
+};
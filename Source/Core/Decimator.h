@@ -0,0 +1,110 @@
+/*
+  ==============================================================================
+
+    Decimator.h
+    Created: 22 Oct 2026 10:41:17am
+    Author:  70
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+/**
+ * @class Decimator
+ *
+ * @brief Brings an oversampled signal back to the base sample rate with a windowed-sinc lowpass.
+ *
+ * Used by the voices to oversample the pulse oscillator: the oscillator runs factor times faster, every
+ * sample is pushed, and output() gives one filtered sample for every factor pushes. The filter is a
+ * linear-phase FIR of 32 taps per unit of factor, Blackman-windowed, with its cutoff at 0.9 times the
+ * base Nyquist frequency. It delays the signal by about 16 base-rate samples.
+ *
+ * Every buffer is fixed size, so setFactor() can be called from the audio thread.
+ */
+class Decimator
+{
+public:
+    static constexpr int maxFactor = 4;
+    static constexpr int tapsPerFactor = 32;
+    static constexpr int maxTaps = maxFactor * tapsPerFactor;
+
+    /// Sets the oversampling factor, from 1 (no filtering) to maxFactor, and clears the filter.
+    void setFactor(int newFactor)
+    {
+        newFactor = std::clamp(newFactor, 1, maxFactor);
+        if (newFactor != factor)
+        {
+            factor = newFactor;
+            design();
+        }
+        reset();
+    }
+
+    /// Returns the oversampling factor.
+    int getFactor() const { return factor; }
+
+    /// Clears the filter history.
+    void reset()
+    {
+        std::fill(history.begin(), history.begin() + 2 * numTaps, 0.0f);
+        position = 0;
+    }
+
+    /// Pushes one sample at the oversampled rate.
+    void push(float sample)
+    {
+        history[position] = sample;
+        history[position + numTaps] = sample; // Mirrored, so output() reads one contiguous run
+        if (++position == numTaps)
+            position = 0;
+    }
+
+    /// Returns the filtered signal at the last pushed sample. Call it once every factor pushes.
+    float output() const
+    {
+        const float* samples = history.data() + position;
+        float sum = 0.0f;
+        for (int i = 0; i < numTaps; ++i)
+            sum += coefficients[i] * samples[i];
+        return sum;
+    }
+
+private:
+    int factor = 0;   // 0 until the first setFactor(), so that it designs the filter
+    int numTaps = 1;
+    int position = 0; // Where the next sample goes
+    std::array<float, maxTaps> coefficients {};
+    std::array<float, 2 * maxTaps> history {};
+
+    /// Computes the windowed-sinc coefficients for the current factor, normalised to unity gain.
+    void design()
+    {
+        numTaps = factor * tapsPerFactor;
+        if (factor == 1)
+        {
+            numTaps = 1;
+            coefficients[0] = 1.0f;
+            return;
+        }
+
+        const double pi = 3.14159265358979323846;
+        double cutoff = 0.45 / factor; // Cycles per oversampled sample
+        double centre = 0.5 * (numTaps - 1);
+        double sum = 0.0;
+        for (int i = 0; i < numTaps; ++i)
+        {
+            double x = i - centre;
+            double sinc = x == 0.0 ? 2.0 * cutoff : std::sin(2.0 * pi * cutoff * x) / (pi * x);
+            double w = 2.0 * pi * i / (numTaps - 1);
+            double window = 0.42 - 0.5 * std::cos(w) + 0.08 * std::cos(2.0 * w);
+            coefficients[i] = static_cast<float>(sinc * window);
+            sum += coefficients[i];
+        }
+        for (int i = 0; i < numTaps; ++i)
+            coefficients[i] = static_cast<float>(coefficients[i] / sum);
+    }
+};
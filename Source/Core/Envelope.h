@@ -0,0 +1,402 @@
+/*
+  ==============================================================================
+
+    Envelope.h
+    Created: 18 Oct 2026 10:20:03am
+    Author:  70
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <algorithm>
+#include <cmath>
+
+/**
+ * @class Envelope
+ *
+ * @brief ADSR envelope generator.
+ *
+ * Behaves like juce::ADSR (linear attack, decay and release ramps, same stage transitions), so that the
+ * synthesis core does not depend on JUCE. Times are in seconds, the sustain level is in the range 0~1.
+ *
+ * The decay and release can also follow an exponential curve, or the 16 volume steps of the NES
+ * envelope (see Curve). getNextBlock() renders many samples at once: it works out how many samples are
+ * left in the current stage and writes each stage as one branch-free ramp, which the compiler
+ * vectorises, instead of going through the stage switch at every sample.
+ */
+class Envelope
+{
+public:
+    struct Parameters
+    {
+        float attack = 0.1f, decay = 0.1f, sustain = 1.0f, release = 0.1f;
+    };
+
+    /// Shape of the decay and release. The attack is always linear.
+    enum class Curve
+    {
+        linear,      // Straight ramps, like juce::ADSR
+        exponential, // Fast then slow, reaching the target after the same time as the linear ramp
+        nesSteps     // Straight ramps quantised to the 16 volume levels of the NES
+    };
+
+    /// Sets the curve of the decay and release.
+    void setCurve(Curve newCurve)
+    {
+        curve = newCurve;
+    }
+
+    /// Sets the sample rate and recalculates the ramp rates.
+    void setSampleRate(double newSampleRate)
+    {
+        sampleRate = newSampleRate;
+        recalculateRates();
+    }
+
+    /// Sets the attack, decay, sustain and release values.
+    void setParameters(const Parameters& newParameters)
+    {
+        parameters = newParameters;
+        recalculateRates();
+    }
+
+    /// Jumps back to the idle state.
+    void reset()
+    {
+        envelopeVal = 0.0f;
+        state = State::idle;
+    }
+
+    /// Starts the attack stage.
+    void noteOn()
+    {
+        if (attackRate > 0.0f)
+        {
+            state = State::attack;
+        }
+        else if (decayRate > 0.0f)
+        {
+            envelopeVal = 1.0f;
+            state = State::decay;
+            startStage(decayStart);
+        }
+        else
+        {
+            envelopeVal = parameters.sustain;
+            state = State::sustain;
+        }
+    }
+
+    /// Starts the release stage from the current level.
+    void noteOff()
+    {
+        if (state != State::idle)
+        {
+            if (parameters.release > 0.0f)
+            {
+                releaseRate = static_cast<float>(envelopeVal / (parameters.release * sampleRate));
+                state = State::release;
+                startStage(releaseStart);
+            }
+            else
+            {
+                reset();
+            }
+        }
+    }
+
+    /// Returns the next envelope level.
+    float getNextSample()
+    {
+        if (curve != Curve::linear && (state == State::decay || state == State::release))
+        {
+            float level;
+            getNextBlock(&level, 1);
+            return level;
+        }
+
+        switch (state)
+        {
+            case State::idle:
+                return 0.0f;
+
+            case State::attack:
+                envelopeVal += attackRate;
+                if (envelopeVal >= 1.0f)
+                {
+                    envelopeVal = 1.0f;
+                    goToNextState();
+                }
+                break;
+
+            case State::decay:
+                envelopeVal -= decayRate;
+                if (envelopeVal <= parameters.sustain)
+                {
+                    envelopeVal = parameters.sustain;
+                    goToNextState();
+                }
+                break;
+
+            case State::sustain:
+                envelopeVal = parameters.sustain;
+                break;
+
+            case State::release:
+                envelopeVal -= releaseRate;
+                if (envelopeVal <= 0.0f)
+                    goToNextState();
+                break;
+        }
+        return envelopeVal;
+    }
+
+    /**
+     * @brief Writes the next numSamples levels, on the same curve as calling getNextSample() numSamples times.
+     *
+     * Not bit for bit: the block computes each linear ramp from the start of its stage, where
+     * getNextSample() accumulates it sample by sample, and the rounding differs. A stage can end one
+     * sample earlier or later, and the levels differ by up to about one sample's change of the ramp; on
+     * the NES curve, a level next to a step can land on the other side of it, one volume step away.
+     *
+     * @return the number of samples written before the envelope went idle, including the last non-idle
+     *         one; numSamples if it is still active at the end
+     */
+    int getNextBlock(float* levels, int numSamples)
+    {
+        int position = 0;
+        while (position < numSamples)
+        {
+            int remaining = numSamples - position;
+            float* out = levels + position;
+            switch (state)
+            {
+                case State::idle:
+                    std::fill(out, out + remaining, 0.0f);
+                    return position;
+
+                case State::attack:
+                {
+                    int length = getStageLength(1.0f - envelopeVal, attackRate);
+                    int count = std::min(length, remaining);
+                    writeLinearRamp(out, count, envelopeVal, attackRate);
+                    position += count;
+                    if (count == length)
+                    {
+                        envelopeVal = 1.0f;
+                        out[count - 1] = 1.0f;
+                        goToNextState();
+                    }
+                    else
+                    {
+                        envelopeVal = out[count - 1];
+                    }
+                    break;
+                }
+
+                case State::decay:
+                    position += writeFallingStage(out, remaining, parameters.sustain, decayRate, decayStart);
+                    break;
+
+                case State::sustain:
+                    envelopeVal = parameters.sustain;
+                    std::fill(out, out + remaining, envelopeVal);
+                    return numSamples;
+
+                case State::release:
+                {
+                    int count = writeFallingStage(out, remaining, 0.0f, releaseRate, releaseStart);
+                    position += count;
+                    if (state == State::idle)
+                    {
+                        std::fill(out + count, out + remaining, 0.0f);
+                        return position;
+                    }
+                    break;
+                }
+            }
+        }
+        return numSamples;
+    }
+
+    /// Returns the level given by the last getNextSample() call, without advancing.
+    float getLevel() const
+    {
+        return envelopeVal;
+    }
+
+    /// Returns true once the envelope holds its sustain level, until the note is released.
+    bool isSustaining() const
+    {
+        return state == State::sustain;
+    }
+
+    /// Returns true while the envelope is not idle.
+    bool isActive() const
+    {
+        return state != State::idle;
+    }
+
+private:
+    enum class State { idle, attack, decay, sustain, release };
+
+    State state = State::idle;
+    Parameters parameters;
+    double sampleRate = 44100.0;
+    float envelopeVal = 0.0f;
+    float attackRate = 0.0f;
+    float decayRate = 0.0f;
+    float releaseRate = 0.0f;
+    Curve curve = Curve::linear;
+
+    /// Progress of a curved decay or release, which is computed from the start of the stage.
+    struct Stage
+    {
+        float from = 0.0f;   // Level at the start of the stage
+        int length = 0;      // Samples in the stage
+        int elapsed = 0;     // Samples done
+        double ratio = 1.0;  // Exponential curve: factor applied to the gain at every sample
+        double gain = 1.0;   // Exponential curve: goes from 1 to exponentialDepth over the stage
+    };
+    Stage decayStart, releaseStart;
+
+    static constexpr float exponentialDepth = 0.001f; // The exponential curve reaches -60 dB of its distance at the end
+    static constexpr int nesSteps = 15;
+
+    /// Returns how many samples a linear ramp of the given rate takes to cover the distance, at least 1.
+    static int getStageLength(float distance, float rate)
+    {
+        if (rate <= 0.0f)
+            return 1;
+        return std::max(1, static_cast<int>(std::ceil(distance / rate)));
+    }
+
+    /// Writes start + rate, start + 2 rate, ...
+    static void writeLinearRamp(float* out, int count, float start, float rate)
+    {
+        for (int i = 0; i < count; ++i)
+            out[i] = start + rate * static_cast<float>(i + 1);
+    }
+
+    /// Remembers the level and length of a decay or release that is starting.
+    void startStage(Stage& stage)
+    {
+        float target = state == State::decay ? parameters.sustain : 0.0f;
+        float rate = state == State::decay ? decayRate : releaseRate;
+        stage.from = envelopeVal;
+        stage.length = getStageLength(envelopeVal - target, rate);
+        stage.elapsed = 0;
+        stage.ratio = std::pow(static_cast<double>(exponentialDepth), 1.0 / stage.length);
+        stage.gain = 1.0;
+    }
+
+    /**
+     * @brief Writes up to maxCount samples of a decay or release towards target, in the current curve.
+     *
+     * Moves on to the next stage when it ends. Returns the number of samples written.
+     */
+    int writeFallingStage(float* out, int maxCount, float target, float rate, Stage& stage)
+    {
+        int count;
+        bool ends;
+        if (curve == Curve::linear)
+        {
+            int length = getStageLength(envelopeVal - target, rate);
+            count = std::min(length, maxCount);
+            ends = count == length;
+            writeLinearRamp(out, count, envelopeVal, -rate);
+        }
+        else
+        {
+            count = std::min(stage.length - stage.elapsed, maxCount);
+            ends = stage.elapsed + count == stage.length;
+            if (curve == Curve::exponential)
+                writeExponentialRamp(out, count, target, stage);
+            else
+                writeSteppedRamp(out, count, target, stage);
+            stage.elapsed += count;
+        }
+
+        if (ends)
+        {
+            out[count - 1] = target;
+            envelopeVal = target;
+            goToNextState();
+        }
+        else
+        {
+            envelopeVal = out[count - 1];
+        }
+        return count;
+    }
+
+    /// Writes the exponential curve from stage.from to target, normalised to end exactly on target.
+    static void writeExponentialRamp(float* out, int count, float target, Stage& stage)
+    {
+        double scale = (stage.from - target) / (1.0 - exponentialDepth);
+        double gain = stage.gain;
+        for (int i = 0; i < count; ++i)
+        {
+            gain *= stage.ratio;
+            out[i] = target + static_cast<float>(scale * (gain - exponentialDepth));
+        }
+        stage.gain = gain;
+    }
+
+    /**
+     * @brief Writes the falling linear ramp from stage.from to target, rounded down to the NES volume steps.
+     *
+     * A sustain level between two steps would round down below the level the decay is heading for, so
+     * the ramp never goes below target.
+     */
+    static void writeSteppedRamp(float* out, int count, float target, const Stage& stage)
+    {
+        float step = (target - stage.from) / static_cast<float>(stage.length);
+        for (int i = 0; i < count; ++i)
+        {
+            float level = stage.from + step * static_cast<float>(stage.elapsed + i + 1);
+            out[i] = std::max(std::floor(level * nesSteps) / nesSteps, target);
+        }
+    }
+
+    /// Converts the stage times into per-sample steps, -1 meaning an instant stage.
+    void recalculateRates()
+    {
+        auto getRate = [this](float distance, float timeInSeconds)
+        {
+            return timeInSeconds > 0.0f ? static_cast<float>(distance / (timeInSeconds * sampleRate)) : -1.0f;
+        };
+
+        attackRate = getRate(1.0f, parameters.attack);
+        decayRate = getRate(1.0f - parameters.sustain, parameters.decay);
+        releaseRate = getRate(parameters.sustain, parameters.release);
+
+        if ((state == State::attack && attackRate <= 0.0f)
+            || (state == State::decay && (decayRate <= 0.0f || envelopeVal <= parameters.sustain))
+            || (state == State::release && releaseRate <= 0.0f))
+        {
+            goToNextState();
+        }
+    }
+
+    void goToNextState()
+    {
+        if (state == State::attack)
+        {
+            state = (decayRate > 0.0f ? State::decay : State::sustain);
+            if (state == State::decay)
+                startStage(decayStart);
+            return;
+        }
+
+        if (state == State::decay)
+        {
+            state = State::sustain;
+            return;
+        }
+
+        if (state == State::release)
+            reset();
+    }
+};
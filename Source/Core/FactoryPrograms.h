@@ -0,0 +1,150 @@
+/*
+  ==============================================================================
+
+    FactoryPrograms.h
+    Created: 24 Oct 2026 2:05:52pm
+    Author:  70
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <cstddef>
+#include <iterator>
+
+/**
+ * @brief The presets shipped in the Presets folder, compiled in as plain values.
+ *
+ * Each program lists the parameter values stored in its .vstpreset file. Parameters added since a
+ * preset was saved are not listed and keep their default value, as when the file itself is loaded.
+ * ProgramBank turns these lists into parameter snapshots once, when it is created.
+ */
+namespace FactoryPrograms
+{
+    /// One parameter value of a program.
+    struct Value
+    {
+        const char* id;
+        float value;
+    };
+
+    /// A program: its name and the values it sets.
+    struct Program
+    {
+        const char* name;
+        const Value* values;
+        size_t numValues;
+    };
+
+    inline const Value harshGranularNoise[] =
+    {
+        { "arpOctave", 0.0f }, { "arpPattern", 0.0f }, { "arpSpeed", 0.5f }, { "arpSwitch", 0.0f },
+        { "attack", 0.01f }, { "bitDepth", 1.0f }, { "decay", 0.0f }, { "delayTime", 0.0f },
+        { "dryWetMix", 0.19999999f }, { "feedback", 0.0f }, { "noiseDistortion", 1.0f }, { "oscType", 2.0f },
+        { "pbInitPitch", 0.0f }, { "pbSwitch", 0.0f }, { "pbTime", 0.1f }, { "pulseWidth", 0.0f },
+        { "pwmMode", 0.0f }, { "pwmRate", 0.5f }, { "pwmSustain", 0.0f }, { "pwmSwitch", 0.0f },
+        { "rateReduction", 10.0f }, { "release", 0.01f }, { "sustain", 1.0f }, { "triDistortion", 1.0f },
+        { "vibAmount", 0.099999994f }, { "vibSpeed", 0.099999994f }, { "vibSustain", 0.0f }, { "vibSwitch", 0.0f }
+    };
+
+    inline const Value leadPulseWaveWithEcho[] =
+    {
+        { "arpOctave", 0.0f }, { "arpPattern", 0.0f }, { "arpSpeed", 0.5f }, { "arpSwitch", 0.0f },
+        { "attack", 0.01f }, { "bitDepth", 24.0f }, { "decay", 0.0f }, { "delayTime", 0.19999999f },
+        { "dryWetMix", 0.19999999f }, { "feedback", 0.01f }, { "noiseDistortion", 1.0f }, { "oscType", 0.0f },
+        { "pbInitPitch", 0.0f }, { "pbSwitch", 0.0f }, { "pbTime", 0.01f }, { "pulseWidth", 1.0f },
+        { "pwmMode", 0.0f }, { "pwmRate", 0.5f }, { "pwmSustain", 0.0f }, { "pwmSwitch", 0.0f },
+        { "rateReduction", 1.0f }, { "release", 0.01f }, { "sustain", 1.0f }, { "triDistortion", 1.0f },
+        { "vibAmount", 0.099999994f }, { "vibSpeed", 0.7f }, { "vibSustain", 0.11f }, { "vibSwitch", 1.0f }
+    };
+
+    inline const Value noiseHihat[] =
+    {
+        { "arpOctave", 0.0f }, { "arpPattern", 0.0f }, { "arpSpeed", 0.5f }, { "arpSwitch", 0.0f },
+        { "attack", 0.01f }, { "bitDepth", 24.0f }, { "decay", 0.049999997f }, { "delayTime", 0.0f },
+        { "dryWetMix", 0.19999999f }, { "feedback", 0.0f }, { "noiseDistortion", 0.0f }, { "oscType", 2.0f },
+        { "pbInitPitch", 0.0f }, { "pbSwitch", 0.0f }, { "pbTime", 0.01f }, { "pulseWidth", 1.0f },
+        { "pwmMode", 0.0f }, { "pwmRate", 0.5f }, { "pwmSustain", 0.0f }, { "pwmSwitch", 0.0f },
+        { "rateReduction", 1.0f }, { "release", 0.28f }, { "sustain", 0.0f }, { "triDistortion", 1.0f },
+        { "vibAmount", 0.099999994f }, { "vibSpeed", 0.099999994f }, { "vibSustain", 0.0f }, { "vibSwitch", 0.0f }
+    };
+
+    inline const Value noiseSnare[] =
+    {
+        { "arpOctave", 0.0f }, { "arpPattern", 0.0f }, { "arpSpeed", 0.5f }, { "arpSwitch", 0.0f },
+        { "attack", 0.01f }, { "bitDepth", 24.0f }, { "decay", 0.17999999f }, { "delayTime", 0.0f },
+        { "dryWetMix", 0.19999999f }, { "feedback", 0.0f }, { "noiseDistortion", 0.0f }, { "oscType", 2.0f },
+        { "pbInitPitch", 0.0f }, { "pbSwitch", 0.0f }, { "pbTime", 0.1f }, { "pulseWidth", 0.0f },
+        { "pwmMode", 0.0f }, { "pwmRate", 0.5f }, { "pwmSustain", 0.0f }, { "pwmSwitch", 0.0f },
+        { "rateReduction", 1.0f }, { "release", 0.03f }, { "sustain", 0.39999998f }, { "triDistortion", 1.0f },
+        { "vibAmount", 0.099999994f }, { "vibSpeed", 0.099999994f }, { "vibSustain", 0.0f }, { "vibSwitch", 0.0f }
+    };
+
+    inline const Value pixelGameFootstep[] =
+    {
+        { "arpOctave", 0.0f }, { "arpPattern", 0.0f }, { "arpSpeed", 0.5f }, { "arpSwitch", 0.0f },
+        { "attack", 0.01f }, { "bitDepth", 24.0f }, { "decay", 0.12f }, { "delayTime", 0.0f },
+        { "dryWetMix", 0.19999999f }, { "feedback", 0.0f }, { "noiseDistortion", 1.0f }, { "oscType", 0.0f },
+        { "pbInitPitch", 9.0f }, { "pbSwitch", 1.0f }, { "pbTime", 0.10999999f }, { "pulseWidth", 0.0f },
+        { "pwmMode", 5.0f }, { "pwmRate", 0.94f }, { "pwmSustain", 0.01f }, { "pwmSwitch", 1.0f },
+        { "rateReduction", 1.0f }, { "release", 0.01f }, { "sustain", 0.0f }, { "triDistortion", 1.0f },
+        { "vibAmount", 0.099999994f }, { "vibSpeed", 0.099999994f }, { "vibSustain", 0.0f }, { "vibSwitch", 0.0f }
+    };
+
+    inline const Value pixelGameJump[] =
+    {
+        { "arpOctave", 0.0f }, { "arpPattern", 0.0f }, { "arpSpeed", 0.5f }, { "arpSwitch", 0.0f },
+        { "attack", 0.01f }, { "bitDepth", 24.0f }, { "decay", 0.19999999f }, { "delayTime", 0.0f },
+        { "dryWetMix", 0.19999999f }, { "feedback", 0.0f }, { "noiseDistortion", 1.0f }, { "oscType", 0.0f },
+        { "pbInitPitch", -12.0f }, { "pbSwitch", 1.0f }, { "pbTime", 0.24f }, { "pulseWidth", 2.0f },
+        { "pwmMode", 0.0f }, { "pwmRate", 0.5f }, { "pwmSustain", 0.01f }, { "pwmSwitch", 0.0f },
+        { "rateReduction", 1.0f }, { "release", 0.0f }, { "sustain", 0.0f }, { "triDistortion", 1.0f },
+        { "vibAmount", 0.099999994f }, { "vibSpeed", 0.099999994f }, { "vibSustain", 0.0f }, { "vibSwitch", 0.0f }
+    };
+
+    inline const Value pureTriWave[] =
+    {
+        { "arpOctave", 0.0f }, { "arpPattern", 0.0f }, { "arpSpeed", 0.5f }, { "arpSwitch", 0.0f },
+        { "attack", 0.01f }, { "bitDepth", 24.0f }, { "decay", 0.22999999f }, { "delayTime", 0.089999996f },
+        { "dryWetMix", 0.12f }, { "feedback", 0.58f }, { "noiseDistortion", 1.0f }, { "oscType", 1.0f },
+        { "pbInitPitch", 0.0f }, { "pbSwitch", 0.0f }, { "pbTime", 0.1f }, { "pulseWidth", 1.0f },
+        { "pwmMode", 0.0f }, { "pwmRate", 0.5f }, { "pwmSustain", 0.0f }, { "pwmSwitch", 0.0f },
+        { "rateReduction", 1.0f }, { "release", 0.32f }, { "sustain", 0.21f }, { "triDistortion", 0.0f },
+        { "vibAmount", 0.099999994f }, { "vibSpeed", 0.099999994f }, { "vibSustain", 0.0f }, { "vibSwitch", 0.0f }
+    };
+
+    inline const Value shiningPulseWave[] =
+    {
+        { "arpOctave", 2.0f }, { "arpPattern", 6.0f }, { "arpSpeed", 0.62f }, { "arpSwitch", 1.0f },
+        { "attack", 0.01f }, { "bitDepth", 24.0f }, { "decay", 0.0f }, { "delayTime", 0.0f },
+        { "dryWetMix", 0.19999999f }, { "feedback", 0.0f }, { "noiseDistortion", 1.0f }, { "oscType", 0.0f },
+        { "pbInitPitch", 0.0f }, { "pbSwitch", 0.0f }, { "pbTime", 0.01f }, { "pulseWidth", 0.0f },
+        { "pwmMode", 5.0f }, { "pwmRate", 0.79999995f }, { "pwmSustain", 0.01f }, { "pwmSwitch", 1.0f },
+        { "rateReduction", 1.0f }, { "release", 0.01f }, { "sustain", 1.0f }, { "triDistortion", 1.0f },
+        { "vibAmount", 0.099999994f }, { "vibSpeed", 0.099999994f }, { "vibSustain", 0.0f }, { "vibSwitch", 0.0f }
+    };
+
+    inline const Value youWin[] =
+    {
+        { "arpOctave", 2.0f }, { "arpPattern", 5.0f }, { "arpSpeed", 0.95f }, { "arpSwitch", 1.0f },
+        { "attack", 0.02f }, { "bitDepth", 24.0f }, { "decay", 1.0799999f }, { "delayTime", 0.19999999f },
+        { "dryWetMix", 0.22f }, { "feedback", 0.32999998f }, { "noiseDistortion", 1.0f }, { "oscType", 0.0f },
+        { "pbInitPitch", 9.0f }, { "pbSwitch", 0.0f }, { "pbTime", 0.10999999f }, { "pulseWidth", 1.0f },
+        { "pwmMode", 5.0f }, { "pwmRate", 0.94f }, { "pwmSustain", 0.01f }, { "pwmSwitch", 0.0f },
+        { "rateReduction", 1.0f }, { "release", 0.0f }, { "sustain", 0.0f }, { "triDistortion", 1.0f },
+        { "vibAmount", 0.099999994f }, { "vibSpeed", 0.099999994f }, { "vibSustain", 0.0f }, { "vibSwitch", 0.0f }
+    };
+
+    inline const Program programs[] =
+    {
+        { "Harsh Granular Noise", harshGranularNoise, std::size(harshGranularNoise) },
+        { "Lead Pulse Wave with Echo", leadPulseWaveWithEcho, std::size(leadPulseWaveWithEcho) },
+        { "Noise Hihat", noiseHihat, std::size(noiseHihat) },
+        { "Noise Snare", noiseSnare, std::size(noiseSnare) },
+        { "Pixel Game Footstep", pixelGameFootstep, std::size(pixelGameFootstep) },
+        { "Pixel Game Jump", pixelGameJump, std::size(pixelGameJump) },
+        { "Pure Tri Wave", pureTriWave, std::size(pureTriWave) },
+        { "Shining Pulse Wave", shiningPulseWave, std::size(shiningPulseWave) },
+        { "You Win!!!", youWin, std::size(youWin) }
+    };
+}
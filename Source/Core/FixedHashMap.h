@@ -0,0 +1,127 @@
+/*
+  ==============================================================================
+
+    FixedHashMap.h
+    Created: 28 Oct 2026 9:40:03am
+    Author:  70
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/**
+ * @class FixedHashMap
+ *
+ * @brief Map from 64-bit keys to values with a fixed number of slots, so it never allocates once built.
+ *
+ * Open addressing with linear probing. Erasing shifts the following entries of the probe back, so
+ * there are no tombstones and lookups stay short however long the map is used. Keep it at most half
+ * full: insert() fails when the map is full, and probes get long well before that.
+ */
+template <typename Value>
+class FixedHashMap
+{
+public:
+    /// Constructs a map with room for at least capacity entries, rounded up to a power of two. Allocates.
+    explicit FixedHashMap(size_t capacity)
+    {
+        size_t size = 1;
+        while (size < capacity)
+            size *= 2;
+        slots.resize(size);
+    }
+
+    /// Returns the value stored under a key, or nullptr.
+    Value* find(uint64_t key)
+    {
+        return const_cast<Value*>(static_cast<const FixedHashMap*>(this)->find(key));
+    }
+
+    const Value* find(uint64_t key) const
+    {
+        for (size_t i = home(key), n = 0; n < slots.size() && slots[i].used; i = next(i), ++n)
+        {
+            if (slots[i].key == key)
+                return &slots[i].value;
+        }
+        return nullptr;
+    }
+
+    /// Stores a value under a key, replacing the previous one. Returns false if the map is full.
+    bool insert(uint64_t key, Value value)
+    {
+        if (auto* existing = find(key))
+        {
+            *existing = std::move(value);
+            return true;
+        }
+        if (numEntries == slots.size())
+            return false;
+
+        size_t i = home(key);
+        while (slots[i].used)
+            i = next(i);
+
+        slots[i] = { key, std::move(value), true };
+        ++numEntries;
+        return true;
+    }
+
+    /// Removes a key and its value, if present.
+    void erase(uint64_t key)
+    {
+        size_t hole = home(key);
+        for (size_t n = 0; slots[hole].used && slots[hole].key != key; hole = next(hole), ++n)
+        {
+            if (n == slots.size())
+                return;
+        }
+        if (! slots[hole].used)
+            return;
+
+        // Move back every following entry of the run whose home is not between the hole and itself
+        for (size_t i = next(hole); slots[i].used; i = next(i))
+        {
+            size_t entryHome = home(slots[i].key);
+            bool reachable = hole <= i ? (entryHome <= hole || entryHome > i) : (entryHome <= hole && entryHome > i);
+            if (reachable)
+            {
+                slots[hole] = std::move(slots[i]);
+                hole = i;
+            }
+        }
+        slots[hole] = Slot();
+        --numEntries;
+    }
+
+    /// Removes every entry.
+    void clear()
+    {
+        for (auto& slot : slots)
+            slot = Slot();
+        numEntries = 0;
+    }
+
+    /// Returns the number of entries.
+    size_t size() const { return numEntries; }
+
+private:
+    struct Slot
+    {
+        uint64_t key = 0;
+        Value value {};
+        bool used = false;
+    };
+
+    std::vector<Slot> slots;
+    size_t numEntries = 0;
+
+    /// Mixes the key, so that sequential keys spread over the table too.
+    size_t home(uint64_t key) const { return static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> 32) & (slots.size() - 1); }
+    size_t next(size_t i) const { return (i + 1) & (slots.size() - 1); }
+};
@@ -0,0 +1,103 @@
+/*
+  ==============================================================================
+
+    FixedPoint.h
+    Created: 17 Oct 2026 3:05:24pm
+    Author:  70
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <cstdint>
+#include <cmath>
+
+/// Set to 1 (e.g. in the Projucer preprocessor definitions) to render voices and effects in fixed point.
+#ifndef CHIPTUNE_FIXED_POINT
+ #define CHIPTUNE_FIXED_POINT 0
+#endif
+
+/**
+ * @class FixedPoint
+ *
+ * @brief Q15/Q31 helpers for the integer render path used on boards without a fast FPU.
+ *
+ * Audio samples are carried as Q15 values (32768 = 1.0) in 32-bit integers, which leaves headroom for
+ * sums and feedback. Envelope levels and other slowly changing gains use Q31 (2^31 = 1.0). Conversions
+ * from float only happen when a parameter changes, never per sample, except at the host buffer boundary.
+ */
+struct FixedPoint
+{
+    static constexpr int32_t q15One = 1 << 15;            // 1.0 in Q15
+    static constexpr int32_t q31Max = 0x7fffffff;         // Largest Q31 value, just below 1.0
+
+    /// Converts a float to Q15, saturating to the 16-bit range.
+    static int32_t floatToQ15(float x)
+    {
+        return saturateQ15(static_cast<int32_t>(std::lround(x * q15One)));
+    }
+
+    /// Converts a Q15 value back to float.
+    static float q15ToFloat(int32_t x)
+    {
+        return static_cast<float>(x) * (1.0f / q15One);
+    }
+
+    /// Converts a float in [0, 1] to Q31.
+    static int32_t floatToQ31(float x)
+    {
+        if (x >= 1.0f)
+            return q31Max;
+        if (x <= -1.0f)
+            return -q31Max - 1;
+        return static_cast<int32_t>(static_cast<double>(x) * 2147483648.0);
+    }
+
+    /// Multiplies two Q15 values with rounding. Inputs may exceed 1.0 (headroom), the product is Q15.
+    static int32_t mulQ15(int32_t a, int32_t b)
+    {
+        return static_cast<int32_t>((static_cast<int64_t>(a) * b + (1 << 14)) >> 15);
+    }
+
+    /// Multiplies a Q15 sample by a Q31 gain, the result is Q15.
+    static int32_t mulQ15Q31(int32_t sample, int32_t gain)
+    {
+        return static_cast<int32_t>((static_cast<int64_t>(sample) * gain) >> 31);
+    }
+
+    /// Clamps a value to the signed 16-bit range.
+    static int32_t saturateQ15(int32_t x)
+    {
+        return x > 32767 ? 32767 : (x < -32768 ? -32768 : x);
+    }
+};
+
+/**
+ * @class FixedMixer
+ *
+ * @brief Fixed-point version of the voice output stage.
+ *
+ * Applies the per-channel gains of the float path (pulse /2, triangle *1.2, noise *0.5), the overall
+ * voice gain of 0.5 and the envelope, and saturates the result. Gains are stored in Q12 so that values
+ * above 1.0 can be represented.
+ */
+class FixedMixer
+{
+public:
+    /// Sets the gain of a channel (0 pulse, 1 triangle, 2 noise).
+    void setChannelGain(int channel, float gain)
+    {
+        channelGains[channel] = static_cast<int32_t>(std::lround(gain * (1 << 12)));
+    }
+
+    /// Scales a Q15 oscillator sample by its channel gain, the voice gain and a Q31 envelope level.
+    int32_t process(int channel, int32_t sample, int32_t envLevel) const
+    {
+        int32_t scaled = (sample * channelGains[channel]) >> 12; // Channel gain
+        scaled >>= 1;                                             // Voice gain of 0.5
+        return FixedPoint::saturateQ15(FixedPoint::mulQ15Q31(scaled, envLevel));
+    }
+
+private:
+    int32_t channelGains[3] = { 2048, 4915, 2048 }; // Q12 gains: 0.5, 1.2, 0.5
+};
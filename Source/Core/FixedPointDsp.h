@@ -0,0 +1,294 @@
+/*
+  ==============================================================================
+
+    FixedPointDsp.h
+    Created: 17 Oct 2026 4:12:08pm
+    Author:  70
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <vector>
+#include <algorithm>
+#include "FixedPoint.h"
+
+/**
+ * @class FixedBitcrusher
+ *
+ * @brief Fixed-point version of Bitcrusher, working on Q15 samples in the range -0.5~0.5.
+ *
+ * The quantization step and its inverse are computed in setBitDepth(), so processing a sample is two
+ * integer multiplies and two shifts.
+ */
+class FixedBitcrusher
+{
+public:
+    void setSampleRateReduction(int reductionFactor)
+    {
+        sampleRateReduction = std::max(1, reductionFactor);
+    }
+
+    void setBitDepth(int depth)
+    {
+        int newBitDepth = std::clamp(depth, 1, 24);
+        if (newBitDepth == bitDepth)
+            return;
+
+        bitDepth = newBitDepth;
+        levels= bitDepth >= 15 ? 0 : (1 << bitDepth) - 1; // 15 bits and above are transparent in Q15
+        if (levels > 0)
+            stepQ16 = (static_cast<int64_t>(FixedPoint::q15One) << 16) / levels;
+    }
+
+    int32_t process(int32_t inVal)
+    {
+        if (++currentSampleCount >= sampleRateReduction)
+        {
+            currentSampleCount = 0;
+
+            if (levels == 0)
+            {
+                lastProcessedSample = inVal;
+            }
+            else
+            {
+                int32_t fullScale = inVal * 2; // Map from -0.5~0.5 to -1~1
+                int32_t quantized = (fullScale * levels + (1 << 14)) >> 15; // Round to the nearest level
+                lastProcessedSample = static_cast<int32_t>((quantized * stepQ16) >> 16) / 2;
+            }
+        }
+        return lastProcessedSample;
+    }
+
+private:
+    int sampleRateReduction = 1;
+    int bitDepth = 24;
+    int32_t levels = 0;         // 2^bitDepth - 1, or 0 when no quantization is needed
+    int64_t stepQ16 = 0;        // Q15 size of one level, in 16.16 fixed point
+    int32_t lastProcessedSample = 0;
+    int currentSampleCount = 0;
+};
+
+/**
+ * @class FixedDelay
+ *
+ * @brief Fixed-point version of Delay, with a 48.16 delay time and linear interpolation.
+ */
+class FixedDelay
+{
+public:
+    void setSize(int _newSize)
+    {
+        size = std::max(1, _newSize);
+        buffer.assign(size, 0);
+        writePos = 0;
+    }
+
+    void setFeedback(float _feedback)
+    {
+        feedback = FixedPoint::floatToQ15(std::clamp(_feedback, 0.0f, 0.99f));
+    }
+
+    void setDelayTime(float _delayTimeinSamples)
+    {
+        float clamped = std::clamp(_delayTimeinSamples, 0.0f, static_cast<float>(size - 1));
+        delayTime = static_cast<int64_t>(static_cast<double>(clamped) * 65536.0);
+    }
+
+    void setDryWetMix(float _mix)
+    {
+        dryWetMix = FixedPoint::floatToQ15(std::clamp(_mix, 0.0f, 1.0f));
+    }
+
+    /// 0 truncates the delay time to whole samples, any other order interpolates linearly.
+    void setInterpolationOrder(int order)
+    {
+        interpolate = order > 0;
+    }
+
+    int32_t process(int32_t inVal)
+    {
+        if (delayTime == 0)
+            return inVal;
+
+        // A delay of D + f samples reads between (write - D - 1) and (write - D) at 1 - f
+        int delayInt = static_cast<int>(delayTime >> 16);
+        int32_t frac = interpolate ? static_cast<int32_t>(delayTime & 0xffff) : 0;
+        int indexA = writePos - delayInt - (frac > 0 ? 1 : 0);
+        if (indexA < 0)
+            indexA += size;
+        int indexB = indexA + 1 == size ? 0 : indexA + 1;
+        int32_t readFrac = frac > 0 ? 65536 - frac : 0;
+
+        int32_t valA = buffer[indexA];
+        int32_t valB = buffer[indexB];
+        int32_t outVal = valA + static_cast<int32_t>((static_cast<int64_t>(valB - valA) * readFrac) >> 16);
+
+        buffer[writePos] = inVal + FixedPoint::mulQ15(outVal, feedback);
+        if (++writePos >= size)
+            writePos = 0;
+
+        return FixedPoint::mulQ15(inVal, FixedPoint::q15One - dryWetMix) + FixedPoint::mulQ15(outVal, dryWetMix);
+    }
+
+    /// Saves or restores the running state, see StateArchive.h.
+    template <typename Archive>
+    void transferState(Archive& archive)
+    {
+        archive(buffer, size, writePos, delayTime, feedback, dryWetMix, interpolate);
+    }
+
+private:
+    std::vector<int32_t> buffer; // Q15 samples, 32 bits wide to keep feedback headroom
+    int size = 1;
+    int writePos = 0;
+    int64_t delayTime = 0;       // Delay in samples, 48.16, as buffers can be longer than 65535 samples
+    int32_t feedback = 0;        // Q15
+    int32_t dryWetMix = 6554;    // Q15, default 20% wet
+    bool interpolate = true;
+};
+
+/**
+ * @class FixedEnvelope
+ *
+ * @brief Linear ADSR in fixed point that follows the same stage logic as juce::ADSR.
+ *
+ * The level is kept as an unsigned value where 2^31 is full scale, so a rate can be added without
+ * overflowing before the end of the stage is detected.
+ */
+class FixedEnvelope
+{
+public:
+    struct Parameters
+    {
+        float attack = 0.1f, decay = 0.1f, sustain = 1.0f, release = 0.1f;
+    };
+
+    void setSampleRate(double newSampleRate)
+    {
+        sampleRate = newSampleRate;
+    }
+
+    void setParameters(const Parameters& newParameters)
+    {
+        parameters = newParameters;
+        sustainLevel = static_cast<uint32_t>(std::clamp(parameters.sustain, 0.0f, 1.0f) * fullScale);
+        attackRate = rateFor(fullScale, parameters.attack);
+        decayRate = rateFor(fullScale - sustainLevel, parameters.decay);
+    }
+
+    void reset()
+    {
+        level = 0;
+        state = State::idle;
+    }
+
+    void noteOn()
+    {
+        if (attackRate > 0)
+        {
+            state = State::attack;
+        }
+        else if (decayRate > 0)
+        {
+            level = fullScale;
+            state = State::decay;
+        }
+        else
+        {
+            level = sustainLevel;
+            state = State::sustain;
+        }
+    }
+
+    void noteOff()
+    {
+        if (state == State::idle)
+            return;
+
+        releaseRate = rateFor(level, parameters.release);
+        if (releaseRate > 0)
+            state = State::release;
+        else
+            reset();
+    }
+
+    /// Returns the next envelope level in Q31.
+    int32_t getNextSample()
+    {
+        switch (state)
+        {
+            case State::idle:
+                return 0;
+
+            case State::attack:
+                level += attackRate;
+                if (level >= fullScale)
+                {
+                    level = fullScale;
+                    state = decayRate > 0 ? State::decay : State::sustain;
+                    if (state == State::sustain)
+                        level = sustainLevel;
+                }
+                break;
+
+            case State::decay:
+                if (level <= sustainLevel + decayRate)
+                {
+                    level = sustainLevel;
+                    state = State::sustain;
+                }
+                else
+                {
+                    level -= decayRate;
+                }
+                break;
+
+            case State::sustain:
+                level = sustainLevel;
+                break;
+
+            case State::release:
+                if (level <= releaseRate)
+                    reset();
+                else
+                    level -= releaseRate;
+                break;
+        }
+        return level >= fullScale ? FixedPoint::q31Max : static_cast<int32_t>(level);
+    }
+
+    /// Returns the level given by the last getNextSample() call as a float, without advancing.
+    float getLevel() const
+    {
+        return static_cast<float>(level) / static_cast<float>(fullScale);
+    }
+
+    bool isActive() const
+    {
+        return state != State::idle;
+    }
+
+private:
+    enum class State { idle, attack, decay, sustain, release };
+
+    static constexpr uint32_t fullScale = 0x80000000u; // 1.0
+
+    State state = State::idle;
+    Parameters parameters;
+    double sampleRate = 44100.0;
+    uint32_t level = 0;
+    uint32_t sustainLevel = fullScale;
+    uint32_t attackRate = 0;
+    uint32_t decayRate = 0;
+    uint32_t releaseRate = 0;
+
+    /// Per-sample step to cover a distance in the given number of seconds, or 0 for an instant stage.
+    uint32_t rateFor(uint32_t distance, float seconds) const
+    {
+        if (seconds <= 0.0f || distance == 0)
+            return 0;
+        return std::max<uint32_t>(1, static_cast<uint32_t>(distance / (seconds * sampleRate)));
+    }
+};
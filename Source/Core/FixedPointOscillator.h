@@ -0,0 +1,229 @@
+/*
+  ==============================================================================
+
+    FixedPointOscillator.h
+    Created: 17 Oct 2026 3:31:40pm
+    Author:  70
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <algorithm>
+#include <vector>
+#include "FixedPoint.h"
+#include "ChiptuneRandom.h"
+
+/**
+ * @class FixedPhasor
+ *
+ * @brief Integer phase accumulator, the fixed-point counterpart of Phasor.
+ *
+ * The phase is a 32-bit unsigned value where 2^32 is one full cycle, so wrapping is free. The phase
+ * increment is only recalculated when the frequency changes, which costs one float multiply.
+ */
+class FixedPhasor
+{
+public:
+    virtual ~FixedPhasor() {}
+
+    void setSampleRate(float SR)
+    {
+        phaseScale = 4294967296.0 / SR;
+    }
+
+    void setFrequency(float Freq)
+    {
+        // Clamped below one cycle per sample, beyond which the increment does not fit in 32 bits
+        uint32_t newDelta = static_cast<uint32_t>(std::clamp(Freq * phaseScale, 0.0, 4294967295.0));
+        if (newDelta != phaseDelta)
+        {
+            phaseDelta = newDelta;
+            frequencyChanged();
+        }
+    }
+
+    /// Advances the phase and returns the Q15 output of the waveform.
+    int32_t process()
+    {
+        phase += phaseDelta;
+        return output(phase);
+    }
+
+    virtual int32_t output(uint32_t p)
+    {
+        return static_cast<int32_t>(p >> 17); // Plain ramp 0~1 in Q15
+    }
+
+    /// Saves or restores the running state, see StateArchive.h.
+    template <typename Archive>
+    void transferState(Archive& archive)
+    {
+        archive(phaseDelta, phaseScale, phase);
+    }
+
+protected:
+    uint32_t phaseDelta = 0; // Change in phase per sample, 2^32 = one cycle
+
+    /// Called when the phase increment changes, so derived classes can update cached values.
+    virtual void frequencyChanged() {}
+
+private:
+    double phaseScale = 4294967296.0 / 44100.0; // Phase increment per Hz
+    uint32_t phase = 0;                        // Current phase
+};
+
+/**
+ * @class FixedSquareOsc
+ *
+ * @brief Fixed-point pulse oscillator with PolyBLEP correction, matching SquareOsc.
+ *
+ * The PolyBLEP needs t / dt near the discontinuities. Instead of dividing every sample, a reciprocal of
+ * the phase increment is cached when the frequency changes; because t < dt in the correction region,
+ * the product t * (2^47 / dt) always fits in 64 bits.
+ */
+class FixedSquareOsc : public FixedPhasor
+{
+public:
+    int32_t output(uint32_t p) override
+    {
+        int32_t outVal = (p < pulseWidth) ? FixedPoint::q15One : -FixedPoint::q15One;
+        if (! bandLimited)
+            return outVal;
+
+        outVal += polyBlep(p);
+        outVal -= polyBlep(p - pulseWidth); // Same as fmod(p + (1 - pulseWidth), 1) with wrapping phase
+        return outVal;
+    }
+
+    void setPulseWidth(float pw)
+    {
+        pulseWidth = static_cast<uint32_t>(static_cast<double>(pw) * 4294967296.0);
+    }
+
+    /// Enables the PolyBLEP correction, as SquareOsc::setBandLimited().
+    void setBandLimited(bool shouldBeBandLimited)
+    {
+        bandLimited = shouldBeBandLimited;
+    }
+
+    /// Saves or restores the running state, see StateArchive.h.
+    template <typename Archive>
+    void transferState(Archive& archive)
+    {
+        FixedPhasor::transferState(archive);
+        archive(pulseWidth, dtReciprocal, bandLimited);
+    }
+
+protected:
+    void frequencyChanged() override
+    {
+        dtReciprocal = phaseDelta > 0 ? (uint64_t(1) << 47) / phaseDelta : 0;
+    }
+
+private:
+    uint32_t pulseWidth = 0x80000000u; // Pulse width as a phase, default 50%
+    uint64_t dtReciprocal = 0;         // 2^47 / phaseDelta
+    bool bandLimited = true;
+
+    /// PolyBLEP correction in Q15 for a phase t.
+    int32_t polyBlep(uint32_t t) const
+    {
+        if (t < phaseDelta)
+        {
+            // Close to zero: x = t / dt
+            int32_t x = static_cast<int32_t>((static_cast<uint64_t>(t) * dtReciprocal) >> 32);
+            return x + x - FixedPoint::mulQ15(x, x) - FixedPoint::q15One;
+        }
+        if (t > ~phaseDelta)
+        {
+            // Close to one: x = (t - 1) / dt, negative
+            uint32_t distance = 0u - t; // 1 - t
+            int32_t x = -static_cast<int32_t>((static_cast<uint64_t>(distance) * dtReciprocal) >> 32);
+            return FixedPoint::mulQ15(x, x) + x + x + FixedPoint::q15One;
+        }
+        return 0;
+    }
+};
+
+/**
+ * @class FixedTriOsc
+ *
+ * @brief Fixed-point version of TriOsc: linear rise, quadratic fall, output range -0.5~0.5.
+ */
+class FixedTriOsc : public FixedPhasor
+{
+public:
+    int32_t output(uint32_t p) override
+    {
+        if (p < 0x80000000u)
+        {
+            // Linear rise: 2p - 0.5
+            return static_cast<int32_t>(p >> 16) - (FixedPoint::q15One / 2);
+        }
+
+        // Curved fall: 0.5 - t^2, with t going from 0 to 1 over the second half
+        int32_t t = static_cast<int32_t>((p - 0x80000000u) >> 16);
+        return (FixedPoint::q15One / 2) - FixedPoint::mulQ15(t, t);
+    }
+};
+
+/**
+ * @class FixedNoise
+ *
+ * @brief Fixed-point version of Noise, reading the 4-bit wavetable with a 16.16 phase.
+ */
+class FixedNoise
+{
+public:
+    FixedNoise()
+    {
+        waveTable.resize(wtSize);
+        setSeed(0);
+    }
+
+    /// Refills the wavetable with the same sequence as Noise::setSeed, in Q15.
+    void setSeed(uint64_t seed)
+    {
+        ChiptuneRandom random(seed);
+        for (int i = 0; i < wtSize; ++i)
+            waveTable[i] = (random.nextInt(16) - 8) * (FixedPoint::q15One / 8);
+    }
+
+    void setSampleRate(float newSampleRate)
+    {
+        incrementScale = wtSize * 65536.0 / newSampleRate;
+    }
+
+    void setFrequency(float freq)
+    {
+        increment = static_cast<uint32_t>(freq * incrementScale);
+    }
+
+    int32_t process()
+    {
+        int32_t output = waveTable[phase >> 16];
+
+        phase += increment;
+        while (phase >= wrapPhase)
+            phase -= wrapPhase;
+
+        return output;
+    }
+
+    /// Saves or restores the running state, see StateArchive.h.
+    template <typename Archive>
+    void transferState(Archive& archive)
+    {
+        archive(waveTable, incrementScale, increment, phase);
+    }
+
+private:
+    static constexpr int wtSize = 3000;
+    static constexpr uint32_t wrapPhase = static_cast<uint32_t>(wtSize) << 16;
+
+    std::vector<int32_t> waveTable;                 // Q15 samples
+    double incrementScale = wtSize * 65536.0 / 44100.0; // Phase increment per Hz, 16.16
+    uint32_t increment = 0;
+    uint32_t phase = 0;
+};
@@ -0,0 +1,134 @@
+/*
+  ==============================================================================
+
+    KeyZoneMap.h
+    Created: 17 Oct 2026 10:41:37am
+    Author:  70
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <algorithm>
+#include <array>
+#include <string>
+#include <vector>
+#include "ChiptuneParameters.h"
+
+/**
+ * @class KeyZoneMap
+ *
+ * @brief Maps MIDI keys or key ranges to their own parameter snapshot (key-split / drum-kit mode).
+ *
+ * Each zone covers a range of MIDI notes and holds a complete ChiptuneParameters snapshot, for example
+ * the "Noise Hihat" preset on one key and the "Noise Snare" preset on the next. A 128-entry lookup
+ * table is rebuilt whenever the zones change, so resolving the zone of a note at note-on is a single
+ * array read. Notes that are not covered by any zone keep using the live plugin parameters.
+ *
+ * A zone snapshot only drives the voice parameters: oscillator, PWM, unison, pitch bend, vibrato,
+ * arpeggiator and envelope. The bitcrusher, delay and mixer process the sum of all voices, so they keep
+ * following the global parameters whichever zones are sounding.
+ *
+ * The map is read by the voices on the audio thread, so it must only change while the engine is not
+ * rendering. To keep that window short, build the new map on the message thread and swap() it in
+ * (in the plugin, while holding the processor's callback lock); the swap neither allocates nor frees.
+ */
+class KeyZoneMap
+{
+public:
+    /// A single zone: a range of MIDI notes sharing one parameter snapshot.
+    struct Zone
+    {
+        std::string name;              // Display name, e.g. the preset the zone was loaded from.
+        int lowNote = 0;               // Lowest MIDI note of the zone (inclusive).
+        int highNote = 127;            // Highest MIDI note of the zone (inclusive).
+        ChiptuneParameters parameters; // Parameter snapshot played by this zone.
+    };
+
+    /// Constructs an empty map, where every note plays the live parameters.
+    KeyZoneMap()
+    {
+        noteToZone.fill(-1);
+    }
+
+    /// Removes all zones.
+    void clear()
+    {
+        zones.clear();
+        noteToZone.fill(-1);
+    }
+
+    /**
+     * @brief Adds a zone covering lowNote to highNote (inclusive).
+     *
+     * If the new zone overlaps existing ones, the most recently added zone wins for the shared notes.
+     *
+     * @return The index of the new zone.
+     */
+    int addZone(int lowNote, int highNote, const ChiptuneParameters& parameters, const std::string& name = {})
+    {
+        Zone zone;
+        zone.name = name;
+        zone.lowNote = std::clamp(std::min(lowNote, highNote), 0, 127);
+        zone.highNote = std::clamp(std::max(lowNote, highNote), 0, 127);
+        zone.parameters = parameters;
+        zones.push_back(zone);
+
+        rebuildLookupTable();
+        return static_cast<int>(zones.size()) - 1;
+    }
+
+    /// Exchanges the zones of the two maps without allocating.
+    void swap(KeyZoneMap& other) noexcept
+    {
+        zones.swap(other.zones);
+        std::swap(noteToZone, other.noteToZone);
+    }
+
+    /// Removes the zone at the given index.
+    void removeZone(int index)
+    {
+        if (index >= 0 && index < getNumZones())
+        {
+            zones.erase(zones.begin() + index);
+            rebuildLookupTable();
+        }
+    }
+
+    /// Returns the number of zones.
+    int getNumZones() const
+    {
+        return static_cast<int>(zones.size());
+    }
+
+    /// Returns the zone at the given index.
+    const Zone& getZone(int index) const
+    {
+        return zones[index];
+    }
+
+    /// Returns the parameter snapshot for a MIDI note, or nullptr if the note is not mapped to any zone.
+    const ChiptuneParameters* getParametersForNote(int midiNoteNumber) const
+    {
+        if (midiNoteNumber < 0 || midiNoteNumber >= 128)
+            return nullptr;
+
+        int zoneIndex = noteToZone[midiNoteNumber];
+        return zoneIndex >= 0 ? &zones[zoneIndex].parameters : nullptr;
+    }
+
+private:
+    std::vector<Zone> zones;          // All zones, in the order they were added.
+    std::array<int, 128> noteToZone;  // Zone index for every MIDI note, -1 if unmapped.
+
+    /// Recomputes the note-to-zone table. Later zones take priority over earlier ones.
+    void rebuildLookupTable()
+    {
+        noteToZone.fill(-1);
+        for (int z = 0; z < getNumZones(); ++z)
+        {
+            for (int note = zones[z].lowNote; note <= zones[z].highNote; ++note)
+                noteToZone[note] = z;
+        }
+    }
+};
@@ -0,0 +1,69 @@
+/*
+  ==============================================================================
+
+    LinearSmoothedValue.h
+    Created: 18 Oct 2026 9:58:40am
+    Author:  70
+
+  ==============================================================================
+*/
+
+#pragma once
+
+/**
+ * @class LinearSmoothedValue
+ *
+ * @brief Ramps linearly towards a target value over a fixed time, like juce::SmoothedValue.
+ */
+class LinearSmoothedValue
+{
+public:
+    /// Sets the sample rate and the ramp length in seconds, and jumps to the target value.
+    void reset(double sampleRate, double rampLengthInSeconds)
+    {
+        stepsToTarget = static_cast<int>(rampLengthInSeconds * sampleRate);
+        setCurrentAndTargetValue(target);
+    }
+
+    /// Jumps straight to a value, without ramping.
+    void setCurrentAndTargetValue(float newValue)
+    {
+        target = current = newValue;
+        countdown = 0;
+    }
+
+    /// Starts a ramp from the current value to a new target, if the target changed.
+    void setTargetValue(float newValue)
+    {
+        if (newValue == target)
+            return;
+
+        if (stepsToTarget <= 0)
+        {
+            setCurrentAndTargetValue(newValue);
+            return;
+        }
+
+        target = newValue;
+        countdown = stepsToTarget;
+        step = (target - current) / static_cast<float>(countdown);
+    }
+
+    /// Returns the next smoothed value.
+    float getNextValue()
+    {
+        if (countdown <= 0)
+            return target;
+
+        --countdown;
+        current = countdown > 0 ? current + step : target;
+        return current;
+    }
+
+private:
+    float current = 0.0f;  // Current value of the ramp
+    float target = 0.0f;   // Value the ramp is heading to
+    float step = 0.0f;     // Change per sample
+    int countdown = 0;     // Samples left in the ramp
+    int stepsToTarget = 0; // Ramp length in samples
+};
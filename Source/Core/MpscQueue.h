@@ -0,0 +1,103 @@
+/*
+  ==============================================================================
+
+    MpscQueue.h
+    Created: 28 Oct 2026 2:26:51pm
+    Author:  70
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @class MpscQueue
+ *
+ * @brief Bounded FIFO from any number of producer threads to one consumer thread, without locks.
+ *
+ * Every slot carries a sequence number telling whose turn it is: producers claim a slot by advancing
+ * the shared write position with a compare-and-swap, fill it, and then hand it over by bumping its
+ * sequence, which is what the consumer waits for. A producer that is preempted mid-push only holds
+ * back the items behind its own, and the consumer finds them at its next pop() instead of waiting.
+ * A full queue makes push() fail. The slots are allocated by the constructor, so T should be a plain
+ * fixed-size structure.
+ */
+template <typename T>
+class MpscQueue
+{
+public:
+    /// Constructs a queue holding at least capacity items, rounded up to a power of two. Allocates.
+    explicit MpscQueue(size_t capacity)
+    {
+        size_t size = 1;
+        while (size < capacity)
+            size *= 2;
+        slots = std::vector<Slot>(size);
+        clear();
+    }
+
+    /// Any thread: appends an item. Returns false if the queue is full.
+    bool push(const T& item)
+    {
+        size_t position = writePosition.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            auto& slot = slots[position & (slots.size() - 1)];
+            auto difference = static_cast<intptr_t>(slot.sequence.load(std::memory_order_acquire)) - static_cast<intptr_t>(position);
+            if (difference == 0)
+            {
+                if (writePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                {
+                    slot.item = item;
+                    slot.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (difference < 0)
+            {
+                return false; // The consumer has not freed this slot yet
+            }
+            else
+            {
+                position = writePosition.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /// Consumer: takes the oldest item. Returns false if the queue is empty, or its oldest item is still being written.
+    bool pop(T& item)
+    {
+        auto& slot = slots[readPosition & (slots.size() - 1)];
+        if (slot.sequence.load(std::memory_order_acquire) != readPosition + 1)
+            return false;
+
+        item = slot.item;
+        slot.sequence.store(readPosition + slots.size(), std::memory_order_release);
+        ++readPosition;
+        return true;
+    }
+
+    /// Empties the queue. Not thread safe: call it while no thread is using the queue.
+    void clear()
+    {
+        for (size_t i = 0; i < slots.size(); ++i)
+            slots[i].sequence.store(i);
+        writePosition.store(0);
+        readPosition = 0;
+    }
+
+private:
+    struct Slot
+    {
+        std::atomic<size_t> sequence { 0 }; // Position the slot is free for, or that position + 1 once it is filled
+        T item {};
+    };
+
+    std::vector<Slot> slots;
+    std::atomic<size_t> writePosition { 0 }; // Shared by the producers
+    size_t readPosition = 0;                 // Owned by the consumer
+};
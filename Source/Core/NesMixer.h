@@ -0,0 +1,222 @@
+/*
+  ==============================================================================
+
+    NesMixer.h
+    Created: 24 Oct 2026 10:14:36am
+    Author:  70
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "SimdLanes.h"
+
+/**
+ * @class NesMixer
+ *
+ * @brief Mixes the pulse, triangle and noise buses the way the 2A03 does, followed by its output filters.
+ *
+ * The chip does not add its channels: the two pulses share one DAC and the triangle, noise and DMC
+ * another, and both compress as their level rises. Their curves are the usual approximations
+ *
+ *     pulse_out = 95.52 / (8128 / (pulse1 + pulse2) + 100)
+ *     tnd_out   = 163.67 / (24329 / (3 * triangle + 2 * noise + dmc) + 100)
+ *
+ * with every channel level in 0~15 (0~127 for the DMC, which this synth leaves at 0). Both curves are
+ * precomputed in tables with subStepsPerLevel entries per channel level, so mixing a sample is one
+ * lookup per DAC.
+ *
+ * The voices are bipolar, so a bus maps onto the levels around the middle of its DAC: one voice at full
+ * scale spans the 16 levels of one channel, and polyphony beyond what the chip has saturates at the
+ * ends of the curve. The output is scaled so that a quiet pulse passes at unity gain, which leaves the
+ * balance between the two DACs as on the hardware.
+ *
+ * The output then goes through the filters of the console: high-pass at 90 Hz and 440 Hz, low-pass at
+ * 14 kHz, all first order. They run as a cascade of two biquads, with the channels side by side in
+ * FloatLanes so both are filtered at once.
+ */
+class NesMixer
+{
+public:
+    /// The inputs of the mixer, one bus per oscillator type.
+    enum Bus { pulseBus = 0, triangleBus, noiseBus, numBuses };
+
+    static constexpr int maxChannels = FloatLanes::size;
+    static constexpr int subStepsPerLevel = 16;
+
+    /// Full-scale amplitude of a single voice of each type on its bus, as rendered by ChiptuneVoice.
+    static constexpr float pulseFullScale = 0.25f;
+    static constexpr float triangleFullScale = 0.3f;
+    static constexpr float noiseFullScale = 0.25f;
+
+    NesMixer()
+    {
+        pulseTable.resize(30 * subStepsPerLevel + 1);
+        for (size_t i = 0; i < pulseTable.size(); ++i)
+            pulseTable[i] = pulseCurve(static_cast<double>(i) / subStepsPerLevel);
+
+        tndTable.resize(202 * subStepsPerLevel + 1);
+        for (size_t i = 0; i < tndTable.size(); ++i)
+            tndTable[i] = tndCurve(static_cast<double>(i) / subStepsPerLevel);
+
+        // Unity gain for small signals around the middle of the pulse DAC
+        const double delta = 1.0 / 1024.0;
+        double slope = (pulseCurve(pulseCentre + delta) - pulseCurve(pulseCentre - delta)) / (2.0 * delta);
+        auto outputGain = static_cast<float>(1.0 / (slope * pulseLevelsPerUnit));
+        for (auto& value : pulseTable)
+            value *= outputGain;
+        for (auto& value : tndTable)
+            value *= outputGain;
+        restingOutput = pulseTable[tableIndex(pulseCentre, pulseTable)] + tndTable[tableIndex(tndCentre, tndTable)];
+
+        setSampleRate(sampleRate);
+    }
+
+    /// Computes the filter coefficients for the sample rate, and clears the filters.
+    void setSampleRate(double newSampleRate)
+    {
+        sampleRate = newSampleRate;
+        highPass.setFirstOrderPair(highPassCoefficients(90.0), highPassCoefficients(440.0));
+        lowPass.setFirstOrder(lowPassCoefficients(14000.0));
+        reset();
+    }
+
+    /// Clears the filters, e.g. when the mixer is switched back on.
+    void reset()
+    {
+        highPass.reset();
+        lowPass.reset();
+    }
+
+    /**
+     * @brief Mixes the buses into the outputs, overwriting them.
+     *
+     * @param buses        for each Bus, an array of numChannels channel pointers
+     * @param outputs      array of channel pointers
+     * @param numChannels  number of channels, at most maxChannels
+     * @param numSamples   number of samples to mix
+     */
+    void process(float* const* const* buses, float* const* outputs, int numChannels, int numSamples)
+    {
+        alignas(16) float frame[maxChannels] = {};
+        for (int i = 0; i < numSamples; ++i)
+        {
+            for (int chan = 0; chan < numChannels; ++chan)
+            {
+                float pulseLevel = pulseCentre + pulseLevelsPerUnit * buses[pulseBus][chan][i];
+                float tndLevel = tndCentre + triangleLevelsPerUnit * buses[triangleBus][chan][i]
+                                           + noiseLevelsPerUnit * buses[noiseBus][chan][i];
+                frame[chan] = pulseTable[tableIndex(pulseLevel, pulseTable)]
+                            + tndTable[tableIndex(tndLevel, tndTable)] - restingOutput;
+            }
+
+            FloatLanes mixed = lowPass.process(highPass.process(FloatLanes::load(frame)));
+            mixed.store(frame);
+            for (int chan = 0; chan < numChannels; ++chan)
+                outputs[chan][i] = frame[chan];
+        }
+    }
+
+    /// Saves or restores the running state, see StateArchive.h. The DAC tables are the same in every
+    /// instance and the sample rate is set by the engine, so neither is archived.
+    template <typename Archive>
+    void transferState(Archive& archive)
+    {
+        archive(restingOutput, highPass, lowPass);
+    }
+
+private:
+    /// One biquad in transposed direct form II, on every lane at once.
+    struct Biquad
+    {
+        struct FirstOrder { double b0, b1, a1; };
+
+        FloatLanes b0 {}, b1 {}, b2 {}, a1 {}, a2 {}; // Coefficients, zero until set()
+        FloatLanes s1 {}, s2 {};                     // Filter state, cleared by reset()
+
+        void setFirstOrder(FirstOrder f)
+        {
+            set(f.b0, f.b1, 0.0, f.a1, 0.0);
+        }
+
+        /// Sets the product of two first-order sections.
+        void setFirstOrderPair(FirstOrder f, FirstOrder g)
+        {
+            set(f.b0 * g.b0, f.b0 * g.b1 + f.b1 * g.b0, f.b1 * g.b1, f.a1 + g.a1, f.a1 * g.a1);
+        }
+
+        void set(double nb0, double nb1, double nb2, double na1, double na2)
+        {
+            b0 = FloatLanes::broadcast(static_cast<float>(nb0));
+            b1 = FloatLanes::broadcast(static_cast<float>(nb1));
+            b2 = FloatLanes::broadcast(static_cast<float>(nb2));
+            a1 = FloatLanes::broadcast(static_cast<float>(na1));
+            a2 = FloatLanes::broadcast(static_cast<float>(na2));
+        }
+
+        void reset()
+        {
+            s1 = s2 = FloatLanes::broadcast(0.0f);
+        }
+
+        FloatLanes process(FloatLanes x)
+        {
+            FloatLanes y = b0 * x + s1;
+            s1 = b1 * x - a1 * y + s2;
+            s2 = b2 * x - a2 * y;
+            return y;
+        }
+    };
+
+    // The middle of each DAC, and how many channel levels one unit of a bus moves it
+    static constexpr float pulseCentre = 15.0f;                   // pulse1 + pulse2 = 7.5 + 7.5
+    static constexpr float tndCentre = 3.0f * 7.5f + 2.0f * 7.5f; // 3 * triangle + 2 * noise
+    static constexpr float pulseLevelsPerUnit = 15.0f / (2.0f * pulseFullScale);
+    static constexpr float triangleLevelsPerUnit = 3.0f * 15.0f / (2.0f * triangleFullScale);
+    static constexpr float noiseLevelsPerUnit = 2.0f * 15.0f / (2.0f * noiseFullScale);
+
+    std::vector<float> pulseTable; // pulse_out for pulse1 + pulse2 = 0~30, scaled by outputGain
+    std::vector<float> tndTable;   // tnd_out for 3 * triangle + 2 * noise + dmc = 0~202, scaled by outputGain
+    float restingOutput = 0.0f;    // Output when every bus is silent, removed from the mix
+    double sampleRate = 44100.0;
+    Biquad highPass;               // 90 Hz and 440 Hz high-pass
+    Biquad lowPass;                // 14 kHz low-pass
+
+    static double pulseCurve(double level)
+    {
+        return level <= 0.0 ? 0.0 : 95.52 / (8128.0 / level + 100.0);
+    }
+
+    static double tndCurve(double level)
+    {
+        return level <= 0.0 ? 0.0 : 163.67 / (24329.0 / level + 100.0);
+    }
+
+    /// Returns the entry nearest to a level, clamped to the table.
+    static int tableIndex(float level, const std::vector<float>& table)
+    {
+        int index = static_cast<int>(level * subStepsPerLevel + 0.5f);
+        return std::clamp(index, 0, static_cast<int>(table.size()) - 1);
+    }
+
+    static constexpr double pi = 3.14159265358979323846;
+
+    /// Bilinear transform of a first-order high-pass.
+    Biquad::FirstOrder highPassCoefficients(double cutoff) const
+    {
+        double k = std::tan(pi * std::min(cutoff, 0.45 * sampleRate) / sampleRate);
+        double b0 = 1.0 / (1.0 + k);
+        return { b0, -b0, (k - 1.0) / (k + 1.0) };
+    }
+
+    /// Bilinear transform of a first-order low-pass.
+    Biquad::FirstOrder lowPassCoefficients(double cutoff) const
+    {
+        double k = std::tan(pi * std::min(cutoff, 0.45 * sampleRate) / sampleRate);
+        double b0 = k / (1.0 + k);
+        return { b0, b0, (k - 1.0) / (k + 1.0) };
+    }
+};
@@ -0,0 +1,26 @@
+/*
+  ==============================================================================
+
+    Pitch.h
+    Created: 18 Oct 2026 9:47:15am
+    Author:  70
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <cmath>
+
+/**
+ * @class Pitch
+ *
+ * @brief Pitch conversion helpers shared by the voice and the pitch modulation modules.
+ */
+struct Pitch
+{
+    /// Converts a MIDI note number to a frequency in Hz, with A4 (note 69) at 440 Hz.
+    static double midiNoteToHertz(double midiNoteNumber)
+    {
+        return 440.0 * std::pow(2.0, (midiNoteNumber - 69.0) / 12.0);
+    }
+};
@@ -0,0 +1,145 @@
+/*
+  ==============================================================================
+
+    PitchBend.h
+    Created: 27 Apr 2024 12:48:18pm
+    Author:  70
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <vector>
+#include <cmath>
+#include "ChiptuneParameters.h"
+#include "Pitch.h"
+
+/**
+ * @class PitchBend
+ *
+ * @brief Handles pitch bending effects using MIDI note frequencies.
+ *
+ * This class manipulates pitch based on MIDI inputs, changing frequencies over a specified time interval,
+ * controlled via parameters stored in a ChiptuneParameters snapshot.
+ *
+ * Bends glide in log-frequency, so a bend of a given number of semitones sounds the same anywhere on the
+ * keyboard. The ratio between two consecutive samples is computed once per glide, which leaves one
+ * multiply per sample. Notes can bend in from an initial pitch at note-on, and bend out to an end pitch
+ * when they are released. A glide of zero length jumps straight to its target.
+ *
+ * The release bend is off while the end pitch is 0, so a note released during its bend-in keeps gliding
+ * to its own pitch. Otherwise the release glide starts from wherever the bend-in had got to.
+ */
+class PitchBend
+{
+public:
+    /// Constructor that initializes the reference to the voice's parameter snapshot.
+    PitchBend(const ChiptuneParameters& params)
+    : params(params){}
+    
+    /// Sets the sample rate and recalculates the number of samples over which to apply the pitch bend.
+    void setSampleRate(double _sampleRate)
+    {
+        sampleRate = _sampleRate;
+        calculateBendSamples();
+    }
+
+    /// Starts the pitch bending process from the initial note derived from settings, gradually bending to the input MIDI note.
+    void startPitchBend(int _inputNote)
+    {
+        inputNote = _inputNote; // Store the input MIDI note
+        initNote = updateInitPitch(); // Get the initial pitch offset from the parameters
+        currentFreq = Pitch::midiNoteToHertz(inputNote + initNote); // Start from the initial frequency
+        
+        glideTo(Pitch::midiNoteToHertz(inputNote), bendSamples);
+    }
+    
+    /// Starts bending from the current frequency to the end pitch, when the note is released. Does nothing if the end pitch is 0.
+    void releasePitchBend()
+    {
+        if (updateEndPitch() == 0)
+            return; // No release bend: leave the bend-in running rather than cutting it short
+        
+        int endSamples = static_cast<int>(updateEndTime() * sampleRate);
+        glideTo(Pitch::midiNoteToHertz(inputNote + updateEndPitch()), endSamples);
+    }
+    
+    /// Processes one sample of the pitch bend effect, gradually changing frequency towards the target.
+    float process()
+    {
+        currentFreq *= ratio;
+        if (remainingSamples > 0 && --remainingSamples == 0)
+        {
+            currentFreq = targetFreq; // Finalize at target frequency, without the rounding errors of the products
+            ratio = 1.0;
+        }
+        return static_cast<float>(currentFreq);
+    }
+    
+    
+    /// Saves or restores the running state, see StateArchive.h.
+    template <typename Archive>
+    void transferState(Archive& archive)
+    {
+        archive(inputNote, initNote, currentFreq, targetFreq, ratio, remainingSamples, bendSamples, sampleRate);
+    }
+
+private:
+    int inputNote = 0;           // MIDI note number of the input note.
+    int initNote = 0;            // Initial MIDI note number to start bending from.
+    double currentFreq = 0.0;    // Current frequency during the pitch bend process.
+    double targetFreq = 0.0;     // Frequency the current glide ends on.
+    double ratio = 1.0;          // Frequency ratio between two consecutive samples of the glide.
+    int remainingSamples = 0;    // Samples left in the current glide.
+    int bendSamples = 0;         // Total number of samples over which to spread the pitch bend.
+    double sampleRate = 44100.0; // Default sample rate, should be set to match the host environment.
+    
+    
+    const ChiptuneParameters& params; // Reference to all controllable parameters.
+    
+    /// Glides from the current frequency to a target, in log-frequency. Zero samples jumps to the target.
+    void glideTo(double newTargetFreq, int numSamples)
+    {
+        targetFreq = newTargetFreq;
+        if (numSamples <= 0 || currentFreq <= 0.0)
+        {
+            currentFreq = targetFreq;
+            ratio = 1.0;
+            remainingSamples = 0;
+            return;
+        }
+        
+        ratio = std::pow(targetFreq / currentFreq, 1.0 / numSamples);
+        remainingSamples = numSamples;
+    }
+    
+    /// Retrieves the initial pitch bend setting from the parameters.
+    int updateInitPitch()
+    {
+        return params.get(ChiptuneParameters::pbInitPitch);
+    }
+    
+    /// Retrieves the time over which the pitch bend should occur.
+    float updateTime()
+    {
+        return params.get(ChiptuneParameters::pbTime);
+    }
+    
+    /// Retrieves the pitch, relative to the input note, that released notes bend to.
+    int updateEndPitch()
+    {
+        return params.get(ChiptuneParameters::pbEndPitch);
+    }
+    
+    /// Retrieves the time over which released notes bend to the end pitch.
+    float updateEndTime()
+    {
+        return params.get(ChiptuneParameters::pbEndTime);
+    }
+    
+    /// Calculates the number of samples over the specified bend time.
+    void calculateBendSamples()
+    {
+        bendSamples = static_cast<int>(updateTime() * sampleRate);
+    }
+};
@@ -0,0 +1,267 @@
+/*
+  ==============================================================================
+
+    PolyBLEPOscillator.h
+    Created: 27 Apr 2024 6:11:46pm
+    Author:  70
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <cmath>
+#include "SimdLanes.h"
+
+/**
+ * @class Phasor
+ *
+ * @brief Implements the foundational components of an oscillator used in audio synthesis.
+ *
+ * This class manages the phase of an oscillator, enabling the generation of various waveforms by deriving classes.
+ * It offers functionality to set and retrieve the oscillator's frequency and sample rate, and calculates the phase increment
+ * necessary for generating continuous waveforms. The class also includes a PolyBLEP function to minimize aliasing,
+ * improving the quality of the output waveforms especially at higher frequencies.
+ */
+class Phasor 
+{
+public:
+    virtual ~Phasor() {} // Virtual destructor
+    
+    float getPhase()
+    {
+        updatePhase(); // Update the phase before returning it
+        return phase;
+    }
+    
+    float process()
+    {
+        updatePhase();
+        return output(phase);
+    }
+    
+    /// Returns the phase without advancing it.
+    float getCurrentPhase() const
+    {
+        return phase;
+    }
+    
+    /// Jumps to a phase between 0 and 1.
+    void setPhase(float newPhase)
+    {
+        phase = newPhase;
+    }
+    
+    virtual float output(float p)
+    {
+        return p;
+    }
+    
+    void setSampleRate(float SR)
+    {
+        sampleRate = SR;
+    }
+
+    void setFrequency(float Freq)
+    {
+        frequency = Freq;
+        phaseDelta = frequency / sampleRate;
+    }
+    
+    float getPhaseDelta()
+    {
+        return phaseDelta;
+    }
+    
+    /// Returns a phase advanced by phaseDelta and wrapped around at 1.0, for the loops that keep the phase in a register.
+    static float advance(float phase, float phaseDelta)
+    {
+        phase += phaseDelta;
+        if (phase > 1.0f)
+            phase -= 1.0f;
+        return phase;
+    }
+    
+    /// PolyBLEP function to reduce aliasing in waveform generation
+    float poly_blep(float t)
+    {
+        float dt = phaseDelta;
+        if (t < dt) 
+        {
+            // Close to zero
+            t /= dt;
+            return t+t - t*t - 1.0;
+        } else if (t > 1.0f - dt) {
+            // Close to 1
+            t = (t - 1.0) / dt;
+            return t*t + t+t + 1.0;
+        }
+        
+        // No correction needed elsewhere
+        return 0.0;
+    }
+    
+    /// Branchless PolyBLEP on four phases, same curve as poly_blep(), for the oscillators that render with FloatLanes.
+    static FloatLanes poly_blep(FloatLanes t, FloatLanes dt, FloatLanes inverseDt, FloatLanes one)
+    {
+        FloatLanes a = t * inverseDt;
+        FloatLanes b = (t - one) * inverseDt;
+        FloatLanes start = a + a - a * a - one;
+        FloatLanes end = b * b + b + b + one;
+        FloatLanes zero = one - one;
+        FloatLanes tail = FloatLanes::select(FloatLanes::greaterThan(t, one - dt), end, zero);
+        return FloatLanes::select(FloatLanes::lessThan(t, dt), start, tail);
+    }
+
+    /// Saves or restores the running state, see StateArchive.h.
+    template <typename Archive>
+    void transferState(Archive& archive)
+    {
+        archive(frequency, sampleRate, phase, phaseDelta);
+    }
+    
+private:
+    float frequency = 0.0f;       // Frequency of the oscillator
+    float sampleRate = 44100.0f;  // samples per sec
+    float phase = 0.0f;           // Current phase of the oscillator
+    float phaseDelta = 0.0f;      // Change in phase per sample
+    
+    /// Updates the phase, wrapping around at 1.0
+    void updatePhase()
+    {
+        phase = advance(phase, phaseDelta);
+    }
+
+};
+// ==================================
+
+/// Sine wave oscillator derived from Phasor
+class SinOsc: public Phasor
+{
+    float output(float p)override
+    {
+        return std::sin(p * 6.283185307179586);
+    }
+};
+
+/// Square wave oscillator with PolyBLEP function derived from Phasor
+class SquareOsc: public Phasor
+{
+public:
+
+    float output(float p) override
+    {
+        float outVal = (p < pulseWidth) ? 1.0f : -1.0f;
+        if (! bandLimited)
+            return outVal;
+        
+        outVal += poly_blep(p);
+        float q = p + (1.0f - pulseWidth); // Phase relative to the falling edge
+        if (q >= 1.0f)
+            q -= 1.0f;
+        outVal -= poly_blep(q);
+        return outVal; 
+    }
+    
+    /**
+     * @brief Renders numSamples of the pulse at the current frequency, scaled by gain.
+     *
+     * The width of each sample is read from widths, so that a modulated width costs no more than a fixed
+     * one. The phases are accumulated first, then turned into samples four at a time with FloatLanes and
+     * no branches. dest and widths must be aligned for FloatLanes::load().
+     */
+    void render(float* dest, const float* widths, int numSamples, float gain)
+    {
+        if (numSamples <= 0)
+            return;
+        
+        float p = getCurrentPhase();
+        float dt = getPhaseDelta();
+        for (int i = 0; i < numSamples; ++i)
+        {
+            p = advance(p, dt);
+            dest[i] = p;
+        }
+        setPhase(p);
+        
+        const FloatLanes one = FloatLanes::broadcast(1.0f);
+        const FloatLanes zero = FloatLanes::broadcast(0.0f);
+        const FloatLanes delta = FloatLanes::broadcast(dt);
+        const FloatLanes inverseDelta = FloatLanes::broadcast(1.0f / dt);
+        const FloatLanes correction = FloatLanes::broadcast(bandLimited ? 1.0f : 0.0f);
+        const FloatLanes scale = FloatLanes::broadcast(gain);
+        int i = 0;
+        for (; i + FloatLanes::size <= numSamples; i += FloatLanes::size)
+        {
+            FloatLanes phases = FloatLanes::load(dest + i);
+            FloatLanes width = FloatLanes::load(widths + i);
+            FloatLanes fall = phases + (one - width);
+            fall = fall - FloatLanes::select(FloatLanes::lessThan(fall, one), zero, one);
+            FloatLanes naive = FloatLanes::select(FloatLanes::lessThan(phases, width), one, zero - one);
+            FloatLanes blep = poly_blep(phases, delta, inverseDelta, one) - poly_blep(fall, delta, inverseDelta, one);
+            ((naive + correction * blep) * scale).store(dest + i);
+        }
+        for (; i < numSamples; ++i)
+        {
+            pulseWidth = widths[i];
+            dest[i] = SquareOsc::output(dest[i]) * gain;
+        }
+        pulseWidth = widths[numSamples - 1];
+    }
+    
+    void setPulseWidth(float pw)
+    {
+        pulseWidth = pw;
+    }
+    
+    /// Enables the PolyBLEP correction. Without it the pulse is cheaper but aliases.
+    void setBandLimited(bool shouldBeBandLimited)
+    {
+        bandLimited = shouldBeBandLimited;
+    }
+    
+    /// Saves or restores the running state, see StateArchive.h.
+    template <typename Archive>
+    void transferState(Archive& archive)
+    {
+        Phasor::transferState(archive);
+        archive(pulseWidth, bandLimited);
+    }
+    
+private:
+    float pulseWidth = 0.5f;
+    bool bandLimited = true;
+};
+
+/// Triangle wave oscillator derived from Phasor
+/// The TriWave in NES has an asymmetrical rise and fall.
+/// The falling segment of the waveform is slightly curved and the rise is linear.
+class TriOsc: public Phasor
+{
+    float output(float p) override 
+    {
+        if (p < 0.5)
+        {
+            // Linear rise: 0 to 1 in half the waveform
+            p = p * 4.0f - 1.0f;  // Scale and shift to go from -1 to 1
+        }
+        else
+        {
+            // Curved fall: use a quadratic curve for slight curve effect
+            float t = (p - 0.5f) * 2.0f; // Scale phase to go from 0 to 1
+            p = 1.0f - 2.0f * t * t; // Quadratic curve
+        }
+        p /= 2; // // Scale from -1 to 1 to -0.5~0.5
+        return p;
+    }
+};
+
+///  Sawtooth wave oscillator derived from Phasor
+class SawOsc: public Phasor
+{
+public:
+    float output(float p)override
+    {
+        return p - 0.5f;
+    }
+};
+
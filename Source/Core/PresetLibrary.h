@@ -0,0 +1,626 @@
+/*
+  ==============================================================================
+
+    PresetLibrary.h
+    Created: 25 Oct 2026 10:22:43am
+    Author:  70
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "ChiptuneParameters.h"
+#include "PresetReader.h"
+
+#if defined(_WIN32)
+ #ifndef NOMINMAX
+  #define NOMINMAX
+ #endif
+ #include <windows.h>
+#else
+ #include <fcntl.h>
+ #include <sys/mman.h>
+ #include <sys/stat.h>
+ #include <unistd.h>
+#endif
+
+/**
+ * @class PresetLibrary
+ *
+ * @brief A browsable index of the presets found in folders of .vstpreset files and in REAPER .RPL libraries.
+ *
+ * Opening a library lists its files, and reads the index of their presets from a cache file: names,
+ * tags, oscillator type, and where each preset is stored. The cache is memory-mapped and used as is,
+ * so opening a library of any size costs about one file listing. Only the files that are new or have
+ * changed since the cache was written are scanned again, and then the cache is rewritten.
+ *
+ * A preset is decoded when it is loaded, by reading just its own bytes: the whole file for a .vstpreset,
+ * or the base64 text of its record for an .RPL, which holds the same plugin state. Both hold the XML
+ * state read by PresetReader.
+ *
+ * Tags are the folder of a .vstpreset (relative to the scanned folder), the name of an .RPL file, the
+ * oscillator type, and the modulators the preset switches on.
+ */
+class PresetLibrary
+{
+public:
+    PresetLibrary() = default;
+    ~PresetLibrary() { close(); }
+
+    PresetLibrary(const PresetLibrary&) = delete;
+    PresetLibrary& operator=(const PresetLibrary&) = delete;
+
+    /**
+     * @brief Opens the presets found in a list of folders and .RPL/.vstpreset files.
+     *
+     * @param locations  folders, searched recursively, and single files
+     * @param cachePath  index file to reuse and update, or empty to build the index in memory every time
+     * @return false if no preset was found
+     */
+    bool open(const std::vector<std::string>& locations, const std::string& cachePath)
+    {
+        close();
+
+        std::vector<Source> sources = listSources(locations);
+        if (! cachePath.empty() && mapIndex(cachePath) && matchesSources(sources))
+            return getNumPresets() > 0;
+
+        std::vector<char> index = buildIndex(sources);
+        close();
+
+        if (! cachePath.empty() && writeFile(cachePath, index) && mapIndex(cachePath))
+            return getNumPresets() > 0;
+
+        // The cache cannot be written: keep the index in memory
+        ownedIndex = std::move(index);
+        setIndex(ownedIndex.data(), ownedIndex.size());
+        return getNumPresets() > 0;
+    }
+
+    /// Closes the library.
+    void close()
+    {
+        mappedFile.close();
+        ownedIndex.clear();
+        header = nullptr;
+    }
+
+    //==============================================================================
+    /// Returns the number of presets.
+    int getNumPresets() const { return header != nullptr ? static_cast<int>(header->numEntries) : 0; }
+
+    /// Returns the name of a preset.
+    std::string_view getName(int index) const { return getString(getEntry(index).name); }
+
+    /// Returns the tags of a preset, separated by commas.
+    std::string_view getTags(int index) const { return getString(getEntry(index).tags); }
+
+    /// Returns the oscillator type of a preset: 0 for pulse, 1 for triangle, 2 for noise.
+    int getOscType(int index) const { return getEntry(index).oscType; }
+
+    /// Returns the file a preset is stored in.
+    std::string_view getPath(int index) const { return getString(getSource(getEntry(index).source).path); }
+
+    /// Returns the presets whose name or tags contain the text, ignoring case. An empty text matches all.
+    std::vector<int> find(std::string_view text) const
+    {
+        std::vector<int> matches;
+        for (int i = 0; i < getNumPresets(); ++i)
+            if (containsIgnoringCase(getName(i), text) || containsIgnoringCase(getTags(i), text))
+                matches.push_back(i);
+        return matches;
+    }
+
+    /// Returns the index of the first preset with the given name, or -1.
+    int indexOf(std::string_view name) const
+    {
+        for (int i = 0; i < getNumPresets(); ++i)
+            if (getName(i) == name)
+                return i;
+        return -1;
+    }
+
+    /// Decodes a preset. Returns false if its file cannot be read or holds no parameter.
+    bool load(int index, ChiptuneParameters& parameters) const
+    {
+        const auto& entry = getEntry(index);
+        std::ifstream file(std::string(getPath(index)), std::ios::binary);
+        std::string bytes(entry.blobLength, '\0');
+        if (! file.seekg(static_cast<std::streamoff>(entry.blobOffset))
+            || ! file.read(bytes.data(), static_cast<std::streamsize>(bytes.size())))
+            return false;
+
+        if (entry.flags & base64Blob)
+            bytes = decodeBase64(bytes);
+        return PresetReader::parse(bytes.data(), bytes.size(), parameters);
+    }
+
+    //==============================================================================
+    /// Decodes base64 text, skipping whitespace and stopping at the padding.
+    static std::string decodeBase64(std::string_view text)
+    {
+        std::string decoded;
+        decoded.reserve(text.size() * 3 / 4);
+        uint32_t bits = 0;
+        int numBits = 0;
+        for (char c : text)
+        {
+            int value = c >= 'A' && c <= 'Z' ? c - 'A'
+                      : c >= 'a' && c <= 'z' ? c - 'a' + 26
+                      : c >= '0' && c <= '9' ? c - '0' + 52
+                      : c == '+' ? 62 : c == '/' ? 63 : -1;
+            if (c == '=')
+                break;
+            if (value < 0)
+                continue;
+
+            bits = (bits << 6) | static_cast<uint32_t>(value);
+            numBits += 6;
+            if (numBits >= 8)
+            {
+                numBits -= 8;
+                decoded.push_back(static_cast<char>((bits >> numBits) & 0xff));
+            }
+        }
+        return decoded;
+    }
+
+private:
+    //==============================================================================
+    // The index file: a header, the sources, the entries, then the strings they point into.
+    // Every record has a fixed size, so the file is used in place once mapped.
+    static constexpr uint32_t indexMagic = 0x494c5043; // "CPLI"
+    static constexpr uint32_t indexVersion = 1;
+    static constexpr uint8_t base64Blob = 1;           // The preset bytes are base64 text, as in an .RPL
+
+    struct StringRef { uint32_t offset, length; };
+
+    struct Header
+    {
+        uint32_t magic, version, numSources, numEntries;
+        uint64_t stringsSize;
+    };
+
+    struct SourceRecord
+    {
+        StringRef path;
+        uint64_t fileSize;
+        int64_t modifiedTime;
+        uint32_t firstEntry, numEntries; // The entries of a source follow each other
+    };
+
+    struct EntryRecord
+    {
+        StringRef name, tags;
+        uint32_t source;
+        uint32_t blobLength;
+        uint64_t blobOffset;
+        int8_t oscType;
+        uint8_t flags;
+        uint8_t padding[6];
+    };
+
+    /// A file of the library, as found on disk.
+    struct Source
+    {
+        std::string path;
+        std::string folderTag; // Folder of a .vstpreset relative to the scanned folder, or the name of an .RPL
+        uint64_t fileSize = 0;
+        int64_t modifiedTime = 0;
+        bool isLibrary = false; // True for an .RPL
+    };
+
+    /// A read-only mapping of a whole file.
+    class MappedFile
+    {
+    public:
+        ~MappedFile() { close(); }
+
+        bool open(const std::string& path)
+        {
+            close();
+           #if defined(_WIN32)
+            file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (file == INVALID_HANDLE_VALUE)
+                return false;
+            LARGE_INTEGER fileSize;
+            if (! GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+                return close(), false;
+            mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (mapping == nullptr)
+                return close(), false;
+            data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            size = static_cast<size_t>(fileSize.QuadPart);
+           #else
+            int fd = ::open(path.c_str(), O_RDONLY);
+            if (fd < 0)
+                return false;
+            struct stat info;
+            if (fstat(fd, &info) == 0 && info.st_size > 0)
+            {
+                size = static_cast<size_t>(info.st_size);
+                data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (data == MAP_FAILED)
+                    data = nullptr;
+            }
+            ::close(fd);
+           #endif
+            if (data == nullptr)
+                close();
+            return data != nullptr;
+        }
+
+        void close()
+        {
+           #if defined(_WIN32)
+            if (data != nullptr)
+                UnmapViewOfFile(data);
+            if (mapping != nullptr)
+                CloseHandle(mapping);
+            if (file != INVALID_HANDLE_VALUE)
+                CloseHandle(file);
+            mapping = nullptr;
+            file = INVALID_HANDLE_VALUE;
+           #else
+            if (data != nullptr)
+                munmap(data, size);
+           #endif
+            data = nullptr;
+            size = 0;
+        }
+
+        const char* getData() const { return static_cast<const char*>(data); }
+        size_t getSize() const { return size; }
+
+    private:
+        void* data = nullptr;
+        size_t size = 0;
+       #if defined(_WIN32)
+        HANDLE file = INVALID_HANDLE_VALUE;
+        HANDLE mapping = nullptr;
+       #endif
+    };
+
+    MappedFile mappedFile;
+    std::vector<char> ownedIndex;    // The index, when it is not mapped from the cache
+    const Header* header = nullptr;
+    const SourceRecord* sources = nullptr;
+    const EntryRecord* entries = nullptr;
+    const char* strings = nullptr;
+
+    const EntryRecord& getEntry(int index) const { return entries[index]; }
+    const SourceRecord& getSource(uint32_t index) const { return sources[index]; }
+    std::string_view getString(StringRef ref) const { return { strings + ref.offset, ref.length }; }
+
+    //==============================================================================
+    /**
+     * @brief Points the accessors at an index in memory. Returns false if it is not a valid index.
+     *
+     * Every string, source and entry reference is checked once here, so that a damaged or truncated
+     * cache is rebuilt by open() rather than read out of bounds by the accessors.
+     */
+    bool setIndex(const char* data, size_t size)
+    {
+        header = nullptr;
+        if (size < sizeof(Header))
+            return false;
+
+        auto* candidate = reinterpret_cast<const Header*>(data);
+        uint64_t stringsStart = sizeof(Header) + uint64_t { candidate->numSources } * sizeof(SourceRecord)
+                              + uint64_t { candidate->numEntries } * sizeof(EntryRecord);
+        if (candidate->magic != indexMagic || candidate->version != indexVersion
+            || stringsStart > size || candidate->stringsSize != size - stringsStart)
+            return false;
+
+        auto* candidateSources = reinterpret_cast<const SourceRecord*>(data + sizeof(Header));
+        auto* candidateEntries = reinterpret_cast<const EntryRecord*>(candidateSources + candidate->numSources);
+        if (! isValidIndex(*candidate, candidateSources, candidateEntries))
+            return false;
+
+        header = candidate;
+        sources = candidateSources;
+        entries = candidateEntries;
+        strings = data + stringsStart;
+        return true;
+    }
+
+    /// Returns true if every reference of the index records stays inside the index.
+    static bool isValidIndex(const Header& index, const SourceRecord* sourceRecords, const EntryRecord* entryRecords)
+    {
+        auto isValidString = [&index](StringRef ref) { return uint64_t { ref.offset } + ref.length <= index.stringsSize; };
+
+        for (uint32_t i = 0; i < index.numSources; ++i)
+        {
+            const auto& source = sourceRecords[i];
+            if (! isValidString(source.path)
+                || uint64_t { source.firstEntry } + source.numEntries > index.numEntries)
+                return false;
+        }
+
+        for (uint32_t i = 0; i < index.numEntries; ++i)
+        {
+            const auto& entry = entryRecords[i];
+            if (! isValidString(entry.name) || ! isValidString(entry.tags) || entry.source >= index.numSources
+                || entry.oscType < 0 || entry.oscType > 2
+                || entry.blobOffset > sourceRecords[entry.source].fileSize
+                || entry.blobLength > sourceRecords[entry.source].fileSize - entry.blobOffset)
+                return false;
+        }
+        return true;
+    }
+
+    /// Maps an index file and checks it. Returns false if there is none or it is invalid.
+    bool mapIndex(const std::string& path)
+    {
+        return mappedFile.open(path) && setIndex(mappedFile.getData(), mappedFile.getSize());
+    }
+
+    /// Returns true if the mapped index was built from exactly these files, unchanged since.
+    bool matchesSources(const std::vector<Source>& found) const
+    {
+        if (header == nullptr || header->numSources != found.size())
+            return false;
+
+        for (size_t i = 0; i < found.size(); ++i)
+        {
+            const auto& source = sources[i];
+            if (getString(source.path) != found[i].path || source.fileSize != found[i].fileSize
+                || source.modifiedTime != found[i].modifiedTime)
+                return false;
+        }
+        return true;
+    }
+
+    //==============================================================================
+    static bool hasExtension(const std::filesystem::path& path, const char* extension)
+    {
+        std::string actual = path.extension().string();
+        return actual.size() == std::strlen(extension)
+            && std::equal(actual.begin(), actual.end(), extension,
+                          [](char a, char b) { return std::tolower(static_cast<unsigned char>(a)) == b; });
+    }
+
+    /// Lists the .vstpreset and .RPL files of the locations, sorted by path.
+    static std::vector<Source> listSources(const std::vector<std::string>& locations)
+    {
+        std::vector<Source> found;
+        auto addFile = [&found](const std::filesystem::directory_entry& file, const std::filesystem::path& root)
+        {
+            std::error_code error;
+            bool isLibrary = hasExtension(file.path(), ".rpl");
+            if (! file.is_regular_file(error) || ! (isLibrary || hasExtension(file.path(), ".vstpreset")))
+                return;
+
+            Source source;
+            source.path = file.path().string();
+            source.isLibrary = isLibrary;
+            source.folderTag = isLibrary ? file.path().stem().string()
+                                         : file.path().parent_path().lexically_relative(root).generic_string();
+            if (source.folderTag == ".")
+                source.folderTag.clear();
+            source.fileSize = file.file_size(error);
+            source.modifiedTime = static_cast<int64_t>(file.last_write_time(error).time_since_epoch().count());
+            found.push_back(source);
+        };
+
+        for (const auto& location : locations)
+        {
+            std::error_code error;
+            std::filesystem::path root(location);
+            if (std::filesystem::is_directory(root, error))
+            {
+                for (std::filesystem::recursive_directory_iterator it(root, error), end; it != end; it.increment(error))
+                    addFile(*it, root);
+            }
+            else
+            {
+                addFile(std::filesystem::directory_entry(root, error), root.parent_path());
+            }
+        }
+
+        std::sort(found.begin(), found.end(), [](const Source& a, const Source& b) { return a.path < b.path; });
+        return found;
+    }
+
+    //==============================================================================
+    /// An index entry while the index is being built.
+    struct PendingEntry
+    {
+        std::string name, tags;
+        uint64_t blobOffset = 0;
+        uint32_t blobLength = 0;
+        int8_t oscType = 0;
+        uint8_t flags = 0;
+    };
+
+    /// Builds the index of the sources, reusing the entries of the mapped index for unchanged files.
+    std::vector<char> buildIndex(const std::vector<Source>& found) const
+    {
+        std::vector<std::vector<PendingEntry>> entriesBySource(found.size());
+        for (size_t i = 0; i < found.size(); ++i)
+        {
+            if (! copyCachedEntries(found[i], entriesBySource[i]))
+                scanSource(found[i], entriesBySource[i]);
+        }
+
+        std::string stringData;
+        auto addString = [&stringData](std::string_view text)
+        {
+            StringRef ref { static_cast<uint32_t>(stringData.size()), static_cast<uint32_t>(text.size()) };
+            stringData.append(text);
+            return ref;
+        };
+
+        std::vector<SourceRecord> sourceRecords;
+        std::vector<EntryRecord> entryRecords;
+        for (size_t i = 0; i < found.size(); ++i)
+        {
+            sourceRecords.push_back({ addString(found[i].path), found[i].fileSize, found[i].modifiedTime,
+                                      static_cast<uint32_t>(entryRecords.size()),
+                                      static_cast<uint32_t>(entriesBySource[i].size()) });
+            for (const auto& pending : entriesBySource[i])
+            {
+                EntryRecord record {};
+                record.name = addString(pending.name);
+                record.tags = addString(pending.tags);
+                record.source = static_cast<uint32_t>(i);
+                record.blobOffset = pending.blobOffset;
+                record.blobLength = pending.blobLength;
+                record.oscType = pending.oscType;
+                record.flags = pending.flags;
+                entryRecords.push_back(record);
+            }
+        }
+
+        Header newHeader { indexMagic, indexVersion, static_cast<uint32_t>(sourceRecords.size()),
+                           static_cast<uint32_t>(entryRecords.size()), stringData.size() };
+        std::vector<char> index;
+        auto append = [&index](const void* data, size_t size)
+        {
+            index.insert(index.end(), static_cast<const char*>(data), static_cast<const char*>(data) + size);
+        };
+        append(&newHeader, sizeof(newHeader));
+        append(sourceRecords.data(), sourceRecords.size() * sizeof(SourceRecord));
+        append(entryRecords.data(), entryRecords.size() * sizeof(EntryRecord));
+        append(stringData.data(), stringData.size());
+        return index;
+    }
+
+    /// Copies the entries of an unchanged file from the mapped index. Returns false if it has none.
+    bool copyCachedEntries(const Source& source, std::vector<PendingEntry>& result) const
+    {
+        if (header == nullptr)
+            return false;
+
+        // The sources are sorted by path
+        auto* end = sources + header->numSources;
+        auto* cached = std::lower_bound(sources, end, source.path, [this](const SourceRecord& record, const std::string& path)
+        {
+            return getString(record.path) < path;
+        });
+        if (cached == end || getString(cached->path) != source.path
+            || cached->fileSize != source.fileSize || cached->modifiedTime != source.modifiedTime)
+            return false;
+
+        for (uint32_t i = cached->firstEntry; i < cached->firstEntry + cached->numEntries; ++i)
+        {
+            const auto& entry = entries[i];
+            result.push_back({ std::string(getString(entry.name)), std::string(getString(entry.tags)),
+                               entry.blobOffset, entry.blobLength, entry.oscType, entry.flags });
+        }
+        return true;
+    }
+
+    /// Reads the presets of a file, decoding each once for its tags.
+    static void scanSource(const Source& source, std::vector<PendingEntry>& result)
+    {
+        std::ifstream file(source.path, std::ios::binary);
+        std::string contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+        if (! source.isLibrary)
+        {
+            PendingEntry entry;
+            entry.name = std::filesystem::path(source.path).stem().string();
+            entry.blobLength = static_cast<uint32_t>(contents.size());
+            if (describe(contents, source.folderTag, entry))
+                result.push_back(entry);
+            return;
+        }
+
+        // An .RPL holds one <PRESET name record per preset, its state as base64 lines, closed by a line with ">"
+        for (size_t pos = contents.find("<PRESET"); pos != std::string::npos; pos = contents.find("<PRESET", pos))
+        {
+            size_t lineEnd = contents.find('\n', pos);
+            size_t bodyEnd = lineEnd == std::string::npos ? std::string::npos : contents.find('>', lineEnd);
+            if (bodyEnd == std::string::npos)
+                break;
+
+            PendingEntry entry;
+            entry.name = readRecordName(std::string_view(contents).substr(pos + 7, lineEnd - pos - 7));
+            entry.blobOffset = lineEnd + 1;
+            entry.blobLength = static_cast<uint32_t>(bodyEnd - lineEnd - 1);
+            entry.flags = base64Blob;
+            if (describe(decodeBase64(std::string_view(contents).substr(entry.blobOffset, entry.blobLength)),
+                         source.folderTag, entry))
+                result.push_back(entry);
+            pos = bodyEnd;
+        }
+    }
+
+    /// Returns the name of an .RPL record, which may be quoted with backticks, double or single quotes.
+    static std::string readRecordName(std::string_view text)
+    {
+        auto start = text.find_first_not_of(" \t");
+        if (start == std::string_view::npos)
+            return {};
+
+        char quote = text[start];
+        if (quote == '`' || quote == '"' || quote == '\'')
+        {
+            auto end = text.find(quote, start + 1);
+            return std::string(text.substr(start + 1, end == std::string_view::npos ? end : end - start - 1));
+        }
+        auto end = text.find_first_of(" \t\r", start);
+        return std::string(text.substr(start, end == std::string_view::npos ? end : end - start));
+    }
+
+    /// Decodes a preset to fill in its oscillator type and tags. Returns false if it holds no parameter.
+    static bool describe(const std::string& state, const std::string& folderTag, PendingEntry& entry)
+    {
+        ChiptuneParameters parameters;
+        if (! PresetReader::parse(state.data(), state.size(), parameters))
+            return false;
+
+        static const char* const oscNames[] = { "Pulse", "Triangle", "Noise" };
+        entry.oscType = static_cast<int8_t>(std::clamp(static_cast<int>(parameters.get(ChiptuneParameters::oscType)), 0, 2));
+
+        std::vector<std::string> tags;
+        if (! folderTag.empty())
+            tags.push_back(folderTag);
+        tags.push_back(oscNames[entry.oscType]);
+        if (parameters.isOn(ChiptuneParameters::pwmSwitch))
+            tags.push_back("PWM");
+        if (parameters.isOn(ChiptuneParameters::arpSwitch))
+            tags.push_back("Arp");
+        if (parameters.isOn(ChiptuneParameters::vibSwitch))
+            tags.push_back("Vibrato");
+        if (parameters.isOn(ChiptuneParameters::pbSwitch))
+            tags.push_back("Pitch Bend");
+
+        for (const auto& tag : tags)
+            entry.tags += (entry.tags.empty() ? "" : ",") + tag;
+        return true;
+    }
+
+    /// Writes a file next to its destination, then moves it in place, so a reader never sees half of it.
+    static bool writeFile(const std::string& path, const std::vector<char>& data)
+    {
+        std::string temporaryPath = path + ".tmp";
+        {
+            std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+            if (! file.write(data.data(), static_cast<std::streamsize>(data.size())))
+                return false;
+        }
+        std::error_code error;
+        std::filesystem::rename(temporaryPath, path, error);
+        if (error)
+            std::filesystem::remove(temporaryPath, error);
+        return ! error;
+    }
+
+    static bool containsIgnoringCase(std::string_view text, std::string_view part)
+    {
+        auto lower = [](char c) { return std::tolower(static_cast<unsigned char>(c)); };
+        return std::search(text.begin(), text.end(), part.begin(), part.end(),
+                           [&lower](char a, char b) { return lower(a) == lower(b); }) != text.end();
+    }
+};
@@ -0,0 +1,147 @@
+/*
+  ==============================================================================
+
+    PresetReader.h
+    Created: 20 Oct 2026 9:40:31am
+    Author:  70
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include "ChiptuneParameters.h"
+
+/**
+ * @brief Reads presets into a ChiptuneParameters snapshot without JUCE, for tools and game runtimes.
+ *
+ * Three formats are understood:
+ * - the plugin state, as saved by getStateInformation (JUCE's binary XML wrapper);
+ * - the same state as plain XML, a `ParamTree` of `PARAM` elements with `id` and `value` attributes;
+ * - plain text, one `id=value` pair per line, with `#` starting a comment.
+ *
+ * Parameters missing from the preset keep their default value, unknown IDs are ignored.
+ */
+namespace PresetReader
+{
+    /// Returns the value of an attribute inside one XML tag, or an empty string.
+    inline std::string getXmlAttribute(const std::string& tag, const std::string& name)
+    {
+        std::string pattern = " " + name + "=\"";
+        auto start = tag.find(pattern);
+        if (start == std::string::npos)
+            return {};
+
+        start += pattern.size();
+        auto end = tag.find('"', start);
+        return end == std::string::npos ? std::string() : tag.substr(start, end - start);
+    }
+
+    /**
+     * @brief Reads the `PARAM` elements of a plugin state in XML form.
+     *
+     * Only the top-level parameters are read: the state may also hold key zones, whose own parameter
+     * snapshots come after a `KeyZones` element and are skipped.
+     *
+     * @return true if at least one parameter was found
+     */
+    inline bool parseXml(const std::string& xml, ChiptuneParameters& parameters)
+    {
+        parameters.setToDefaults();
+        auto end = xml.find("<KeyZones");
+        if (end == std::string::npos)
+            end = xml.size();
+
+        bool found = false;
+        for (auto pos = xml.find("<PARAM"); pos < end; pos = xml.find("<PARAM", pos + 1))
+        {
+            auto tagEnd = xml.find('>', pos);
+            if (tagEnd == std::string::npos)
+                break;
+
+            std::string tag = xml.substr(pos, tagEnd - pos);
+            std::string id = getXmlAttribute(tag, "id");
+            std::string value = getXmlAttribute(tag, "value");
+            if (! id.empty() && ! value.empty())
+            {
+                parameters.set(id.c_str(), std::strtof(value.c_str(), nullptr));
+                found = true;
+            }
+        }
+        return found;
+    }
+
+    /// Reads `id=value` lines. Returns true if at least one parameter was found.
+    inline bool parseText(const std::string& text, ChiptuneParameters& parameters)
+    {
+        parameters.setToDefaults();
+        bool found = false;
+        size_t lineStart = 0;
+        while (lineStart < text.size())
+        {
+            auto lineEnd = text.find('\n', lineStart);
+            if (lineEnd == std::string::npos)
+                lineEnd = text.size();
+
+            std::string line = text.substr(lineStart, lineEnd - lineStart);
+            lineStart = lineEnd + 1;
+
+            line = line.substr(0, line.find('#'));
+            auto equals = line.find('=');
+            if (equals == std::string::npos)
+                continue;
+
+            auto trim = [](std::string s)
+            {
+                auto first = s.find_first_not_of(" \t\r");
+                auto last = s.find_last_not_of(" \t\r");
+                return first == std::string::npos ? std::string() : s.substr(first, last - first + 1);
+            };
+
+            std::string id = trim(line.substr(0, equals));
+            std::string value = trim(line.substr(equals + 1));
+            if (ChiptuneParameters::indexOf(id.c_str()) >= 0 && ! value.empty())
+            {
+                parameters.set(id.c_str(), std::strtof(value.c_str(), nullptr));
+                found = true;
+            }
+        }
+        return found;
+    }
+
+    /// Reads a preset from memory, detecting its format. Returns false if no parameter was found.
+    inline bool parse(const void* data, size_t size, ChiptuneParameters& parameters)
+    {
+        auto* bytes = static_cast<const uint8_t*>(data);
+
+        // JUCE's AudioProcessor::copyXmlToBinary: magic number, string length, then the XML text
+        const uint32_t juceMagic = 0x21324356;
+        if (size >= 8)
+        {
+            uint32_t magic = bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | (uint32_t(bytes[3]) << 24);
+            uint32_t length = bytes[4] | (bytes[5] << 8) | (bytes[6] << 16) | (uint32_t(bytes[7]) << 24);
+            if (magic == juceMagic && length <= size - 8)
+                return parseXml(std::string(reinterpret_cast<const char*>(bytes + 8), length), parameters);
+        }
+
+        std::string text(reinterpret_cast<const char*>(bytes), size);
+        if (text.find("<PARAM") != std::string::npos)
+            return parseXml(text, parameters);
+        return parseText(text, parameters);
+    }
+
+    /// Reads a preset file, detecting its format. Returns false if it cannot be read or holds no parameter.
+    inline bool load(const std::string& path, ChiptuneParameters& parameters)
+    {
+        std::ifstream file(path, std::ios::binary);
+        if (! file)
+            return false;
+
+        std::string contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        return parse(contents.data(), contents.size(), parameters);
+    }
+}
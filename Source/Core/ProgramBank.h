@@ -0,0 +1,82 @@
+/*
+  ==============================================================================
+
+    ProgramBank.h
+    Created: 24 Oct 2026 2:31:17pm
+    Author:  70
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <string>
+#include <vector>
+#include "ChiptuneParameters.h"
+#include "FactoryPrograms.h"
+
+/**
+ * @class ProgramBank
+ *
+ * @brief A list of named programs, each a complete ChiptuneParameters snapshot ready to play.
+ *
+ * Presets are decoded once, when they are added, so switching program is a copy of the snapshot:
+ * no parsing, no lookup by ID and no allocation, which makes it safe on the audio thread (e.g. for a
+ * MIDI program change). An "Init" program with the default values comes first, then the factory
+ * programs, then any user programs.
+ *
+ * Like KeyZoneMap, the bank is edited on the message thread and read on the audio thread, so edits
+ * must be made while the engine is not rendering (in the plugin, while holding the callback lock).
+ */
+class ProgramBank
+{
+public:
+    /// A program: its display name and the parameters it sets.
+    struct Program
+    {
+        std::string name;
+        ChiptuneParameters parameters;
+    };
+
+    /// Constructs a bank holding the Init program and the factory programs.
+    ProgramBank()
+    {
+        programs.push_back({ "Init", {} });
+        for (const auto& factoryProgram : FactoryPrograms::programs)
+        {
+            Program program { factoryProgram.name, {} };
+            for (size_t i = 0; i < factoryProgram.numValues; ++i)
+                program.parameters.set(factoryProgram.values[i].id, factoryProgram.values[i].value);
+            programs.push_back(program);
+        }
+        numFactoryPrograms = getNumPrograms();
+    }
+
+    /// Adds a user program after the others, and returns its index.
+    int addProgram(const std::string& name, const ChiptuneParameters& parameters)
+    {
+        programs.push_back({ name, parameters });
+        return getNumPrograms() - 1;
+    }
+
+    /// Removes the user programs, keeping the Init and factory programs.
+    void clearUserPrograms()
+    {
+        programs.resize(static_cast<size_t>(numFactoryPrograms));
+    }
+
+    /// Returns the number of programs, factory and user.
+    int getNumPrograms() const { return static_cast<int>(programs.size()); }
+
+    /// Returns the number of Init and factory programs, which come first.
+    int getNumFactoryPrograms() const { return numFactoryPrograms; }
+
+    /// Returns true if the index refers to a program of the bank.
+    bool contains(int index) const { return index >= 0 && index < getNumPrograms(); }
+
+    /// Returns a program. The index must be valid, see contains().
+    const Program& getProgram(int index) const { return programs[static_cast<size_t>(index)]; }
+
+private:
+    std::vector<Program> programs;
+    int numFactoryPrograms = 0;
+};
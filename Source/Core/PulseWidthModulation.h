@@ -0,0 +1,263 @@
+/*
+  ==============================================================================
+
+    PulseWidthModulation.h
+    Created: 24 Apr 2024 10:35:03pm
+    Author:  70
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <vector>
+#include <algorithm>
+#include "ChiptuneParameters.h"
+#include "PolyBLEPOscillator.h"
+#include "LinearSmoothedValue.h"
+
+/**
+ * @class PulseWidthModulation
+ *
+ * @brief Implements a pulse width modulation module using a phasor-based oscillator.
+ *
+ * This class provides dynamic control over pulse width modulation (PWM) by adjusting parameters like
+ * pulse width, modulation rate, and sustain time, facilitated by a PolyBLEP oscillator. It uses
+ * parameters from a ChiptuneParameters snapshot to allow seamless integration with audio plugin interfaces.
+ *
+ * The stepped shape switches between the three NES widths, like the hardware. The continuous shape
+ * sweeps the width from the start width of the mode to its end width and back, following a triangle
+ * of the LFO phase. The LFO runs at the control rate of the voice, and the square oscillator corrects
+ * both edges of the pulse with PolyBLEP at any width, so the sweep stays band-limited without
+ * smoothing.
+ */
+class PulseWidthModulation : public Phasor
+{
+public:
+    /// Constructor that initializes the reference to the voice's parameter snapshot.
+    PulseWidthModulation(const ChiptuneParameters& params)
+    : params(params) 
+    {
+    }
+    
+    /// Sets the sample rate for the internal oscillator.
+    void setSampleRate(float newSampleRate)
+    {
+        sampleRate = newSampleRate;
+        arpOsc.setSampleRate(sampleRate);
+        smoothPulseWidth.reset(sampleRate, 0.01f); // Set the sample rate and smoothing time
+        parameterWatch.invalidate(); // The rate and sustain length depend on the sample rate
+    }
+
+    /// Updates the frequency of the internal oscillator based on the modulation rate.
+    void setRate()
+    {
+        parameterWatch.invalidate();
+        updateParameters();
+    }
+    
+    /// Recomputes the rate, sustain length and mode if their parameters changed (DAW automation). Called once per block.
+    void updateParameters()
+    {
+        if (! parameterWatch.changed(params))
+            return;
+        
+        arpOsc.setFrequency(updateRate() * 10.0); // Updates frequency to range 0~10Hz
+        updateSustainParameters(); // Handle changes in sustain and PWM mode parameters
+    }
+    
+    /// Resets the counter used for sustaining the current pulse width.
+    void resetSustainCounter()
+    {
+        sustainCounter = 0;  // Initialize the counter to 0
+    }
+    
+    /// Processes one sample of pulse width modulation and returns the current pulse width.
+    float process()
+    {
+        float width;
+        process(&width, 1);
+        return width;
+    }
+    
+    /// Processes numTicks ticks of pulse width modulation, writing the pulse width of each into widths.
+    void process(float* widths, int numTicks)
+    {
+        // The LFO phase stays in a register for the whole run, rather than going through the Phasor per tick
+        float phase = arpOsc.getCurrentPhase();
+        float phaseDelta = arpOsc.getPhaseDelta();
+        if (continuous)
+        {
+            for (int i = 0; i < numTicks; ++i)
+                widths[i] = processContinuous(phase, phaseDelta);
+        }
+        else
+        {
+            for (int i = 0; i < numTicks; ++i)
+                widths[i] = processStepped(phase, phaseDelta);
+        }
+        arpOsc.setPhase(phase);
+    }
+
+    /// Saves or restores the running state, see StateArchive.h.
+    template <typename Archive>
+    void transferState(Archive& archive)
+    {
+        archive(arpOsc, sampleRate, currentPwMode, pwIndex, sustainSamples, sustainCounter, continuous, sweepStart, sweepSlope,
+                smoothPulseWidth);
+    }
+
+private:
+    std::vector<float>pulseWidths {0.125, 0.25, 0.5}; // List of possible pulse widths
+    Phasor arpOsc; // Oscillator used for pulse width modulation
+    float sampleRate = 44100.0f; // Default sample rate
+    
+    int currentPwMode = 0; // Current mode of PWM
+    int pwIndex = 0; // Index of the current pulse width
+    int sustainSamples = 0;  // Samples to sustain a particular pulse width
+    int sustainCounter = 0;  // Counts samples for sustain duration
+    bool continuous = false; // Sweeps the width continuously instead of stepping between widths
+    float sweepStart = 0.125f; // Width the continuous sweep starts and ends on
+    float sweepSlope = 0.25f; // Width change per unit of LFO phase: twice the signed distance from the start width to the end width
+    
+    LinearSmoothedValue smoothPulseWidth; // Smoothed value for pulse width
+    
+    
+    const ChiptuneParameters& params; // Reference to plugin parameters
+    ParameterWatch<4> parameterWatch { ChiptuneParameters::pwmSustain, ChiptuneParameters::pwmMode, ChiptuneParameters::pwmRate,
+                                       ChiptuneParameters::pwmShape };
+    
+    /// Updates the sustain time based on parameter value
+    float updateSustain()
+    {
+        return params.get(ChiptuneParameters::pwmSustain);
+    }
+    
+    /// Updates the current mode of PWM based on parameter value
+    float updateMode()
+    {
+        return params.get(ChiptuneParameters::pwmMode);
+    }
+    
+    /// Updates the modulation rate based on parameter value
+    float updateRate()
+    {
+        return params.get(ChiptuneParameters::pwmRate);
+    }
+    
+    /// Updates the shape of the modulation based on parameter value
+    float updateShape()
+    {
+        return params.get(ChiptuneParameters::pwmShape);
+    }
+    
+    /// Updates sustain and mode parameters from the snapshot, and reset sustain counter
+    void updateSustainParameters()
+    {
+        int newSustainSamples = static_cast<int>(updateSustain() * sampleRate);
+        if (newSustainSamples != sustainSamples) // Check if sustainSamples needs an update
+        {
+            sustainSamples = newSustainSamples;
+            resetSustainCounter();
+        }
+        
+        int newMode = updateMode();
+        if (newMode != currentPwMode)
+        {
+            currentPwMode = newMode; // Check if mode has changed
+            resetSustainCounter(); // Reset the counter when mode changes
+        }
+        
+        continuous = updateShape() > 0.5f;
+        updateSweep();
+    }
+    
+    /// Sets the start width and slope of the continuous sweep from the current mode
+    void updateSweep()
+    {
+        static const float sweeps[6][2] = // Start and end width of each mode, in the order of pwmMode
+        {
+            { 0.125f, 0.25f }, { 0.125f, 0.5f }, { 0.25f, 0.5f },
+            { 0.25f, 0.125f }, { 0.5f, 0.25f }, { 0.5f, 0.125f }
+        };
+        int mode = std::clamp(currentPwMode, 0, 5);
+        sweepStart = sweeps[mode][0];
+        sweepSlope = 2.0f * (sweeps[mode][1] - sweeps[mode][0]);
+    }
+    
+    /// Returns the width stepping between the NES widths: the first width of the mode during the sustain, then the one the LFO phase selects
+    float processStepped(float& phase, float phaseDelta)
+    {
+        if (sustainCounter < sustainSamples)
+        {
+            ++sustainCounter; // Increment the sustain counter
+            switch (currentPwMode) // Selects the pulse width index based on the current mode
+            {
+                case 0: // Intended for modes 0 and 1
+                case 1:
+                    pwIndex = 0; // Corresponds to 12.5% pulse width
+                    break;
+                case 2: // Intended for modes 2 and 3
+                case 3:
+                    pwIndex = 1; // Corresponds to 25% pulse width
+                    break;
+                case 4: // Intended for modes 4 and 5
+                case 5:
+                    pwIndex = 2; // Corresponds to 50% pulse width
+                    break;
+            }
+        } 
+        else
+        {
+            phase = Phasor::advance(phase, phaseDelta);
+            calculateIndex(phase); // Adjusts pulse width index based on oscillator output
+        }
+        smoothPulseWidth.setTargetValue(pulseWidths[pwIndex]); // Set the target value for smoothing
+        
+        return smoothPulseWidth.getNextValue();  // Return the smoothed pulse width
+    }
+    
+    /// Returns the continuously swept width: the start width during the sustain, then a triangle of the LFO phase
+    float processContinuous(float& phase, float phaseDelta)
+    {
+        if (sustainCounter < sustainSamples)
+        {
+            ++sustainCounter;
+            return sweepStart;
+        }
+        
+        phase = Phasor::advance(phase, phaseDelta); // range 0~1
+        return sweepStart + sweepSlope * std::min(phase, 1.0f - phase); // Triangle 0~0.5~0
+    }
+    
+    /// Calculates the new index for pulse width based on the oscillator output, range 0~1
+    void calculateIndex(float oscOutput)
+    {
+        switch (currentPwMode)
+        {
+            
+            case 0: // 12.5%to25%
+                pwIndex = static_cast<int>(oscOutput * 1.99); // range 0~1.99, should output 0, 1
+                break;
+            
+            case 1: // 12.5%to50%
+                pwIndex = static_cast<int>(oscOutput * 2.99); // range 0~2.99, should output 0, 1, 2
+                break;
+                
+            case 2: // 25%to50%
+                pwIndex = static_cast<int>(oscOutput * 1.99) + 1; // range 1~2.99, should output 1, 2
+                break;
+            
+            case 3: // 25%to12.5%
+                pwIndex = static_cast<int>((1.0f - oscOutput) * 1.99); //range 1.99~0, should output 1 0
+                break;
+
+            case 4: // 50%to25%
+                pwIndex = static_cast<int>((1.0f - oscOutput) * 1.99) + 1; //range 2.99~1, should output  2 1
+                break;
+                
+            case 5: // 50%to12.5%
+                pwIndex = static_cast<int>((1.0f - oscOutput) * 2.99); //range 2.99~0, should output 2 1 0
+                break;
+        }
+    }
+};
@@ -0,0 +1,191 @@
+/*
+  ==============================================================================
+
+    QualityGovernor.h
+    Created: 21 Oct 2026 3:12:09pm
+    Author:  70
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+#include "RenderQuality.h"
+
+/**
+ * @class QualityGovernor
+ *
+ * @brief Lowers the render quality step by step when blocks come close to missing their deadline, and
+ *        raises it again once there is time to spare.
+ *
+ * The host measures how long each block took and passes it to update(), which compares it with the
+ * block's duration (its deadline). The governor never measures time itself, so a policy can be tested
+ * offline by feeding it simulated block times.
+ *
+ * The policy lists quality tiers from best to cheapest. Hysteresis keeps the tier from flapping:
+ * - it steps down after a few consecutive blocks above the degrade load, or at once if a block missed
+ *   its deadline;
+ * - it steps up only after the smoothed load has stayed below the (much lower) recover load for a
+ *   while;
+ * - after any change it waits for the new tier to show in the measurements.
+ *
+ * Transitions are kept in a small log that other threads can read, see getTransition().
+ */
+class QualityGovernor
+{
+public:
+    struct Policy
+    {
+        std::vector<RenderQuality> tiers; // Best first. Tier 0 is used while there is time to spare.
+        double degradeLoad = 0.75;        // Fraction of the deadline above which the quality goes down.
+        double recoverLoad = 0.35;        // Smoothed fraction of the deadline below which it goes back up.
+        int degradeBlocks = 3;            // Consecutive blocks above degradeLoad before stepping down.
+        double recoverSeconds = 3.0;      // Time below recoverLoad before stepping up.
+        double holdSeconds = 0.25;        // Time after a change during which no other change is made.
+        double smoothing = 0.1;           // Weight of the latest block in the smoothed load.
+    };
+
+    /// A change of tier, for the log.
+    struct Transition
+    {
+        uint64_t blockIndex = 0; // Number of blocks measured before the change.
+        int fromTier = 0;
+        int toTier = 0;
+        double load = 0.0;       // Load of the block that caused the change.
+    };
+
+    /**
+     * @brief Returns the default policy: no oversampling, then naive pulse edges, then slower modulators,
+     *        then fewer voices.
+     *
+     * The tiers are ceilings, the host applies them with RenderQuality::limitedTo() on top of the tier
+     * the instance was set to, so tier 0 (the high tier) leaves that setting unchanged.
+     */
+    static Policy makeDefaultPolicy()
+    {
+        Policy policy;
+        policy.tiers = {
+            RenderQuality::forTier(RenderQuality::high),
+            RenderQuality::forTier(RenderQuality::standard),
+            { false, 1, 0 },
+            { false, 8, 0 },
+            { false, 32, 6, 1, 0 },
+            { false, 32, 3, 1, 0 }
+        };
+        return policy;
+    }
+
+    explicit QualityGovernor(Policy newPolicy = makeDefaultPolicy()) { setPolicy(std::move(newPolicy)); }
+
+    /// Replaces the policy and goes back to the best tier. Allocates, call it off the audio thread.
+    void setPolicy(Policy newPolicy)
+    {
+        policy = std::move(newPolicy);
+        if (policy.tiers.empty())
+            policy.tiers.push_back({});
+        reset();
+    }
+
+    /// Returns the policy.
+    const Policy& getPolicy() const { return policy; }
+
+    /// Goes back to the best tier and clears the measurements, not the transition log.
+    void reset()
+    {
+        tier = 0;
+        smoothedLoad = 0.0;
+        overloadedBlocks = 0;
+        relaxedSeconds = 0.0;
+        holdRemaining = 0.0;
+    }
+
+    //==============================================================================
+    /**
+     * @brief Feeds the time one block took to render.
+     *
+     * @param elapsedSeconds  time spent rendering the block
+     * @param numSamples      length of the block
+     * @param sampleRate      sample rate, numSamples / sampleRate being the deadline
+     * @return true if the tier changed, getQuality() then returns the new settings
+     */
+    bool update(double elapsedSeconds, int numSamples, double sampleRate)
+    {
+        if (numSamples <= 0 || sampleRate <= 0.0)
+            return false;
+
+        double blockSeconds = numSamples / sampleRate;
+        double load = elapsedSeconds / blockSeconds;
+        smoothedLoad += policy.smoothing * (load - smoothedLoad);
+        ++numBlocks;
+
+        overloadedBlocks = load > policy.degradeLoad ? overloadedBlocks + 1 : 0;
+        relaxedSeconds = smoothedLoad < policy.recoverLoad ? relaxedSeconds + blockSeconds : 0.0;
+
+        if (holdRemaining > 0.0)
+        {
+            holdRemaining -= blockSeconds;
+            if (load < 1.0)
+                return false; // A missed deadline overrides the hold
+        }
+
+        int lastTier = static_cast<int>(policy.tiers.size()) - 1;
+        if ((load >= 1.0 || overloadedBlocks >= policy.degradeBlocks) && tier < lastTier)
+            return changeTier(tier + 1, load);
+        if (relaxedSeconds >= policy.recoverSeconds && tier > 0)
+            return changeTier(tier - 1, load);
+        return false;
+    }
+
+    /// Returns the current tier, 0 being the best.
+    int getTier() const { return tier; }
+
+    /// Returns the settings of the current tier, the most the host should render at.
+    const RenderQuality& getQuality() const { return policy.tiers[static_cast<size_t>(tier)]; }
+
+    /// Returns the smoothed load, the fraction of the deadline the blocks take.
+    double getLoad() const { return smoothedLoad; }
+
+    //==============================================================================
+    /// Returns the number of transitions since construction. Any thread.
+    int getNumTransitions() const { return numTransitions.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Returns a transition from the log. Any thread.
+     *
+     * Only the last logSize transitions are kept: index must be in
+     * [max(0, getNumTransitions() - logSize), getNumTransitions()). A reader on another thread should
+     * remember how many it has read and poll for new ones.
+     */
+    Transition getTransition(int index) const { return log[static_cast<size_t>(index) % logSize]; }
+
+    static constexpr int logSize = 64;
+
+private:
+    Policy policy;
+    int tier = 0;
+    double smoothedLoad = 0.0;
+    int overloadedBlocks = 0;    // Consecutive blocks above the degrade load.
+    double relaxedSeconds = 0.0; // Time the smoothed load has stayed below the recover load.
+    double holdRemaining = 0.0;  // Time left before another change is allowed.
+    uint64_t numBlocks = 0;
+
+    std::array<Transition, logSize> log;
+    std::atomic<int> numTransitions { 0 };
+
+    bool changeTier(int newTier, double load)
+    {
+        int count = numTransitions.load(std::memory_order_relaxed);
+        log[static_cast<size_t>(count) % logSize] = { numBlocks, tier, newTier, load };
+        numTransitions.store(count + 1, std::memory_order_release);
+
+        tier = newTier;
+        overloadedBlocks = 0;
+        relaxedSeconds = 0.0;
+        holdRemaining = policy.holdSeconds;
+        return true;
+    }
+};
@@ -0,0 +1,229 @@
+/*
+  ==============================================================================
+
+    RenderCache.h
+    Created: 19 Oct 2026 3:48:40pm
+    Author:  70
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "ChiptuneParameters.h"
+
+/**
+ * @class RenderCache
+ *
+ * @brief Bounded LRU pool of rendered one-shot sounds, addressed by what they were rendered from.
+ *
+ * A one-shot played with the same parameter snapshot, note and length always sounds the same, so it
+ * only needs to be synthesized once. The key is a 64-bit hash of everything the voice output depends
+ * on (see makeKey()); the gain is applied when mixing, so it is not part of the key. Sounds whose
+ * output changes from one trigger to the next (white noise, random arpeggios) are not cacheable and
+ * must be synthesized live, see isCacheable().
+ *
+ * The buffers are shared, so a sound that is still playing from the cache stays valid when its entry
+ * is evicted. When the pool exceeds its memory or entry limit, the least recently used entries are
+ * evicted. An evicted buffer that is still referenced elsewhere is kept aside and freed by
+ * releaseRetired() once it is not, so that a player dropping its reference never frees memory.
+ *
+ * The cache is not thread safe and allocates on insert(), so it belongs to one worker thread. A player
+ * on the audio thread keeps its own copy of the index instead, fed with the inserted buffers and the
+ * evicted keys (see takeEvictedKeys()), and reports its hits back for touch() (see SfxRuntime).
+ */
+class RenderCache
+{
+public:
+    using Buffer = std::shared_ptr<const std::vector<float>>;
+
+    /// Statistics since construction or the last clear().
+    struct Stats
+    {
+        uint64_t hits = 0;        // Lookups served from the cache.
+        uint64_t misses = 0;      // Cacheable lookups that had to be synthesized.
+        uint64_t uncacheable = 0; // Sounds that can only be synthesized live.
+        uint64_t evictions = 0;   // Entries dropped to stay under the memory limit.
+        size_t numEntries = 0;
+        size_t bytesUsed = 0;
+
+        /// Returns the fraction of cacheable lookups that were hits.
+        double getHitRate() const
+        {
+            uint64_t lookups = hits + misses;
+            return lookups > 0 ? static_cast<double>(hits) / static_cast<double>(lookups) : 0.0;
+        }
+    };
+
+    /// Constructs a cache holding at most maxBytes of samples (8 MB by default), in at most maxEntries buffers.
+    explicit RenderCache(size_t maxBytes = 8u << 20, size_t maxEntries = SIZE_MAX) : maxBytes(maxBytes), maxEntries(maxEntries) {}
+
+    //==============================================================================
+    /**
+     * @brief Returns true if a sound always renders the same.
+     *
+     * White noise and the random arpeggio pattern draw new random numbers at every note, so every
+     * trigger is different and caching them would repeat one take over and over.
+     */
+    static bool isCacheable(const ChiptuneParameters& params)
+    {
+        bool whiteNoise = static_cast<int>(params.get(ChiptuneParameters::oscType)) == 2
+                          && ! params.isOn(ChiptuneParameters::noiseDistortion);
+        bool randomArpeggio = params.isOn(ChiptuneParameters::arpSwitch)
+                              && static_cast<int>(params.get(ChiptuneParameters::arpPattern)) == 8;
+        return ! whiteNoise && ! randomArpeggio;
+    }
+
+    /// Hashes a parameter snapshot, note, note length and sample rate into a cache key (64-bit FNV-1a).
+    static uint64_t makeKey(const ChiptuneParameters& params, int midiNoteNumber, int64_t holdSamples, double sampleRate)
+    {
+        uint64_t hash = 14695981039346656037ull;
+        auto add = [&hash](const void* data, size_t size)
+        {
+            auto* bytes = static_cast<const unsigned char*>(data);
+            for (size_t i = 0; i < size; ++i)
+                hash = (hash ^ bytes[i]) * 1099511628211ull;
+        };
+
+        for (int i = 0; i < ChiptuneParameters::numParameters; ++i)
+        {
+            float value = params.get(static_cast<ChiptuneParameters::Index>(i));
+            add(&value, sizeof(value));
+        }
+        add(&midiNoteNumber, sizeof(midiNoteNumber));
+        add(&holdSamples, sizeof(holdSamples));
+        add(&sampleRate, sizeof(sampleRate));
+        return hash;
+    }
+
+    //==============================================================================
+    /// Returns the buffer stored under a key, marking it as recently used, or nullptr on a miss.
+    Buffer find(uint64_t key)
+    {
+        auto it = index.find(key);
+        if (it == index.end())
+        {
+            ++stats.misses;
+            return nullptr;
+        }
+
+        entries.splice(entries.begin(), entries, it->second); // Move to the front of the LRU list
+        ++stats.hits;
+        return it->second->samples;
+    }
+
+    /// Returns the buffer stored under a key like find(), but without counting a lookup or touching the LRU order.
+    Buffer peek(uint64_t key) const
+    {
+        auto it = index.find(key);
+        return it != index.end() ? it->second->samples : nullptr;
+    }
+
+    /// Marks an entry as recently used, for a hit a player found in its own copy of the index.
+    void touch(uint64_t key)
+    {
+        auto it = index.find(key);
+        if (it != index.end())
+            entries.splice(entries.begin(), entries, it->second);
+    }
+
+    /// Counts a sound that could not be looked up, so the stats show how much is synthesized live.
+    void countUncacheable() { ++stats.uncacheable; }
+
+    /**
+     * @brief Stores a rendered sound, evicting the least recently used entries to make room. Allocates.
+     *
+     * @return the stored buffer, which stays valid even if it is evicted later. If the sound does not
+     *         fit in the cache at all, it is returned without being stored.
+     */
+    Buffer insert(uint64_t key, const float* samples, size_t numSamples)
+    {
+        releaseRetired();
+
+        auto existing = index.find(key);
+        if (existing != index.end())
+            return existing->second->samples;
+
+        auto buffer = std::make_shared<const std::vector<float>>(samples, samples + numSamples);
+        size_t bytes = numSamples * sizeof(float);
+        if (bytes > maxBytes)
+            return buffer;
+
+        while (stats.bytesUsed + bytes > maxBytes || entries.size() >= maxEntries)
+            evictOldest();
+
+        entries.push_front({ key, buffer });
+        index[key] = entries.begin();
+        stats.bytesUsed += bytes;
+        stats.numEntries = entries.size();
+        return buffer;
+    }
+
+    /// Sets the memory limit, evicting entries if the cache is over it.
+    void setMaxBytes(size_t newMaxBytes)
+    {
+        maxBytes = newMaxBytes;
+        while (stats.bytesUsed > maxBytes)
+            evictOldest();
+    }
+
+    /// Removes every entry and resets the statistics.
+    void clear()
+    {
+        while (! entries.empty())
+            evictOldest();
+        releaseRetired();
+        evictedKeys.clear();
+        stats = Stats();
+    }
+
+    /// Returns the keys evicted since the last call, oldest first, and forgets them.
+    std::vector<uint64_t> takeEvictedKeys() { return std::exchange(evictedKeys, {}); }
+
+    /// Frees the evicted buffers that nothing references any more. Frees memory, so call it off the audio thread.
+    void releaseRetired()
+    {
+        retired.erase(std::remove_if(retired.begin(), retired.end(), [](const Buffer& buffer) { return buffer.use_count() == 1; }),
+                      retired.end());
+        std::atomic_thread_fence(std::memory_order_acquire); // The other threads are done reading what was freed
+    }
+
+    /// Returns the hit, miss and memory statistics.
+    const Stats& getStats() const { return stats; }
+
+private:
+    struct Entry
+    {
+        uint64_t key;
+        Buffer samples;
+    };
+
+    std::list<Entry> entries; // Most recently used first.
+    std::unordered_map<uint64_t, std::list<Entry>::iterator> index;
+    std::vector<Buffer> retired; // Evicted buffers that were still referenced.
+    std::vector<uint64_t> evictedKeys; // Evicted since the last takeEvictedKeys().
+    size_t maxBytes;
+    size_t maxEntries;
+    Stats stats;
+
+    /// Drops the least recently used entry.
+    void evictOldest()
+    {
+        const auto& oldest = entries.back();
+        if (oldest.samples.use_count() > 1)
+            retired.push_back(oldest.samples);
+        stats.bytesUsed -= oldest.samples->size() * sizeof(float);
+        index.erase(oldest.key);
+        evictedKeys.push_back(oldest.key);
+        entries.pop_back();
+        stats.numEntries = entries.size();
+        ++stats.evictions;
+    }
+};
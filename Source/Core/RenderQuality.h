@@ -0,0 +1,78 @@
+/*
+  ==============================================================================
+
+    RenderQuality.h
+    Created: 21 Oct 2026 2:05:44pm
+    Author:  70
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <algorithm>
+
+/**
+ * @brief Settings that trade sound quality for CPU time, applied to a whole ChiptuneEngine.
+ *
+ * The defaults are the standard tier, the quality the synth was designed with. Each instance picks a
+ * tier (eco, standard or high, see forTier()), and QualityGovernor can lower it further when the audio
+ * thread runs out of time.
+ *
+ * chiptune_bench --quality eco|standard|high measures both sides of the trade on the machine it runs
+ * on: the cycles per sample of a few patches, and the aliasing, which is the power outside the
+ * harmonics below 20 kHz, relative to the harmonics, for a held 12.5% pulse at 3136 Hz:
+ * - eco:       aliasing  -9 dB (naive pulse)
+ * - standard:  aliasing -33 dB (PolyBLEP)
+ * - high:      aliasing -52 dB (PolyBLEP, 2x oversampled)
+ * The aliasing does not depend on the machine; the cost does, so it is left to the benchmark.
+ */
+struct RenderQuality
+{
+    enum Tier { eco, standard, high, numTiers };
+
+    bool bandLimited = true;    // PolyBLEP-corrected pulse edges. When false, the naive pulse is rendered, which aliases.
+    int controlRateDivider = 1; // The arpeggiator, pitch bend, vibrato and PWM run once every N samples. Applies from the next note.
+    int maxVoices = 0;          // Most voices sounding at once, 0 for no limit. Voices over the limit fade out.
+    int oversampling = 1;       // The pulse oscillator runs this many times faster, 1, 2 or 4, see Decimator. Applies from the next note.
+    int delayInterpolation = 1; // Interpolation of the delay line: 0 none, 1 linear, 3 cubic.
+
+    /// Returns the settings of a tier.
+    static RenderQuality forTier(int tier)
+    {
+        RenderQuality quality;
+        if (tier <= eco)
+        {
+            quality.bandLimited = false;
+            quality.controlRateDivider = 32;
+            quality.delayInterpolation = 0;
+        }
+        else if (tier >= high)
+        {
+            quality.oversampling = 2;
+            quality.delayInterpolation = 3;
+        }
+        return quality;
+    }
+
+    /// Returns these settings, each lowered to the cheaper of itself and the same setting of limit.
+    RenderQuality limitedTo(const RenderQuality& limit) const
+    {
+        RenderQuality quality;
+        quality.bandLimited = bandLimited && limit.bandLimited;
+        quality.controlRateDivider = std::max(controlRateDivider, limit.controlRateDivider);
+        quality.maxVoices = maxVoices == 0 ? limit.maxVoices
+                          : limit.maxVoices == 0 ? maxVoices : std::min(maxVoices, limit.maxVoices);
+        quality.oversampling = std::min(oversampling, limit.oversampling);
+        quality.delayInterpolation = std::min(delayInterpolation, limit.delayInterpolation);
+        return quality;
+    }
+
+    bool operator==(const RenderQuality& other) const
+    {
+        return bandLimited == other.bandLimited && controlRateDivider == other.controlRateDivider
+               && maxVoices == other.maxVoices && oversampling == other.oversampling
+               && delayInterpolation == other.delayInterpolation;
+    }
+
+    bool operator!=(const RenderQuality& other) const { return ! (*this == other); }
+};
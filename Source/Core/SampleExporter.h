@@ -0,0 +1,446 @@
+/*
+  ==============================================================================
+
+    SampleExporter.h
+    Created: 20 Oct 2026 10:26:48am
+    Author:  70
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "AdpcmEncoder.h"
+#include "BrrEncoder.h"
+#include "ChiptuneEngine.h"
+#include "ChiptuneParameters.h"
+#include "ChiptuneRandom.h"
+#include "WavWriter.h"
+
+/**
+ * @class SampleExporter
+ *
+ * @brief Renders a preset across a range of notes and velocities into WAV files and an SFZ instrument.
+ *
+ * For platforms that can only play samples. Every (note, velocity) pair is an independent job rendered
+ * by its own ChiptuneEngine, so the jobs are spread over a pool of threads and the export scales with
+ * the number of cores. Each job renders the note held for Settings::holdSeconds, then its release and
+ * effect tail, and writes its own file.
+ *
+ * Sustained sounds get a loop: the sustain segment is searched for the loop length whose end matches its
+ * start best. If one is found, the sample is cut at the loop end and the SFZ plays the release with
+ * ampeg_release; otherwise (vibrato, arpeggios, ...) the whole render is kept and played as a one-shot.
+ *
+ * Samples can be written as WAV, or compressed to 4 bits for consoles with little RAM: IMA ADPCM WAV or
+ * SNES BRR. The compressed files are encoded as they are written and the SNR of each one is reported.
+ * BRR loops must be whole blocks, so a looped BRR sample is resampled to make its loop a multiple of
+ * 16 samples long, and the pitch change is recorded as a tuning correction. The SFZ is written whatever
+ * the codec, listing the key ranges, loops and tuning.
+ *
+ * The voices have no velocity response of their own, so velocity layers differ only in level.
+ */
+class SampleExporter
+{
+public:
+    enum class Codec { wav, imaAdpcm, brr };
+
+    struct Settings
+    {
+        int lowNote = 36;                    // Lowest note sampled.
+        int highNote = 96;                   // Highest note sampled.
+        int noteStep = 3;                    // Semitones between sampled notes, the notes in between are repitched.
+        std::vector<int> velocities { 127 }; // Velocity layers, 1~127.
+        double sampleRate = 44100.0;
+        float holdSeconds = 2.0f;            // How long each note is held before its release.
+        int numThreads = 0;                  // 0 uses every core.
+        bool detectLoops = true;
+        Codec codec = Codec::wav;
+        WavWriter::Format format = WavWriter::Format::pcm16; // Sample format of the WAV codec.
+        uint64_t seed = 0x43686970;          // Random seed, so exports are reproducible.
+    };
+
+    /// One rendered note.
+    struct Sample
+    {
+        int note = 60;
+        int velocity = 127;
+        int lowKey = 60, highKey = 60;       // Key range mapped to this sample.
+        int lowVelocity = 1, highVelocity = 127;
+        std::vector<float> audio;
+        int64_t loopStart = -1;              // First sample of the loop, -1 if the sample is a one-shot.
+        int64_t loopEnd = -1;                // Last sample of the loop, inclusive as in SFZ.
+        std::string fileName;
+        double tune = 0.0;                   // Pitch correction to apply on playback, in cents.
+        double snr = std::numeric_limits<double>::infinity(); // Signal-to-noise ratio of the ADPCM or BRR encode, in dB.
+    };
+
+    struct Result
+    {
+        bool ok = false;
+        std::string error;
+        std::string sfzPath;
+        int numSamples = 0;
+        int numLooped = 0;
+        int numThreads = 0;
+        double seconds = 0.0;                // Wall-clock time of the export.
+        std::vector<Sample> samples;         // What was written, without the audio.
+    };
+
+    //==============================================================================
+    /**
+     * @brief Renders the preset and writes `<name>_<note>_v<velocity>` samples and `<name>.sfz` into a directory.
+     *
+     * @param parameters  the preset to render
+     * @param settings    note range, velocities, timing and format
+     * @param directory   output directory, created if needed
+     * @param name        base name of the files
+     */
+    static Result exportSfz(const ChiptuneParameters& parameters, const Settings& settings,
+                            const std::string& directory, const std::string& name)
+    {
+        Result result;
+        auto startTime = std::chrono::steady_clock::now();
+
+        std::error_code error;
+        std::filesystem::create_directories(directory, error);
+        if (error)
+        {
+            result.error = "cannot create " + directory + ": " + error.message();
+            return result;
+        }
+
+        auto samples = planSamples(settings, name);
+        if (samples.empty())
+        {
+            result.error = "empty note range or no velocity";
+            return result;
+        }
+
+        // Render and write the samples on a pool of threads, each taking the next job
+        int numThreads = settings.numThreads > 0 ? settings.numThreads
+                                                 : std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+        numThreads = std::min(numThreads, static_cast<int>(samples.size()));
+
+        std::atomic<int> nextJob { 0 };
+        std::atomic<bool> writeFailed { false };
+        auto worker = [&]()
+        {
+            for (int job = nextJob++; job < static_cast<int>(samples.size()); job = nextJob++)
+            {
+                auto& sample = samples[job];
+                renderSample(parameters, settings, ChiptuneRandom::deriveSeed(settings.seed, static_cast<uint64_t>(job)), sample);
+
+                if (! writeSample(settings, directory, sample))
+                    writeFailed = true;
+                sample.audio = {}; // Free the memory as soon as the file is written
+            }
+        };
+
+        std::vector<std::thread> threads;
+        for (int i = 1; i < numThreads; ++i)
+            threads.emplace_back(worker);
+        worker();
+        for (auto& thread : threads)
+            thread.join();
+
+        if (writeFailed)
+        {
+            result.error = "cannot write the samples in " + directory;
+            return result;
+        }
+
+        result.sfzPath = (std::filesystem::path(directory) / (name + ".sfz")).string();
+        std::ofstream sfz(result.sfzPath);
+        sfz << makeSfz(parameters, samples);
+        if (! sfz)
+        {
+            result.error = "cannot write " + result.sfzPath;
+            return result;
+        }
+
+        result.ok = true;
+        result.numSamples = static_cast<int>(samples.size());
+        result.numLooped = static_cast<int>(std::count_if(samples.begin(), samples.end(), [](const Sample& s) { return s.loopStart >= 0; }));
+        result.numThreads = numThreads;
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+        result.samples = std::move(samples);
+        return result;
+    }
+
+    //==============================================================================
+    /// Lists the samples to render, with the key and velocity ranges each one covers.
+    static std::vector<Sample> planSamples(const Settings& settings, const std::string& name)
+    {
+        std::vector<int> notes;
+        int step = std::max(1, settings.noteStep);
+        for (int note = std::max(0, settings.lowNote); note <= std::min(127, settings.highNote); note += step)
+            notes.push_back(note);
+        if (! notes.empty() && notes.back() != std::min(127, settings.highNote))
+            notes.push_back(std::min(127, settings.highNote));
+
+        std::vector<int> velocities;
+        for (int velocity : settings.velocities)
+            velocities.push_back(std::clamp(velocity, 1, 127));
+        std::sort(velocities.begin(), velocities.end());
+        velocities.erase(std::unique(velocities.begin(), velocities.end()), velocities.end());
+
+        std::vector<Sample> samples;
+        for (size_t n = 0; n < notes.size(); ++n)
+        {
+            for (size_t v = 0; v < velocities.size(); ++v)
+            {
+                Sample sample;
+                sample.note = notes[n];
+                sample.velocity = velocities[v];
+
+                // Each sample covers the keys up to halfway to its neighbours, the outer ones reach the ends
+                sample.lowKey = n == 0 ? 0 : (notes[n - 1] + notes[n]) / 2 + 1;
+                sample.highKey = n + 1 == notes.size() ? 127 : (notes[n] + notes[n + 1]) / 2;
+                sample.lowVelocity = v == 0 ? 1 : velocities[v - 1] + 1;
+                sample.highVelocity = v + 1 == velocities.size() ? 127 : velocities[v];
+                sample.fileName = name + "_" + std::to_string(sample.note) + "_v" + std::to_string(sample.velocity)
+                                + (settings.codec == Codec::brr ? ".brr" : ".wav");
+                samples.push_back(std::move(sample));
+            }
+        }
+        return samples;
+    }
+
+    /// Renders one note: held, released, then its effect tail until it falls silent.
+    static void renderSample(const ChiptuneParameters& parameters, const Settings& settings, uint64_t seed, Sample& sample)
+    {
+        const int blockSize = 512;
+        const float silence = 1.0e-4f;   // -80 dB
+        const double maxTailSeconds = 10.0;
+
+        ChiptuneEngine engine(1);
+        engine.getParameters() = parameters;
+        engine.setRandomSeed(seed);
+        engine.prepare(settings.sampleRate);
+
+        auto holdSamples = static_cast<int64_t>(settings.holdSeconds * settings.sampleRate);
+        auto maxSamples = holdSamples + static_cast<int64_t>(maxTailSeconds * settings.sampleRate);
+        float gain = static_cast<float>(sample.velocity) / 127.0f;
+
+        sample.audio.clear();
+        sample.audio.reserve(static_cast<size_t>(static_cast<double>(holdSamples) + parameters.get(ChiptuneParameters::release) * settings.sampleRate) + blockSize);
+        engine.noteOn(sample.note, gain);
+
+        float block[blockSize];
+        float* outputs[] = { block };
+        auto renderBlock = [&](int numSamples)
+        {
+            engine.render(outputs, 1, numSamples);
+            float peak = 0.0f;
+            for (int i = 0; i < numSamples; ++i)
+            {
+                block[i] *= gain;
+                peak = std::max(peak, std::abs(block[i]));
+            }
+            sample.audio.insert(sample.audio.end(), block, block + numSamples);
+            return peak;
+        };
+
+        for (int64_t position = 0; position < holdSamples; position += blockSize)
+            renderBlock(static_cast<int>(std::min<int64_t>(blockSize, holdSamples - position)));
+
+        engine.noteOff(sample.note);
+        for (int64_t position = holdSamples; position < maxSamples; position += blockSize)
+        {
+            float peak = renderBlock(blockSize);
+            if (! engine.getVoice(0).isActive() && peak < silence)
+                break;
+        }
+
+        if (settings.detectLoops)
+        {
+            double sustainStart = (parameters.get(ChiptuneParameters::attack) + parameters.get(ChiptuneParameters::decay) + 0.05) * settings.sampleRate;
+            int64_t loopStart, loopEnd;
+            if (findLoop(sample.audio, static_cast<int64_t>(sustainStart), holdSamples, loopStart, loopEnd))
+            {
+                sample.loopStart = loopStart;
+                sample.loopEnd = loopEnd;
+                if (settings.codec == Codec::brr)
+                    fitLoopToBlocks(sample, BrrEncoder::samplesPerBlock);
+                sample.audio.resize(static_cast<size_t>(sample.loopEnd + 1));
+            }
+        }
+    }
+
+    /**
+     * @brief Looks for a seamless loop inside [searchStart, searchEnd).
+     *
+     * Tries every loop length from 32 to 8192 samples, comparing 4096 samples from the loop start with
+     * the 4096 samples one loop length later. The window spans several periods of any note, so a flat
+     * stretch of a low pulse wave is not taken for a period.
+     * The best length is accepted if the two differ by less than -40 dB, meaning the loop is inaudible.
+     *
+     * @return true if a loop was found, loopEnd being its last sample
+     */
+    static bool findLoop(const std::vector<float>& audio, int64_t searchStart, int64_t searchEnd, int64_t& loopStart, int64_t& loopEnd)
+    {
+        const int window = 4096;
+        const int minLength = 32;
+        const int maxLength = 8192;
+
+        searchEnd = std::min<int64_t>(searchEnd, static_cast<int64_t>(audio.size()));
+        int64_t maxUsable = searchEnd - searchStart - window;
+        if (searchStart < 0 || maxUsable < minLength)
+            return false;
+
+        const float* start = audio.data() + searchStart;
+        double energy = 0.0;
+        for (int i = 0; i < window; ++i)
+            energy += start[i] * start[i];
+        if (energy < 1.0e-6 * window)
+            return false; // Silent sustain, nothing worth looping
+
+        int bestLength = 0;
+        double bestError = 1.0e-4 * energy; // -40 dB
+        for (int length = minLength; length <= std::min<int64_t>(maxLength, maxUsable); ++length)
+        {
+            const float* later = start + length;
+            double error = 0.0;
+            for (int i = 0; i < window && error < bestError; ++i)
+            {
+                double difference = start[i] - later[i];
+                error += difference * difference;
+            }
+            if (error < bestError)
+            {
+                bestError = error;
+                bestLength = length;
+            }
+        }
+
+        if (bestLength == 0)
+            return false;
+
+        loopStart = searchStart;
+        loopEnd = searchStart + bestLength - 1;
+        return true;
+    }
+
+    /**
+     * @brief Resamples a looped sample so that its loop is a whole number of blocks long.
+     *
+     * The loop is stretched to the nearest multiple of the block size, and the sample before it by the
+     * same ratio, with 4-point Hermite interpolation. The loop is read periodically, so its seam stays
+     * seamless. The audio must still run past the loop end. Sets the tuning that restores the pitch.
+     */
+    static void fitLoopToBlocks(Sample& sample, int blockSize)
+    {
+        int64_t length = sample.loopEnd - sample.loopStart + 1;
+        int64_t fittedLength = std::max<int64_t>(blockSize, (length + blockSize / 2) / blockSize * blockSize);
+        if (fittedLength == length)
+            return;
+
+        double ratio = static_cast<double>(fittedLength) / static_cast<double>(length);
+        auto fittedStart = static_cast<int64_t>(std::lround(static_cast<double>(sample.loopStart) * ratio));
+        const auto& audio = sample.audio;
+        auto read = [&](int64_t i)
+        {
+            if (i >= sample.loopStart)
+                i = sample.loopStart + (i - sample.loopStart) % length; // Wrap inside the loop
+            return i < 0 ? 0.0f : audio[static_cast<size_t>(i)];
+        };
+
+        std::vector<float> fitted(static_cast<size_t>(fittedStart + fittedLength));
+        for (int64_t j = 0; j < static_cast<int64_t>(fitted.size()); ++j)
+        {
+            // Map so that fittedStart lands exactly on loopStart
+            double position = static_cast<double>(sample.loopStart) + static_cast<double>(j - fittedStart) / ratio;
+            auto i = static_cast<int64_t>(std::floor(position));
+            auto t = static_cast<float>(position - static_cast<double>(i));
+            float y0 = read(i - 1), y1 = read(i), y2 = read(i + 1), y3 = read(i + 2);
+
+            float c1 = 0.5f * (y2 - y0);
+            float c2 = y0 - 2.5f * y1 + 2.0f * y2 - 0.5f * y3;
+            float c3 = 0.5f * (y3 - y0) + 1.5f * (y1 - y2);
+            fitted[static_cast<size_t>(j)] = ((c3 * t + c2) * t + c1) * t + y1;
+        }
+
+        sample.audio = std::move(fitted);
+        sample.loopStart = fittedStart;
+        sample.loopEnd = fittedStart + fittedLength - 1;
+        sample.tune = 1200.0 * std::log2(ratio); // Stretched audio plays flat, the player raises it back
+    }
+
+    /// Writes one rendered sample in the codec of the settings. Returns false if the file cannot be created.
+    static bool writeSample(const Settings& settings, const std::string& directory, Sample& sample)
+    {
+        auto path = (std::filesystem::path(directory) / sample.fileName).string();
+        int numSamples = static_cast<int>(sample.audio.size());
+
+        switch (settings.codec)
+        {
+            case Codec::imaAdpcm:
+            {
+                AdpcmEncoder encoder;
+                if (! encoder.open(path, settings.sampleRate, sample.loopStart, sample.loopEnd))
+                    return false;
+                encoder.write(sample.audio.data(), numSamples);
+                sample.snr = encoder.getSnr();
+                return true;
+            }
+            case Codec::brr:
+            {
+                BrrEncoder encoder;
+                if (! encoder.open(path, sample.loopStart))
+                    return false;
+                encoder.write(sample.audio.data(), numSamples);
+                sample.snr = encoder.getSnr();
+                if (sample.loopStart >= 0)
+                {
+                    // The encoder delays the audio to put the loop on a block boundary
+                    sample.loopStart += encoder.getPadding();
+                    sample.loopEnd += encoder.getPadding();
+                }
+                return true;
+            }
+            default:
+            {
+                WavWriter writer;
+                if (! writer.open(path, settings.sampleRate, 1, settings.format))
+                    return false;
+                writer.writeMono(sample.audio.data(), numSamples);
+                return true;
+            }
+        }
+    }
+
+    /// Writes the SFZ mapping of the samples.
+    static std::string makeSfz(const ChiptuneParameters& parameters, const std::vector<Sample>& samples)
+    {
+        std::string sfz = "// Exported from ChiptunePractice\n\n<group>\n";
+        sfz += "ampeg_release=" + std::to_string(std::max(0.001f, parameters.get(ChiptuneParameters::release))) + "\n";
+
+        for (const auto& sample : samples)
+        {
+            sfz += "\n<region> sample=" + sample.fileName
+                 + " pitch_keycenter=" + std::to_string(sample.note)
+                 + " lokey=" + std::to_string(sample.lowKey) + " hikey=" + std::to_string(sample.highKey)
+                 + " lovel=" + std::to_string(sample.lowVelocity) + " hivel=" + std::to_string(sample.highVelocity);
+
+            if (std::lround(sample.tune) != 0)
+                sfz += " tune=" + std::to_string(std::lround(sample.tune));
+
+            if (sample.loopStart >= 0)
+                sfz += " loop_mode=loop_sustain loop_start=" + std::to_string(sample.loopStart)
+                     + " loop_end=" + std::to_string(sample.loopEnd);
+            else
+                sfz += " loop_mode=one_shot";
+        }
+        sfz += "\n";
+        return sfz;
+    }
+};
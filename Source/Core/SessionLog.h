@@ -0,0 +1,553 @@
+/*
+  ==============================================================================
+
+    SessionLog.h
+    Created: 26 Oct 2026 11:08:51am
+    Author:  70
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "ChiptuneParameters.h"
+#include "KeyZoneMap.h"
+#include "RenderQuality.h"
+
+/**
+ * @class SessionLog
+ *
+ * @brief The binary format of a session capture: everything the plugin fed the engine, block by block.
+ *
+ * A log starts with a header listing the parameter IDs, so a log still replays after parameters are
+ * added. Then come records, each one a 32-bit size, a type and its payload:
+ * - state records, written when the capture starts and whenever the state changes: the random seed, the
+ *   parameters, the key zones, the render quality, and a prepare record each time the engine is prepared.
+ *   The capture starts with an engine state record after its prepare record: the voices and effects as
+ *   they were, see ChiptuneEngine::saveState(), so a log can start while notes are sounding;
+ * - one block record per processBlock() call: its length, how long it took, the playhead, the render
+ *   quality, the bus layout and a hash of the output, followed by its events. An event is a MIDI
+ *   message or a parameter change, at a sample position.
+ * Parameters are logged as changes only: once the capture has started, a block where nothing moved costs
+ * about 55 bytes. Values are stored in the byte order of the machine, little-endian on every platform
+ * the plugin targets.
+ *
+ * BlockWriter encodes a block on the audio thread, into a fixed buffer. SessionPlayer replays a log.
+ */
+class SessionLog
+{
+public:
+    static constexpr uint32_t magic = 0x4c534843; // "CHSL"
+    static constexpr uint32_t version = 1;
+    static constexpr int numAuxBuses = 3;         // One per oscillator type, see ChiptuneEngine::numOscTypes.
+
+    enum RecordType : uint8_t
+    {
+        blockRecord = 1,
+        prepareRecord,
+        seedRecord,
+        parametersRecord,
+        keyZonesRecord,
+        qualityRecord,
+        engineStateRecord
+    };
+
+    enum EventType : uint8_t
+    {
+        midiEvent = 1,
+        parameterEvent
+    };
+
+    enum BlockFlags : uint8_t
+    {
+        isPlaying = 1,        // The host transport was running.
+        hasPosition = 2,      // The host gave a playhead position.
+        missedDeadline = 4,   // The block took longer than it lasts.
+        afterGap = 8,         // Blocks were lost before this one, the replay is no longer exact.
+        isNonRealtime = 16    // The host was rendering offline.
+    };
+
+    /// The fixed part of a block record.
+    struct BlockInfo
+    {
+        uint32_t numSamples = 0;
+        uint32_t elapsedNanoseconds = 0;   // Time processBlock() took.
+        uint8_t flags = 0;
+        int64_t timeInSamples = 0;         // Playhead position, if hasPosition.
+        double ppqPosition = 0.0;
+        double bpm = 0.0;
+        RenderQuality quality;
+        uint8_t numChannels = 0;           // Channels of the main bus.
+        uint8_t auxChannels[numAuxBuses] = {}; // Channels of each aux bus, 0 when disabled.
+        uint64_t outputHash = 0;           // hashOutput() of the main bus.
+    };
+
+    /// An event of a block.
+    struct Event
+    {
+        uint32_t position = 0;
+        EventType type = midiEvent;
+        const uint8_t* midiData = nullptr;
+        int midiSize = 0;
+        int parameterIndex = 0; // Index in the parameter IDs of the log header.
+        float value = 0.0f;
+    };
+
+    //==============================================================================
+    /// Writes the header: the magic, the version and the parameter IDs of this build.
+    static void writeHeader(std::vector<uint8_t>& out)
+    {
+        put(out, magic);
+        put(out, version);
+        put(out, static_cast<uint16_t>(ChiptuneParameters::numParameters));
+        for (int i = 0; i < ChiptuneParameters::numParameters; ++i)
+            putString(out, ChiptuneParameters::getId(i));
+    }
+
+    /**
+     * @brief Reads the header, mapping each parameter of the log to the index of the same ID in this build.
+     *
+     * @return the size of the header, or 0 if the data is not a session log
+     */
+    static size_t readHeader(const uint8_t* data, size_t size, std::vector<int>& parameterMap)
+    {
+        Reader reader { data, data + size };
+        uint32_t fileMagic = 0, fileVersion = 0;
+        uint16_t numParameters = 0;
+        if (! reader.get(fileMagic) || fileMagic != magic || ! reader.get(fileVersion) || fileVersion != version
+            || ! reader.get(numParameters))
+            return 0;
+
+        parameterMap.assign(numParameters, -1);
+        for (auto& index : parameterMap)
+        {
+            std::string id;
+            if (! reader.getString(id))
+                return 0;
+            index = ChiptuneParameters::indexOf(id.c_str());
+        }
+        return static_cast<size_t>(reader.position - data);
+    }
+
+    //==============================================================================
+    /// Appends a record holding one value: the seed (uint64_t) or the sample rate of a prepare (double).
+    template <typename T>
+    static void writeValueRecord(std::vector<uint8_t>& out, RecordType type, T value)
+    {
+        size_t start = beginRecord(out, type);
+        put(out, value);
+        endRecord(out, start);
+    }
+
+    /// Appends a record holding every parameter, in the order of the header.
+    static void writeParametersRecord(std::vector<uint8_t>& out, const ChiptuneParameters& parameters)
+    {
+        size_t start = beginRecord(out, parametersRecord);
+        putParameters(out, parameters);
+        endRecord(out, start);
+    }
+
+    /// Appends a record holding every key zone.
+    static void writeKeyZonesRecord(std::vector<uint8_t>& out, const KeyZoneMap& keyZones)
+    {
+        size_t start = beginRecord(out, keyZonesRecord);
+        put(out, static_cast<uint16_t>(keyZones.getNumZones()));
+        for (int i = 0; i < keyZones.getNumZones(); ++i)
+        {
+            const auto& zone = keyZones.getZone(i);
+            putString(out, zone.name);
+            put(out, static_cast<uint8_t>(zone.lowNote));
+            put(out, static_cast<uint8_t>(zone.highNote));
+            putParameters(out, zone.parameters);
+        }
+        endRecord(out, start);
+    }
+
+    /// Appends a record holding the running state of an engine, see ChiptuneEngine::saveState(). Call between render() calls.
+    template <typename Engine>
+    static void writeEngineStateRecord(std::vector<uint8_t>& out, Engine& engine)
+    {
+        size_t start = beginRecord(out, engineStateRecord);
+        engine.saveState(&out);
+        endRecord(out, start);
+    }
+
+    /// Appends a record holding a render quality.
+    static void writeQualityRecord(std::vector<uint8_t>& out, const RenderQuality& quality)
+    {
+        size_t start = beginRecord(out, qualityRecord);
+        putQuality(out, quality);
+        endRecord(out, start);
+    }
+
+    //==============================================================================
+    /**
+     * @class BlockWriter
+     *
+     * @brief Encodes one block record on the audio thread, in a fixed buffer: no allocation, no lock.
+     *
+     * Call begin(), then add the events in the order they are applied, then finish() once the block is
+     * rendered. If the events do not fit, the block is marked as overflowed and must be dropped.
+     */
+    class BlockWriter
+    {
+    public:
+        static constexpr size_t capacity = 32768;
+
+        void begin(const BlockInfo& info)
+        {
+            size = 0;
+            overflowed = false;
+            putRaw(uint32_t(0)); // Size, set by finish()
+            putRaw(static_cast<uint8_t>(blockRecord));
+            putRaw(info.numSamples);
+            elapsedOffset = size;
+            putRaw(info.elapsedNanoseconds);
+            flagsOffset = size;
+            putRaw(info.flags);
+            putRaw(info.timeInSamples);
+            putRaw(info.ppqPosition);
+            putRaw(info.bpm);
+            uint8_t quality[qualitySize];
+            encodeQuality(info.quality, quality);
+            putBytes(quality, qualitySize);
+            putRaw(info.numChannels);
+            putBytes(info.auxChannels, numAuxBuses);
+            hashOffset = size;
+            putRaw(info.outputHash);
+        }
+
+        void addMidi(int position, const uint8_t* data, int numBytes)
+        {
+            if (numBytes <= 0 || numBytes > 255)
+                return;
+            putRaw(static_cast<uint32_t>(position));
+            putRaw(static_cast<uint8_t>(midiEvent));
+            putRaw(static_cast<uint8_t>(numBytes));
+            putBytes(data, static_cast<size_t>(numBytes));
+        }
+
+        void addParameter(int position, int index, float value)
+        {
+            putRaw(static_cast<uint32_t>(position));
+            putRaw(static_cast<uint8_t>(parameterEvent));
+            putRaw(static_cast<uint8_t>(index));
+            putRaw(value);
+        }
+
+        /// Adds a parameter event for every value that differs from previous, and updates previous.
+        void addParameterChanges(int position, const ChiptuneParameters& current, ChiptuneParameters& previous)
+        {
+            for (int i = 0; i < ChiptuneParameters::numParameters; ++i)
+            {
+                auto index = static_cast<ChiptuneParameters::Index>(i);
+                if (current.get(index) != previous.get(index))
+                {
+                    addParameter(position, i, current.get(index));
+                    previous.set(index, current.get(index));
+                }
+            }
+        }
+
+        /// Completes the record. Returns false if it overflowed.
+        bool finish(uint32_t elapsedNanoseconds, uint8_t extraFlags, uint64_t outputHash)
+        {
+            if (overflowed)
+                return false;
+
+            auto recordSize = static_cast<uint32_t>(size);
+            std::memcpy(buffer, &recordSize, sizeof(recordSize));
+            std::memcpy(buffer + elapsedOffset, &elapsedNanoseconds, sizeof(elapsedNanoseconds));
+            buffer[flagsOffset] |= extraFlags;
+            std::memcpy(buffer + hashOffset, &outputHash, sizeof(outputHash));
+            return true;
+        }
+
+        const uint8_t* getData() const { return buffer; }
+        size_t getSize() const { return size; }
+
+    private:
+        uint8_t buffer[capacity];
+        size_t size = 0;
+        size_t elapsedOffset = 0, flagsOffset = 0, hashOffset = 0;
+        bool overflowed = false;
+
+        template <typename T>
+        void putRaw(T value) { putBytes(&value, sizeof(value)); }
+
+        void putBytes(const void* data, size_t numBytes)
+        {
+            if (size + numBytes > capacity)
+            {
+                overflowed = true;
+                return;
+            }
+            std::memcpy(buffer + size, data, numBytes);
+            size += numBytes;
+        }
+    };
+
+    //==============================================================================
+    /// Reads values from a byte range, failing instead of reading past its end.
+    struct Reader
+    {
+        const uint8_t* position;
+        const uint8_t* end;
+
+        template <typename T>
+        bool get(T& value) { return getBytes(&value, sizeof(T)); }
+
+        bool getBytes(void* dest, size_t numBytes)
+        {
+            if (static_cast<size_t>(end - position) < numBytes)
+                return false;
+            std::memcpy(dest, position, numBytes);
+            position += numBytes;
+            return true;
+        }
+
+        bool getString(std::string& text)
+        {
+            uint16_t length = 0;
+            if (! get(length) || static_cast<size_t>(end - position) < length)
+                return false;
+            text.assign(reinterpret_cast<const char*>(position), length);
+            position += length;
+            return true;
+        }
+    };
+
+    /// A record of a log, pointing into its data.
+    struct Record
+    {
+        RecordType type = blockRecord;
+        const uint8_t* payload = nullptr;
+        size_t size = 0;
+    };
+
+    /// Splits the record at the start of data. Returns the size of the whole record, or 0 if it is incomplete.
+    static size_t readRecord(const uint8_t* data, size_t size, Record& record)
+    {
+        uint32_t recordSize = 0;
+        if (size < 5)
+            return 0;
+        std::memcpy(&recordSize, data, sizeof(recordSize));
+        if (recordSize < 5 || recordSize > size)
+            return 0;
+
+        record.type = static_cast<RecordType>(data[4]);
+        record.payload = data + 5;
+        record.size = recordSize - 5;
+        return recordSize;
+    }
+
+    /// Reads the fixed part of a block record. Returns false if the record is too short.
+    static bool readBlockInfo(const Record& record, BlockInfo& info)
+    {
+        Reader reader { record.payload, record.payload + record.size };
+        uint8_t quality[qualitySize];
+        bool ok = reader.get(info.numSamples) && reader.get(info.elapsedNanoseconds) && reader.get(info.flags)
+               && reader.get(info.timeInSamples) && reader.get(info.ppqPosition) && reader.get(info.bpm)
+               && reader.getBytes(quality, qualitySize) && reader.get(info.numChannels)
+               && reader.getBytes(info.auxChannels, numAuxBuses) && reader.get(info.outputHash);
+        if (ok)
+            info.quality = decodeQuality(quality);
+        return ok;
+    }
+
+    /// Adds flags to a whole block record, e.g. afterGap to the first block of a flight recorder dump.
+    static void addBlockFlags(uint8_t* recordData, uint8_t flags)
+    {
+        recordData[5 + 4 + 4] |= flags; // After the size, the type, the length and the elapsed time
+    }
+
+    /// Iterates over the events of a block record.
+    class EventReader
+    {
+    public:
+        explicit EventReader(const Record& record)
+            : reader { record.payload + blockInfoSize, record.payload + record.size }
+        {
+            if (record.size < blockInfoSize)
+                reader.position = reader.end;
+        }
+
+        /// Reads the next event. Returns false at the end of the block.
+        bool next(Event& event)
+        {
+            uint8_t type = 0;
+            if (! reader.get(event.position) || ! reader.get(type))
+                return false;
+
+            event.type = static_cast<EventType>(type);
+            if (event.type == midiEvent)
+            {
+                uint8_t numBytes = 0;
+                if (! reader.get(numBytes) || reader.end - reader.position < numBytes)
+                    return false;
+                event.midiData = reader.position;
+                event.midiSize = numBytes;
+                reader.position += numBytes;
+                return true;
+            }
+
+            uint8_t index = 0;
+            if (! reader.get(index) || ! reader.get(event.value))
+                return false;
+            event.parameterIndex = index;
+            return true;
+        }
+
+    private:
+        Reader reader;
+    };
+
+    /// Reads a value record.
+    template <typename T>
+    static bool readValueRecord(const Record& record, T& value)
+    {
+        Reader reader { record.payload, record.payload + record.size };
+        return reader.get(value);
+    }
+
+    /// Reads a parameters record, using the parameter map of the header.
+    static bool readParametersRecord(const Record& record, const std::vector<int>& parameterMap, ChiptuneParameters& parameters)
+    {
+        Reader reader { record.payload, record.payload + record.size };
+        return getParameters(reader, parameterMap, parameters);
+    }
+
+    /// Reads a key zones record, replacing the zones of the map.
+    static bool readKeyZonesRecord(const Record& record, const std::vector<int>& parameterMap, KeyZoneMap& keyZones)
+    {
+        Reader reader { record.payload, record.payload + record.size };
+        uint16_t numZones = 0;
+        if (! reader.get(numZones))
+            return false;
+
+        keyZones.clear();
+        for (int i = 0; i < numZones; ++i)
+        {
+            std::string name;
+            uint8_t lowNote = 0, highNote = 0;
+            ChiptuneParameters parameters;
+            if (! reader.getString(name) || ! reader.get(lowNote) || ! reader.get(highNote)
+                || ! getParameters(reader, parameterMap, parameters))
+                return false;
+            keyZones.addZone(lowNote, highNote, parameters, name);
+        }
+        return true;
+    }
+
+    /// Reads a quality record.
+    static bool readQualityRecord(const Record& record, RenderQuality& quality)
+    {
+        if (record.size < qualitySize)
+            return false;
+        quality = decodeQuality(record.payload);
+        return true;
+    }
+
+    //==============================================================================
+    /**
+     * @brief Hashes rendered audio bit for bit, so a replay can be checked against the capture.
+     *
+     * FNV-1a over the sample words: ~1.5 us for a stereo block of 256 samples, next to a 5.8 ms deadline.
+     */
+    static uint64_t hashOutput(const float* const* channels, int numChannels, int startSample, int numSamples)
+    {
+        uint64_t hash = 0xcbf29ce484222325;
+        for (int chan = 0; chan < numChannels; ++chan)
+        {
+            for (int i = startSample; i < startSample + numSamples; ++i)
+            {
+                uint32_t bits;
+                std::memcpy(&bits, channels[chan] + i, sizeof(bits));
+                hash = (hash ^ bits) * 0x100000001b3;
+            }
+        }
+        return hash;
+    }
+
+private:
+    static constexpr size_t qualitySize = 5;
+    static constexpr size_t blockInfoSize = 4 + 4 + 1 + 8 + 8 + 8 + qualitySize + 1 + numAuxBuses + 8;
+
+public:
+
+    template <typename T>
+    static void put(std::vector<uint8_t>& out, T value)
+    {
+        auto* bytes = reinterpret_cast<const uint8_t*>(&value);
+        out.insert(out.end(), bytes, bytes + sizeof(T));
+    }
+
+    static void putString(std::vector<uint8_t>& out, const std::string& text)
+    {
+        put(out, static_cast<uint16_t>(text.size()));
+        out.insert(out.end(), text.begin(), text.end());
+    }
+
+    static void putParameters(std::vector<uint8_t>& out, const ChiptuneParameters& parameters)
+    {
+        for (int i = 0; i < ChiptuneParameters::numParameters; ++i)
+            put(out, parameters.get(static_cast<ChiptuneParameters::Index>(i)));
+    }
+
+    static bool getParameters(Reader& reader, const std::vector<int>& parameterMap, ChiptuneParameters& parameters)
+    {
+        for (int index : parameterMap)
+        {
+            float value = 0.0f;
+            if (! reader.get(value))
+                return false;
+            if (index >= 0)
+                parameters.set(static_cast<ChiptuneParameters::Index>(index), value);
+        }
+        return true;
+    }
+
+    static void encodeQuality(const RenderQuality& quality, uint8_t* bytes)
+    {
+        bytes[0] = quality.bandLimited ? 1 : 0;
+        bytes[1] = static_cast<uint8_t>(quality.controlRateDivider);
+        bytes[2] = static_cast<uint8_t>(quality.maxVoices);
+        bytes[3] = static_cast<uint8_t>(quality.oversampling);
+        bytes[4] = static_cast<uint8_t>(quality.delayInterpolation);
+    }
+
+    static RenderQuality decodeQuality(const uint8_t* bytes)
+    {
+        RenderQuality quality;
+        quality.bandLimited = bytes[0] != 0;
+        quality.controlRateDivider = bytes[1];
+        quality.maxVoices = bytes[2];
+        quality.oversampling = bytes[3];
+        quality.delayInterpolation = bytes[4];
+        return quality;
+    }
+
+    static void putQuality(std::vector<uint8_t>& out, const RenderQuality& quality)
+    {
+        uint8_t bytes[qualitySize];
+        encodeQuality(quality, bytes);
+        out.insert(out.end(), bytes, bytes + qualitySize);
+    }
+
+    static size_t beginRecord(std::vector<uint8_t>& out, RecordType type)
+    {
+        size_t start = out.size();
+        put(out, uint32_t(0));
+        put(out, static_cast<uint8_t>(type));
+        return start;
+    }
+
+    static void endRecord(std::vector<uint8_t>& out, size_t start)
+    {
+        auto recordSize = static_cast<uint32_t>(out.size() - start);
+        std::memcpy(out.data() + start, &recordSize, sizeof(recordSize));
+    }
+};
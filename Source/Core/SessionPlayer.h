@@ -0,0 +1,313 @@
+/*
+  ==============================================================================
+
+    SessionPlayer.h
+    Created: 26 Oct 2026 2:37:12pm
+    Author:  70
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+#if defined(__SSE__) || defined(_M_X64) || defined(_M_IX86_FP)
+ #include <xmmintrin.h>
+#endif
+#include "ChiptuneEngine.h"
+#include "SessionLog.h"
+
+/**
+ * @class SessionPlayer
+ *
+ * @brief Replays a session log (see SessionLog) through a ChiptuneEngine, the way the plugin's processBlock() fed it.
+ *
+ * Each block is rendered in the segments the plugin rendered it in: quality first, then the events in
+ * order, where a MIDI event first renders up to its position and a parameter change applies at once.
+ * The output of every block is hashed and compared with the hash of the capture, so a replay tells
+ * whether it reproduced the session bit for bit. Denormals are flushed, as in the plugin.
+ *
+ * The engine is rebuilt by rewind(), so every pass over the log starts from the same state. A log that
+ * started while the plugin was playing restores the voices and effects from its engine state record;
+ * if that record comes from another build, the replay goes on from silence and is no longer exact.
+ */
+class SessionPlayer
+{
+public:
+    /// A replayed block.
+    struct Block
+    {
+        SessionLog::BlockInfo info;   // As captured.
+        int64_t index = 0;            // Number of the block in the log, from 0.
+        uint64_t outputHash = 0;      // Hash of the replayed main output.
+        bool matches = false;         // True if the replay produced the captured output.
+        double seconds = 0.0;         // Time the replay of the block took.
+    };
+
+    SessionPlayer() { rewind(); }
+
+    /// Reads a log file. Returns false if it cannot be read or is not a session log.
+    bool load(const std::string& path)
+    {
+        std::ifstream stream(path, std::ios::binary);
+        if (! stream)
+            return false;
+        std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+        return open(std::move(bytes));
+    }
+
+    /// Takes a log held in memory. Returns false if it is not a session log.
+    bool open(std::vector<uint8_t> bytes)
+    {
+        data = std::move(bytes);
+        headerSize = SessionLog::readHeader(data.data(), data.size(), parameterMap);
+        rewind();
+        return headerSize > 0;
+    }
+
+    /// Starts again from the first record, with a new engine.
+    void rewind()
+    {
+        engine = std::make_unique<ChiptuneEngine>();
+        position = headerSize;
+        numBlocks = 0;
+        numMismatches = 0;
+        exact = true;
+    }
+
+    /**
+     * @brief Applies the records up to the next block, and renders it.
+     *
+     * @return false at the end of the log, or if the rest of it is damaged
+     */
+    bool next(Block& block)
+    {
+        SessionLog::Record record;
+        while (size_t recordSize = SessionLog::readRecord(data.data() + position, data.size() - position, record))
+        {
+            position += recordSize;
+            if (record.type == SessionLog::blockRecord)
+            {
+                if (! SessionLog::readBlockInfo(record, block.info))
+                    return false;
+                play(record, block);
+                return true;
+            }
+            applyState(record);
+        }
+        return false;
+    }
+
+    /// Returns the engine, e.g. for its sample rate and parameters after a block.
+    ChiptuneEngine& getEngine() { return *engine; }
+
+    /// Returns the sample rate of the last prepare record.
+    double getSampleRate() const { return sampleRate; }
+
+    /// Returns a channel of the main output of the last block, nullptr past its channels.
+    const float* getOutput(int channel) const
+    {
+        return channel < numOutputChannels ? mainOutput[channel].data() : nullptr;
+    }
+
+    /// Returns the number of main channels of the last block.
+    int getNumOutputChannels() const { return numOutputChannels; }
+
+    /// Returns how many blocks did not reproduce the capture.
+    int64_t getNumMismatches() const { return numMismatches; }
+
+    /// Returns false once a block followed lost blocks, or the engine state did not restore, after which the replay can no longer match.
+    bool isExact() const { return exact; }
+
+    /// Returns the size of the log, and how much of it has been replayed, in bytes.
+    size_t getSize() const { return data.size(); }
+    size_t getPosition() const { return position; }
+
+    //==============================================================================
+    /// Flushes denormals to zero while in scope, as juce::ScopedNoDenormals does in processBlock().
+    class ScopedFlushDenormals
+    {
+    public:
+        ScopedFlushDenormals()
+        {
+           #if defined(__SSE__) || defined(_M_X64) || defined(_M_IX86_FP)
+            previous = _mm_getcsr();
+            _mm_setcsr(previous | 0x8040); // Flush to zero and denormals are zero
+           #elif defined(__aarch64__)
+            asm volatile("mrs %0, fpcr" : "=r"(previous));
+            asm volatile("msr fpcr, %0" : : "r"(previous | (1 << 24)));
+           #endif
+        }
+
+        ~ScopedFlushDenormals()
+        {
+           #if defined(__SSE__) || defined(_M_X64) || defined(_M_IX86_FP)
+            _mm_setcsr(static_cast<unsigned int>(previous));
+           #elif defined(__aarch64__)
+            asm volatile("msr fpcr, %0" : : "r"(previous));
+           #endif
+        }
+
+    private:
+       #if defined(__aarch64__)
+        uint64_t previous = 0;
+       #else
+        unsigned int previous = 0;
+       #endif
+    };
+
+private:
+    static_assert(SessionLog::numAuxBuses == ChiptuneEngine::numOscTypes, "one aux bus per oscillator type");
+
+    std::unique_ptr<ChiptuneEngine> engine;
+    std::vector<uint8_t> data;
+    std::vector<int> parameterMap;    // Index in this build of each parameter of the log, -1 if it was removed.
+    size_t headerSize = 0;
+    size_t position = 0;              // Offset of the next record.
+    double sampleRate = 44100.0;
+    int64_t numBlocks = 0;
+    int64_t numMismatches = 0;
+    bool exact = true;
+
+    std::vector<float> mainOutput[ChiptuneEngine::maxChannels];
+    std::vector<float> auxOutput[SessionLog::numAuxBuses][ChiptuneEngine::maxChannels];
+    int numOutputChannels = 0;
+
+    /// Applies a state record to the engine.
+    void applyState(const SessionLog::Record& record)
+    {
+        switch (record.type)
+        {
+            case SessionLog::prepareRecord:
+                if (SessionLog::readValueRecord(record, sampleRate))
+                    engine->prepare(sampleRate);
+                break;
+
+            case SessionLog::seedRecord:
+            {
+                uint64_t seed = 0;
+                if (SessionLog::readValueRecord(record, seed))
+                    engine->setRandomSeed(seed);
+                break;
+            }
+
+            case SessionLog::parametersRecord:
+            {
+                ChiptuneParameters parameters = engine->getParameters();
+                if (SessionLog::readParametersRecord(record, parameterMap, parameters))
+                    engine->setParameters(parameters);
+                break;
+            }
+
+            case SessionLog::keyZonesRecord:
+                SessionLog::readKeyZonesRecord(record, parameterMap, engine->getKeyZones());
+                break;
+
+            case SessionLog::qualityRecord:
+            {
+                RenderQuality quality;
+                if (SessionLog::readQualityRecord(record, quality) && quality != engine->getRenderQuality())
+                    engine->setRenderQuality(quality);
+                break;
+            }
+
+            case SessionLog::engineStateRecord:
+                if (! engine->loadState(record.payload, record.size))
+                    exact = false;
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    /// Renders a block record, mirroring processBlock().
+    void play(const SessionLog::Record& record, Block& block)
+    {
+        const auto& info = block.info;
+        int numSamples = static_cast<int>(info.numSamples);
+        numOutputChannels = std::min<int>(info.numChannels, ChiptuneEngine::maxChannels);
+
+        // Size the buffers before the clock starts
+        for (auto& channel : mainOutput)
+            if (static_cast<int>(channel.size()) < numSamples)
+                channel.resize(static_cast<size_t>(numSamples));
+        for (auto& bus : auxOutput)
+            for (auto& channel : bus)
+                if (static_cast<int>(channel.size()) < numSamples)
+                    channel.resize(static_cast<size_t>(numSamples));
+
+        if (info.flags & SessionLog::afterGap)
+            exact = false;
+
+        ScopedFlushDenormals noDenormals;
+        auto startTime = std::chrono::steady_clock::now();
+
+        if (info.quality != engine->getRenderQuality())
+            engine->setRenderQuality(info.quality);
+
+        int startSample = 0;
+        SessionLog::EventReader events(record);
+        SessionLog::Event event;
+        while (events.next(event))
+        {
+            if (event.type == SessionLog::parameterEvent)
+            {
+                int index = event.parameterIndex < static_cast<int>(parameterMap.size()) ? parameterMap[event.parameterIndex] : -1;
+                if (index >= 0)
+                    engine->setParameter(static_cast<ChiptuneParameters::Index>(index), event.value);
+                continue;
+            }
+
+            int eventPos = std::clamp(static_cast<int>(event.position), startSample, numSamples);
+            if (eventPos > startSample)
+            {
+                renderSegment(info, startSample, eventPos - startSample);
+                startSample = eventPos;
+            }
+            engine->handleMidi(event.midiData, event.midiSize);
+        }
+
+        if (startSample < numSamples)
+            renderSegment(info, startSample, numSamples - startSample);
+
+        block.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+        float* channels[ChiptuneEngine::maxChannels] = {};
+        for (int chan = 0; chan < numOutputChannels; ++chan)
+            channels[chan] = mainOutput[chan].data();
+        block.outputHash = SessionLog::hashOutput(channels, numOutputChannels, 0, numSamples);
+        block.matches = block.outputHash == info.outputHash;
+        block.index = numBlocks++;
+        if (! block.matches)
+            ++numMismatches;
+    }
+
+    /// Renders a stretch of the block to the main output and the aux outputs the capture had enabled.
+    void renderSegment(const SessionLog::BlockInfo& info, int startSample, int numSamples)
+    {
+        float* channels[ChiptuneEngine::maxChannels] = {};
+        for (int chan = 0; chan < numOutputChannels; ++chan)
+            channels[chan] = mainOutput[chan].data() + startSample;
+
+        float* auxChannels[SessionLog::numAuxBuses][ChiptuneEngine::maxChannels] = {};
+        ChiptuneEngine::AuxOutput auxOutputs[ChiptuneEngine::numOscTypes];
+        for (int type = 0; type < SessionLog::numAuxBuses; ++type)
+        {
+            if (info.auxChannels[type] == 0)
+                continue;
+
+            auxOutputs[type].numChannels = std::min<int>(info.auxChannels[type], ChiptuneEngine::maxChannels);
+            for (int chan = 0; chan < auxOutputs[type].numChannels; ++chan)
+                auxChannels[type][chan] = auxOutput[type][chan].data() + startSample;
+            auxOutputs[type].channels = auxChannels[type];
+        }
+
+        engine->render(channels, numOutputChannels, numSamples, auxOutputs);
+    }
+};
@@ -0,0 +1,970 @@
+/*
+  ==============================================================================
+
+    SfxRuntime.h
+    Created: 19 Oct 2026 10:02:17am
+    Author:  70
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "ChiptuneVoice.h"
+#include "ChiptuneParameters.h"
+#include "ChiptuneRandom.h"
+#include "FixedHashMap.h"
+#include "KeyZoneMap.h"
+#include "MpscQueue.h"
+#include "RenderCache.h"
+#include "SpscQueue.h"
+
+/**
+ * @class SfxRuntime
+ *
+ * @brief Sound effect player for games, able to track thousands of concurrent chip SFX.
+ *
+ * Games fire far more short sounds than a synthesizer has voices. The runtime separates the two:
+ * every triggered sound becomes a lightweight logical instance (a few counters), and only the most
+ * important instances are given one of the real ChiptuneVoices and rendered. The others are virtual:
+ * they keep their position, and when a real voice frees up they resume where they would be had they
+ * been playing all along (see ChiptuneVoice::advance()), or end silently once their time is up. A voice
+ * far behind its instance catches up over several blocks, staying silent until it is there.
+ *
+ * At every render() call the instances are ranked by priority, then by their estimated level
+ * (gain times the ADSR level at their position). Instances below the audibility threshold are never
+ * rendered. The ranked instances are admitted to the real voices until either the voices or the CPU
+ * budget run out, skipping those that do not fit what is left of the budget; the costs of rendering and
+ * of catching up are measured while rendering, so the budget holds on any machine.
+ * A real voice that loses its place fades out over one block instead of being cut.
+ *
+ * Identical one-shots (same sound, note and hold time) are served from a RenderCache: the sound is
+ * rendered once, and every trigger then just mixes the rendered buffer, without taking a voice. Sounds
+ * that differ at every trigger, or are longer than the cacheable length, are always synthesized live.
+ *
+ * The rendering never happens on the audio thread. A sound missing from the cache plays live, and is
+ * passed to the cache worker, a thread of the game's that calls fillCache() (e.g. once per frame). The
+ * worker owns the RenderCache, its LRU order and its memory, and renders into buffers of its own; the
+ * finished buffers come back through a second queue, which render() applies to the runtime's own copy
+ * of the cache index. The two threads only share these wait-free queues (see SpscQueue), so neither
+ * ever waits for the other, and buffers are only allocated and freed on the worker.
+ *
+ * Sounds are registered once with addSound(), which copies a parameter snapshot, and then played any
+ * number of times. play(), release(), stop() and stopAll() may be called from any thread, such as the
+ * game's update thread: they only push a command into a lock-free queue (see MpscQueue), which render()
+ * runs at its start, and play() takes its handle from an atomic counter, so that it can return it at
+ * once. fillCache() and precache() run on the cache worker, getCacheStats() anywhere. Everything else
+ * is not thread safe: call it from the audio thread, or while no other thread uses the runtime.
+ */
+class SfxRuntime
+{
+public:
+    /// Handle returned by play(). Stays safe to use after the instance has ended, or if it was dropped.
+    using Handle = int32_t;
+    static constexpr Handle invalidHandle = -1;
+
+    /**
+     * @brief Constructs the runtime. Allocates everything, so construct it off the audio thread.
+     *
+     * @param numRealVoices  number of voices that can actually be rendered at once
+     * @param maxInstances   number of sounds that can be tracked at once, playing or virtual
+     */
+    explicit SfxRuntime(int numRealVoices = 32, int maxInstances = 4096)
+        : instances(static_cast<size_t>(std::max(1, maxInstances))),
+          commands(maxCommands),
+          instanceHandles(2 * instances.size()),
+          cachedSounds(2 * maxCachedSounds),
+          cacheRequests(maxCacheRequests),
+          cacheTouches(maxCacheRequests),
+          cacheUpdates(maxCachedSounds)
+    {
+        for (int i = 0; i < numRealVoices; ++i)
+        {
+            voices.push_back(std::make_unique<ChiptuneVoice>(noLiveParameters, noKeyZones));
+            voiceOwner.push_back(-1);
+        }
+
+        freeInstances.reserve(instances.size());
+        for (int i = static_cast<int>(instances.size()) - 1; i >= 0; --i)
+            freeInstances.push_back(i);
+        ranking.reserve(instances.size());
+
+        prepare(sampleRate, blockSize);
+    }
+
+    /// Prepares the runtime for playback, stopping every sound and emptying the cache. Allocates, so call it
+    /// while no other thread uses the runtime.
+    void prepare(double newSampleRate, int maximumBlockSize)
+    {
+        sampleRate = newSampleRate;
+        blockSize = std::max(1, maximumBlockSize);
+        scratch.assign(static_cast<size_t>(blockSize), 0.0f);
+
+        for (int i = 0; i < getNumRealVoices(); ++i)
+        {
+            voices[i]->stopNote(false);
+            voices[i]->setSampleRate(sampleRate);
+            voices[i]->setRandomSeed(ChiptuneRandom::deriveSeed(randomSeed, static_cast<uint64_t>(i)));
+            voiceOwner[i] = -1;
+        }
+        stopAllInstances();
+        commands.clear();
+        cachedSounds.clear();
+        cacheRequests.clear();
+        cacheTouches.clear();
+        cacheUpdates.clear();
+        unsentUpdates.clear();
+        cache.clear();
+        cacheStats.reset();
+    }
+
+    //==============================================================================
+    /// Registers a sound, returning its index for play(). Allocates, so add the sounds up front.
+    int addSound(const ChiptuneParameters& parameters)
+    {
+        sounds.push_back(parameters);
+        return static_cast<int>(sounds.size()) - 1;
+    }
+
+    /// Returns the parameters of a registered sound, to edit them. New instances use the edited values.
+    ChiptuneParameters& getSound(int soundIndex) { return sounds[soundIndex]; }
+
+    /// Returns the number of registered sounds.
+    int getNumSounds() const { return static_cast<int>(sounds.size()); }
+
+    //==============================================================================
+    /**
+     * @brief Triggers a sound, from any thread. The sound starts at the next render().
+     *
+     * If every instance is in use then, the lowest ranked instance is dropped to make room, unless it has
+     * a higher priority than the new sound, in which case the new sound is dropped instead and its handle
+     * is stale from the start. A cacheable sound missing from the cache plays live this time, and is
+     * queued for fillCache(). Never allocates or waits for render().
+     *
+     * @param soundIndex      sound returned by addSound()
+     * @param midiNoteNumber  pitch of the sound
+     * @param gain            linear gain, also used to judge how audible the sound is
+     * @param priority        higher priorities are always rendered before lower ones
+     * @param holdSeconds     time before the note is released; the sound then lasts for its release time
+     * @return a handle to the instance, or invalidHandle if the arguments are invalid or the command
+     *         queue is full (1024 commands between two render() calls)
+     */
+    Handle play(int soundIndex, int midiNoteNumber, float gain = 1.0f, int priority = 0, float holdSeconds = 0.1f)
+    {
+        if (soundIndex < 0 || soundIndex >= getNumSounds() || midiNoteNumber < 0 || midiNoteNumber > 127)
+            return invalidHandle;
+
+        auto handle = static_cast<Handle>(nextHandle.fetch_add(1, std::memory_order_relaxed) & 0x7fffffffu);
+        if (! commands.push({ Command::playSound, handle, soundIndex, midiNoteNumber, gain, priority, holdSeconds }))
+            return invalidHandle;
+        return handle;
+    }
+
+    /**
+     * @brief Releases a sound early, letting it ring out for its release time. From any thread, taking effect at the next render().
+     *
+     * A sound playing from the cache is released cachedReleaseDelay later, by switching to the rendering
+     * of the same sound released there, which matches it sample for sample up to there. The cache worker
+     * renders it if the cache does not have it; if it is not back in time, the sound carries on from a
+     * live voice instead.
+     */
+    void release(Handle handle) { commands.push({ Command::releaseSound, handle }); }
+
+    /// Stops a sound immediately. From any thread, taking effect at the next render().
+    void stop(Handle handle) { commands.push({ Command::stopSound, handle }); }
+
+    /// Stops every sound immediately. From any thread, taking effect at the next render().
+    void stopAll() { commands.push({ Command::stopAllSounds }); }
+
+    /// Returns true while the sound is playing or tracked virtually. Call it from the audio thread.
+    bool isPlaying(Handle handle) const { return getInstance(handle) != nullptr; }
+
+    /// Returns true if the sound is currently rendered by a real voice. Call it from the audio thread.
+    bool isReal(Handle handle) const
+    {
+        auto* instance = getInstance(handle);
+        return instance != nullptr && instance->voice >= 0;
+    }
+
+    //==============================================================================
+    /**
+     * @brief Sets the time render() may spend on the voices, in microseconds per call.
+     *
+     * Zero (the default) disables the limit, so only the number of real voices bounds the cost. With a
+     * budget, fewer voices are admitted when rendering gets slower, whatever the reason.
+     */
+    void setCpuBudget(double microsecondsPerBlock) { cpuBudgetMicroseconds = std::max(0.0, microsecondsPerBlock); }
+
+    /// Sets the level below which a sound is not worth rendering. The default is -60 dB.
+    void setAudibilityThreshold(float newThreshold) { audibilityThreshold = newThreshold; }
+
+    /// Enables or disables serving repeated one-shots from the render cache. Enabled by default.
+    void setCacheEnabled(bool shouldBeEnabled) { cacheEnabled = shouldBeEnabled; }
+
+    /// Sets the longest sound, release included, that is rendered into the cache. The default is 2 seconds.
+    void setMaxCachedLength(double seconds) { maxCachedSeconds = seconds; }
+
+    /**
+     * @brief Renders a sound into the cache ahead of time, so that its first play() is cheap.
+     *
+     * Renders and allocates: call it from the cache worker, or before playback starts. The sound reaches
+     * the audio thread's copy of the cache at the next render().
+     */
+    void precache(int soundIndex, int midiNoteNumber, float holdSeconds = 0.1f)
+    {
+        if (soundIndex < 0 || soundIndex >= getNumSounds() || midiNoteNumber < 0 || midiNoteNumber > 127)
+            return;
+
+        const auto& parameters = sounds[soundIndex];
+        auto holdSamples = std::max<int64_t>(0, static_cast<int64_t>(holdSeconds * sampleRate));
+        if (fitsCache(getLifeSamples(parameters, holdSamples)) && RenderCache::isCacheable(parameters))
+            renderIntoCache(RenderCache::makeKey(parameters, midiNoteNumber, holdSamples, sampleRate), parameters, midiNoteNumber, holdSamples);
+        sendCacheUpdates();
+    }
+
+    /**
+     * @brief Runs the cache worker: renders the sounds the audio thread did not find in the cache into it.
+     *
+     * Also renders the releases that release() asked for, applies the LRU order of the hits, and frees
+     * the evicted buffers nothing plays any more. Renders and allocates: call it from one worker thread,
+     * e.g. once per game frame. It may run at the same time as render(). Up to 256 sounds are queued
+     * between calls; later misses are not cached until they miss again.
+     */
+    void fillCache()
+    {
+        cache.setMaxBytes(cacheMemoryLimit.load(std::memory_order_relaxed));
+        queueEvictions();
+
+        uint64_t key;
+        while (cacheTouches.pop(key))
+            cache.touch(key);
+
+        CacheRequest request;
+        while (cacheRequests.pop(request))
+            renderIntoCache(request.key, request.parameters, request.note, request.holdSamples);
+
+        sendCacheUpdates();
+        cache.releaseRetired();
+
+        const auto& stats = cache.getStats();
+        cacheStats.evictions.store(stats.evictions, std::memory_order_relaxed);
+        cacheStats.numEntries.store(stats.numEntries, std::memory_order_relaxed);
+        cacheStats.bytesUsed.store(stats.bytesUsed, std::memory_order_relaxed);
+    }
+
+    /// Sets the memory the render cache may use (8 MB by default). The cache worker applies it at its next fillCache().
+    void setCacheMemoryLimit(size_t maxBytes) { cacheMemoryLimit.store(maxBytes, std::memory_order_relaxed); }
+
+    /// Returns the render cache statistics: the lookups as counted by play(), the memory as of the last fillCache(). Safe from any thread.
+    RenderCache::Stats getCacheStats() const
+    {
+        RenderCache::Stats stats;
+        stats.hits = cacheStats.hits.load(std::memory_order_relaxed);
+        stats.misses = cacheStats.misses.load(std::memory_order_relaxed);
+        stats.uncacheable = cacheStats.uncacheable.load(std::memory_order_relaxed);
+        stats.evictions = cacheStats.evictions.load(std::memory_order_relaxed);
+        stats.numEntries = cacheStats.numEntries.load(std::memory_order_relaxed);
+        stats.bytesUsed = cacheStats.bytesUsed.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+    /// Sets the seed of the real voices' random streams, taking effect at the next prepare().
+    void setRandomSeed(uint64_t newSeed) { randomSeed = newSeed; }
+
+    //==============================================================================
+    /**
+     * @brief Renders every real voice, overwriting the output buffers. Call it from the audio thread.
+     *
+     * @param outputs      array of channel pointers, the sounds are mono and written to every channel
+     * @param numChannels  number of channels
+     * @param numSamples   number of samples to render
+     */
+    void render(float* const* outputs, int numChannels, int numSamples)
+    {
+        for (int chan = 0; chan < numChannels; ++chan)
+            std::fill(outputs[chan], outputs[chan] + numSamples, 0.0f);
+
+        runCommands();
+        applyCacheUpdates();
+
+        for (int start = 0; start < numSamples; start += blockSize)
+        {
+            int n = std::min(blockSize, numSamples - start);
+            resolveCachedReleases();
+            assignVoices(n);
+            renderVoices(outputs, numChannels, start, n);
+            mixCachedInstances(outputs, numChannels, start, n);
+            advanceInstances(n);
+        }
+    }
+
+    //==============================================================================
+    /// Returns the number of sounds being tracked, playing or virtual.
+    int getNumInstances() const { return numInstances; }
+
+    /// Returns the number of sounds rendered by the last render() call.
+    int getNumRendered() const { return numRendered; }
+
+    /// Returns the number of real voices.
+    int getNumRealVoices() const { return static_cast<int>(voices.size()); }
+
+    /// Returns the measured cost of rendering one voice for one sample, in microseconds.
+    double getVoiceCostPerSample() const { return voiceCostPerSample; }
+
+    /// Returns the measured cost of catching a voice up by one sample, in microseconds.
+    double getCatchUpCostPerSample() const { return catchUpCostPerSample; }
+
+private:
+    /// A triggered sound, playing on a real voice or tracked virtually.
+    struct Instance
+    {
+        bool active = false;
+        Handle handle = invalidHandle;
+        int sound = 0;
+        int note = 60;
+        float gain = 1.0f;
+        int priority = 0;
+        int64_t elapsed = 0;       // Samples played so far, rendered or not.
+        int64_t holdSamples = 0;   // Position of the note-off.
+        int64_t lifeSamples = 0;   // Position where the release has ended.
+        int voice = -1;            // Real voice rendering this instance, -1 if virtual.
+        int64_t voicePosition = 0; // Position the voice has reached, behind elapsed while it catches up.
+        int64_t catchUpAllowance = 0; // Catch-up the voice may do in the coming block.
+        float rank = 0.0f;         // Estimated level, refreshed before every block.
+        RenderCache::Buffer cached; // Rendered sound if it came from the cache, played without a voice.
+        int64_t releasePosition = -1; // Where a released cached sound switches to its release rendering, -1 if not released.
+        uint64_t releaseKey = 0;      // Cache key of that rendering.
+    };
+
+    static constexpr int64_t maxCatchUpSamples = 16384; // Catch-up a voice may do in one block.
+    static constexpr size_t maxCommands = 1024;
+    static constexpr size_t maxCacheRequests = 256;
+    static constexpr size_t maxCachedSounds = 1024;     // Entries of the render cache, so the audio thread's copy never fills up.
+    static constexpr double cachedReleaseDelay = 0.05;  // Seconds a released cached sound holds, for the worker to render its release.
+
+    /// A call to play(), release(), stop() or stopAll(), for render() to run.
+    struct Command
+    {
+        enum Type { playSound, releaseSound, stopSound, stopAllSounds };
+
+        Type type = playSound;
+        Handle handle = invalidHandle;
+        int sound = 0;
+        int note = 60;
+        float gain = 1.0f;
+        int priority = 0;
+        float holdSeconds = 0.0f;
+    };
+
+    /// A sound the audio thread did not find in the cache, for the worker to render.
+    struct CacheRequest
+    {
+        uint64_t key = 0;
+        int note = 60;
+        int64_t holdSamples = 0;
+        ChiptuneParameters parameters; // A copy, so the worker never reads the sounds.
+    };
+
+    /// A change of the render cache, for the audio thread's copy of its index.
+    struct CacheUpdate
+    {
+        uint64_t key = 0;
+        RenderCache::Buffer samples; // The rendered sound, or nullptr if it was evicted.
+    };
+
+    /// Cache statistics, counted by the audio thread (lookups) and the worker (memory).
+    struct SharedCacheStats
+    {
+        std::atomic<uint64_t> hits { 0 }, misses { 0 }, uncacheable { 0 }, evictions { 0 };
+        std::atomic<size_t> numEntries { 0 }, bytesUsed { 0 };
+
+        void reset()
+        {
+            for (auto* counter : { &hits, &misses, &uncacheable, &evictions })
+                counter->store(0);
+            numEntries.store(0);
+            bytesUsed.store(0);
+        }
+    };
+
+    ChiptuneParameters noLiveParameters; // Sounds always play their own snapshot, these are never used.
+    KeyZoneMap noKeyZones;
+
+    std::vector<ChiptuneParameters> sounds;
+    std::vector<Instance> instances;
+    MpscQueue<Command> commands;       // Filled by any thread, run by render().
+    std::atomic<uint32_t> nextHandle { 0 };
+    FixedHashMap<int> instanceHandles; // Instance of each handle that is playing.
+    std::vector<int> freeInstances;
+    std::vector<int> ranking;        // Active instances, best first.
+    std::vector<std::unique_ptr<ChiptuneVoice>> voices;
+    std::vector<int> voiceOwner;     // Instance rendered by each voice, -1 if free.
+    std::vector<float> scratch;      // Mono output of one voice.
+
+    // Audio thread side of the cache
+    FixedHashMap<RenderCache::Buffer> cachedSounds; // Copy of the cache index, updated from cacheUpdates.
+    SpscQueue<CacheRequest> cacheRequests; // Misses, audio thread to worker.
+    SpscQueue<uint64_t> cacheTouches;      // Hits, audio thread to worker, for the LRU order.
+    SpscQueue<CacheUpdate> cacheUpdates;   // Rendered and evicted sounds, worker to audio thread.
+    SharedCacheStats cacheStats;
+
+    // Worker side of the cache
+    RenderCache cache { 8u << 20, maxCachedSounds };
+    std::vector<float> cacheScratch;
+    std::vector<CacheUpdate> unsentUpdates; // Updates waiting for room in cacheUpdates, oldest first.
+    std::atomic<size_t> cacheMemoryLimit { 8u << 20 };
+
+    bool cacheEnabled = true;
+    double maxCachedSeconds = 2.0;
+
+    double sampleRate = 44100.0;
+    int blockSize = 512;
+    uint64_t randomSeed = 0x53465821;
+    double cpuBudgetMicroseconds = 0.0;
+    double voiceCostPerSample = 0.05; // Running average, in microseconds.
+    double catchUpCostPerSample = 0.005; // Running average of ChiptuneVoice::advance(), in microseconds.
+    float audibilityThreshold = 0.001f;
+    int numInstances = 0;
+    int numRendered = 0;
+
+    /// Returns the instance of a handle, or nullptr if it has ended.
+    Instance* getInstance(Handle handle)
+    {
+        return const_cast<Instance*>(static_cast<const SfxRuntime*>(this)->getInstance(handle));
+    }
+
+    const Instance* getInstance(Handle handle) const
+    {
+        auto* index = handle >= 0 ? instanceHandles.find(static_cast<uint64_t>(handle)) : nullptr;
+        return index != nullptr ? &instances[*index] : nullptr;
+    }
+
+    /// Runs the commands queued by play(), release(), stop() and stopAll() since the last render().
+    void runCommands()
+    {
+        Command command;
+        while (commands.pop(command))
+        {
+            switch (command.type)
+            {
+                case Command::playSound:     startInstance(command); break;
+                case Command::releaseSound:  if (auto* instance = getInstance(command.handle)) releaseInstance(*instance); break;
+                case Command::stopSound:     if (auto* instance = getInstance(command.handle)) freeInstance(*instance); break;
+                case Command::stopAllSounds: stopAllInstances(); break;
+            }
+        }
+    }
+
+    /// Starts the instance of a play() command, dropping the least important one if every instance is in use.
+    void startInstance(const Command& command)
+    {
+        if (freeInstances.empty() && ! dropLowestInstance(command.priority))
+            return;
+
+        int index = freeInstances.back();
+        freeInstances.pop_back();
+
+        auto& instance = instances[index];
+        instance.active = true;
+        instance.handle = command.handle;
+        instance.sound = command.sound;
+        instance.note = command.note;
+        instance.gain = command.gain;
+        instance.priority = command.priority;
+        instance.elapsed = 0;
+        instance.holdSamples = std::max<int64_t>(0, static_cast<int64_t>(command.holdSeconds * sampleRate));
+        instance.lifeSamples = getLifeSamples(sounds[command.sound], instance.holdSamples);
+        instance.voice = -1;
+        instance.releasePosition = -1;
+        instance.cached = findCached(command.sound, command.note, instance.holdSamples, instance.lifeSamples);
+        instanceHandles.insert(static_cast<uint64_t>(command.handle), index);
+        ++numInstances;
+    }
+
+    /// Releases an instance early, see release().
+    void releaseInstance(Instance& instance)
+    {
+        if (instance.elapsed >= instance.holdSamples || instance.releasePosition >= 0)
+            return;
+
+        if (instance.cached == nullptr)
+        {
+            releaseLive(instance);
+            return;
+        }
+
+        int64_t position = instance.elapsed + static_cast<int64_t>(cachedReleaseDelay * sampleRate);
+        if (position >= instance.holdSamples)
+            return; // The cached sound is released before that anyway
+
+        const auto& parameters = sounds[instance.sound];
+        instance.releasePosition = position;
+        instance.releaseKey = RenderCache::makeKey(parameters, instance.note, position, sampleRate);
+        if (auto* tail = cachedSounds.find(instance.releaseKey))
+            releaseCached(instance, *tail);
+        else
+            cacheRequests.push({ instance.releaseKey, instance.note, position, parameters });
+    }
+
+    /// Ends every instance.
+    void stopAllInstances()
+    {
+        for (auto& instance : instances)
+        {
+            if (instance.active)
+                freeInstance(instance);
+        }
+    }
+
+    /// Ends an instance and frees its voice.
+    void freeInstance(Instance& instance)
+    {
+        instanceHandles.erase(static_cast<uint64_t>(instance.handle));
+        instance.cached = nullptr;
+        if (instance.voice >= 0)
+        {
+            voices[instance.voice]->stopNote(false);
+            voiceOwner[instance.voice] = -1;
+            instance.voice = -1;
+        }
+        instance.active = false;
+        freeInstances.push_back(static_cast<int>(&instance - instances.data()));
+        --numInstances;
+    }
+
+    /// Frees the least important instance if it does not outrank a new sound of the given priority.
+    bool dropLowestInstance(int newPriority)
+    {
+        Instance* lowest = nullptr;
+        for (auto& instance : instances)
+        {
+            if (! instance.active)
+                continue;
+            if (lowest == nullptr || instance.priority < lowest->priority
+                || (instance.priority == lowest->priority && instance.rank < lowest->rank))
+                lowest = &instance;
+        }
+        if (lowest == nullptr || lowest->priority > newPriority)
+            return false;
+
+        freeInstance(*lowest);
+        return true;
+    }
+
+    /// Returns the length of a sound held for holdSamples, including its release.
+    int64_t getLifeSamples(const ChiptuneParameters& parameters, int64_t holdSamples) const
+    {
+        return holdSamples + static_cast<int64_t>(parameters.get(ChiptuneParameters::release) * sampleRate) + 1;
+    }
+
+    /// Returns true if a sound of this length may go into the cache.
+    bool fitsCache(int64_t lifeSamples) const
+    {
+        return cacheEnabled && static_cast<double>(lifeSamples) <= maxCachedSeconds * sampleRate;
+    }
+
+    /// Returns the cached rendering of a one-shot, or nullptr if it must be played live. Passes cacheable misses to the worker.
+    RenderCache::Buffer findCached(int soundIndex, int midiNoteNumber, int64_t holdSamples, int64_t lifeSamples)
+    {
+        const auto& parameters = sounds[soundIndex];
+        if (! fitsCache(lifeSamples))
+            return nullptr;
+
+        if (! RenderCache::isCacheable(parameters))
+        {
+            cacheStats.uncacheable.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        uint64_t key = RenderCache::makeKey(parameters, midiNoteNumber, holdSamples, sampleRate);
+        if (auto* cached = cachedSounds.find(key))
+        {
+            cacheTouches.push(key); // Dropped if the worker is behind, which only costs LRU accuracy
+            cacheStats.hits.fetch_add(1, std::memory_order_relaxed);
+            return *cached;
+        }
+
+        if (! cacheRequests.isFull())
+            cacheRequests.push({ key, midiNoteNumber, holdSamples, parameters });
+        cacheStats.misses.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    /// Applies the sounds the worker has rendered or evicted to the audio thread's copy of the cache index.
+    void applyCacheUpdates()
+    {
+        CacheUpdate update;
+        while (cacheUpdates.pop(update))
+        {
+            // Neither drops the last reference to a buffer: the worker keeps every buffer it sent until it is unused
+            if (update.samples != nullptr)
+                cachedSounds.insert(update.key, std::move(update.samples));
+            else
+                cachedSounds.erase(update.key);
+        }
+    }
+
+    /// Worker: renders a one-shot into the cache, unless it is there already, and queues it for the audio thread. Allocates.
+    void renderIntoCache(uint64_t key, const ChiptuneParameters& parameters, int midiNoteNumber, int64_t holdSamples)
+    {
+        if (cache.peek(key) != nullptr)
+            return;
+
+        int64_t lifeSamples = getLifeSamples(parameters, holdSamples);
+
+        // Render the whole sound: hold, release, until the envelope has ended. The sound is rendered
+        // on a new voice, as a voice carries its oscillator phase over from one note to the next. Every
+        // rendering then depends on its key only, and a release tail matches the held sound it replaces.
+        cacheScratch.assign(static_cast<size_t>(lifeSamples), 0.0f);
+        float* mono[] = { cacheScratch.data() };
+        auto voice = std::make_unique<ChiptuneVoice>(noLiveParameters, noKeyZones);
+        voice->setSampleRate(sampleRate);
+        voice->setRandomSeed(ChiptuneRandom::deriveSeed(randomSeed, static_cast<uint64_t>(getNumRealVoices())));
+        voice->startNote(midiNoteNumber, 1.0f, parameters);
+        voice->renderNextBlock(mono, 1, 0, static_cast<int>(holdSamples));
+        voice->stopNote(true);
+        voice->renderNextBlock(mono, 1, static_cast<int>(holdSamples), static_cast<int>(lifeSamples - holdSamples));
+
+        cache.insert(key, cacheScratch.data(), cacheScratch.size());
+        queueEvictions();
+        if (auto stored = cache.peek(key))
+            unsentUpdates.push_back({ key, std::move(stored) });
+    }
+
+    /// Worker: queues the keys the cache has evicted, after the insertions that preceded them.
+    void queueEvictions()
+    {
+        for (auto key : cache.takeEvictedKeys())
+            unsentUpdates.push_back({ key, nullptr });
+    }
+
+    /// Worker: passes the queued updates to the audio thread, as many as there is room for.
+    void sendCacheUpdates()
+    {
+        auto sent = unsentUpdates.begin();
+        while (sent != unsentUpdates.end() && cacheUpdates.push(std::move(*sent)))
+            ++sent;
+        unsentUpdates.erase(unsentUpdates.begin(), sent);
+    }
+
+    /// Switches the released cached instances to their release rendering once the worker has rendered it,
+    /// or to a live voice if they reach their release position first.
+    void resolveCachedReleases()
+    {
+        for (auto& instance : instances)
+        {
+            if (! instance.active || instance.releasePosition < 0)
+                continue;
+
+            if (auto* tail = cachedSounds.find(instance.releaseKey))
+                releaseCached(instance, *tail);
+            else if (instance.elapsed >= instance.releasePosition)
+                releaseLive(instance);
+        }
+    }
+
+    /// Switches a cached instance to the rendering of its sound released at its release position.
+    void releaseCached(Instance& instance, const RenderCache::Buffer& tail)
+    {
+        instance.cached = tail;
+        instance.holdSamples = instance.releasePosition;
+        instance.lifeSamples = static_cast<int64_t>(tail->size());
+        instance.releasePosition = -1;
+    }
+
+    /// Releases an instance at its current position, playing it from a voice if it played from the cache.
+    void releaseLive(Instance& instance)
+    {
+        instance.cached = nullptr;
+        instance.holdSamples = instance.elapsed;
+        instance.lifeSamples = getLifeSamples(sounds[instance.sound], instance.elapsed);
+        instance.releasePosition = -1;
+    }
+
+    /// Estimates the envelope level of an instance at a position, from its linear ADSR.
+    float estimateLevel(const Instance& instance, int64_t position) const
+    {
+        const auto& parameters = sounds[instance.sound];
+        double attack = parameters.get(ChiptuneParameters::attack) * sampleRate;
+        double decay = parameters.get(ChiptuneParameters::decay) * sampleRate;
+        double sustain = parameters.get(ChiptuneParameters::sustain);
+        double release = parameters.get(ChiptuneParameters::release) * sampleRate;
+
+        auto levelAt = [&](double t)
+        {
+            if (t < attack)
+                return t / attack;
+            if (t < attack + decay)
+                return 1.0 - (1.0 - sustain) * (t - attack) / decay;
+            return sustain;
+        };
+
+        double t = static_cast<double>(position);
+        double hold = static_cast<double>(instance.holdSamples);
+        if (t < hold)
+            return static_cast<float>(levelAt(t));
+
+        double releaseLevel = levelAt(hold);
+        return release > 0.0 ? static_cast<float>(releaseLevel * std::max(0.0, 1.0 - (t - hold) / release)) : 0.0f;
+    }
+
+    /// Ranks the instances and gives the real voices to the best ones that fit the budget.
+    void assignVoices(int numSamples)
+    {
+        ranking.clear();
+        for (int i = 0; i < static_cast<int>(instances.size()); ++i)
+        {
+            auto& instance = instances[i];
+            if (! instance.active)
+                continue;
+
+            // The louder end of the coming block, so that sounds starting from silence still get in
+            float level = std::max(estimateLevel(instance, instance.elapsed), estimateLevel(instance, instance.elapsed + numSamples));
+            instance.rank = instance.gain * level;
+
+            // Cached sounds are mixed without a voice
+            if (instance.cached == nullptr)
+                ranking.push_back(i);
+        }
+
+        auto isBetter = [this](int a, int b)
+        {
+            const auto& x = instances[a];
+            const auto& y = instances[b];
+            return x.priority != y.priority ? x.priority > y.priority : x.rank > y.rank;
+        };
+
+        // Admit the best instances until the voices or the CPU budget run out, skipping those that do not
+        // fit. The ranking is sorted a voice count at a time, as far as the loop gets. A voice behind its
+        // instance costs its catch-up for this block, at the rate of advance(), and renders only once it
+        // has caught up; one that cannot catch up in a block gets what is left of the budget, as long as
+        // that gains on the instance. Admitted instances are moved to the front of the ranking.
+        double budget = cpuBudgetMicroseconds > 0.0 ? cpuBudgetMicroseconds : -1.0;
+        int64_t catchUpLimit = getCatchUpLimit(numSamples);
+        int numRanked = static_cast<int>(ranking.size());
+        int numSorted = 0;
+        int numAdmitted = 0;
+        for (int r = 0; r < numRanked && numAdmitted < getNumRealVoices(); ++r)
+        {
+            if (r == numSorted)
+            {
+                numSorted = std::min(numRanked, numSorted + getNumRealVoices());
+                std::partial_sort(ranking.begin() + r, ranking.begin() + numSorted, ranking.end(), isBetter);
+            }
+
+            auto& instance = instances[ranking[r]];
+            if (instance.rank < audibilityThreshold)
+                continue;
+
+            int64_t behind = instance.elapsed - (instance.voice >= 0 ? instance.voicePosition : 0);
+            int64_t allowance = std::min(behind, catchUpLimit);
+            if (budget >= 0.0)
+            {
+                double cost = catchUpCostPerSample * static_cast<double>(allowance) + voiceCostPerSample * static_cast<double>(numSamples);
+                if (allowance < behind || cost > budget)
+                {
+                    // Catch up only, stopping short of the instance as there is nothing left to render it with
+                    allowance = std::min({ allowance, behind - 1, static_cast<int64_t>(budget / catchUpCostPerSample) });
+                    if (allowance <= numSamples)
+                        continue;
+                    cost = catchUpCostPerSample * static_cast<double>(allowance);
+                }
+                budget -= cost;
+            }
+            instance.catchUpAllowance = allowance;
+            std::swap(ranking[numAdmitted++], ranking[r]);
+        }
+
+        // Demote the real instances that did not make it; they fade out during this block.
+        for (int v = 0; v < getNumRealVoices(); ++v)
+        {
+            int owner = voiceOwner[v];
+            if (owner < 0)
+                continue;
+
+            auto position = std::find(ranking.begin(), ranking.begin() + numAdmitted, owner);
+            if (position == ranking.begin() + numAdmitted)
+            {
+                auto& instance = instances[owner];
+                instance.voice = -1; // The voice keeps its owner until the fade is done.
+
+                // A voice still catching up has not been heard yet, so there is nothing to fade
+                if (instance.voicePosition < instance.elapsed)
+                {
+                    voices[v]->stopNote(false);
+                    voiceOwner[v] = -1;
+                }
+            }
+        }
+
+        // Promote the admitted virtual instances onto free voices.
+        for (int r = 0; r < numAdmitted; ++r)
+        {
+            int index = ranking[r];
+            auto& instance = instances[index];
+            if (instance.voice >= 0)
+                continue;
+
+            auto freeVoice = std::find(voiceOwner.begin(), voiceOwner.end(), -1);
+            if (freeVoice == voiceOwner.end())
+                break;
+
+            int v = static_cast<int>(freeVoice - voiceOwner.begin());
+            startVoice(v, index);
+        }
+    }
+
+    /// Starts an instance on a real voice, from the beginning; renderVoices() brings it up to the instance's position.
+    void startVoice(int v, int index)
+    {
+        auto& instance = instances[index];
+        voices[v]->startNote(instance.note, instance.gain, sounds[instance.sound]);
+        instance.voice = v;
+        instance.voicePosition = 0;
+        voiceOwner[v] = index;
+    }
+
+    /// Returns how far a voice may catch up in one block, always more than the block so that it gets there.
+    static int64_t getCatchUpLimit(int numSamples) { return std::max<int64_t>(maxCatchUpSamples, 2 * static_cast<int64_t>(numSamples)); }
+
+    /// Advances the voice of an instance towards the instance's position, by at most limit samples, releasing it on the way.
+    void catchUp(Instance& instance, ChiptuneVoice& voice, int64_t limit)
+    {
+        int64_t target = std::min(instance.elapsed, instance.voicePosition + limit);
+        while (instance.voicePosition < target)
+        {
+            if (instance.voicePosition == instance.holdSamples)
+                voice.stopNote(true);
+
+            int64_t end = instance.voicePosition < instance.holdSamples ? std::min(target, instance.holdSamples) : target;
+            voice.advance(static_cast<int>(end - instance.voicePosition));
+            instance.voicePosition = end;
+        }
+    }
+
+    /// Renders every busy voice, releasing notes at their hold time and fading out demoted instances.
+    void renderVoices(float* const* outputs, int numChannels, int start, int numSamples)
+    {
+        auto startTime = std::chrono::steady_clock::now();
+        double catchUpMicroseconds = 0.0;
+        int64_t numCaughtUp = 0;
+        numRendered = 0;
+
+        for (int v = 0; v < getNumRealVoices(); ++v)
+        {
+            int owner = voiceOwner[v];
+            if (owner < 0)
+                continue;
+
+            auto& instance = instances[owner];
+            auto& voice = *voices[v];
+            bool fadingOut = instance.voice != v;
+
+            if (instance.voicePosition < instance.elapsed)
+            {
+                auto catchUpStart = std::chrono::steady_clock::now();
+                int64_t from = instance.voicePosition;
+                catchUp(instance, voice, instance.catchUpAllowance);
+                catchUpMicroseconds += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - catchUpStart).count();
+                numCaughtUp += instance.voicePosition - from;
+
+                if (instance.voicePosition < instance.elapsed)
+                    continue;
+            }
+
+            float* mono[] = { scratch.data() };
+            std::fill(scratch.begin(), scratch.begin() + numSamples, 0.0f);
+
+            int64_t untilRelease = instance.holdSamples - instance.elapsed;
+            if (untilRelease >= 0 && untilRelease < numSamples)
+            {
+                voice.renderNextBlock(mono, 1, 0, static_cast<int>(untilRelease));
+                voice.stopNote(true);
+                voice.renderNextBlock(mono, 1, static_cast<int>(untilRelease), numSamples - static_cast<int>(untilRelease));
+            }
+            else
+            {
+                voice.renderNextBlock(mono, 1, 0, numSamples);
+            }
+
+            float gain = instance.gain;
+            float gainStep = fadingOut ? -gain / static_cast<float>(numSamples) : 0.0f;
+            for (int i = 0; i < numSamples; ++i)
+            {
+                float sample = scratch[i] * gain;
+                for (int chan = 0; chan < numChannels; ++chan)
+                    outputs[chan][start + i] += sample;
+                gain += gainStep;
+            }
+            ++numRendered;
+            instance.voicePosition = instance.elapsed + numSamples;
+
+            if (fadingOut)
+            {
+                voice.stopNote(false);
+                voiceOwner[v] = -1;
+            }
+        }
+
+        if (numCaughtUp > 0)
+        {
+            double costPerSample = catchUpMicroseconds / static_cast<double>(numCaughtUp);
+            catchUpCostPerSample += 0.1 * (costPerSample - catchUpCostPerSample);
+        }
+
+        if (numRendered > 0)
+        {
+            double elapsedMicroseconds = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - startTime).count();
+            double costPerSample = (elapsedMicroseconds - catchUpMicroseconds) / (static_cast<double>(numRendered) * numSamples);
+            voiceCostPerSample += 0.1 * (costPerSample - voiceCostPerSample);
+        }
+    }
+
+    /// Mixes the sounds played from the cache, which need no voice.
+    void mixCachedInstances(float* const* outputs, int numChannels, int start, int numSamples)
+    {
+        for (auto& instance : instances)
+        {
+            if (! instance.active || instance.cached == nullptr || instance.rank < audibilityThreshold)
+                continue;
+
+            const auto& samples = *instance.cached;
+            int n = static_cast<int>(std::min<int64_t>(numSamples, static_cast<int64_t>(samples.size()) - instance.elapsed));
+            const float* source = samples.data() + instance.elapsed;
+
+            for (int i = 0; i < n; ++i)
+            {
+                float sample = source[i] * instance.gain;
+                for (int chan = 0; chan < numChannels; ++chan)
+                    outputs[chan][start + i] += sample;
+            }
+        }
+    }
+
+    /// Moves every instance forward, ending those whose voice has finished or whose time is up.
+    void advanceInstances(int numSamples)
+    {
+        for (auto& instance : instances)
+        {
+            if (! instance.active)
+                continue;
+
+            instance.elapsed += numSamples;
+            bool finished;
+            if (instance.cached != nullptr)
+                finished = instance.elapsed >= static_cast<int64_t>(instance.cached->size());
+            else if (instance.voice >= 0)
+                finished = ! voices[instance.voice]->isActive();
+            else
+                finished = instance.elapsed >= instance.lifeSamples;
+
+            if (finished)
+                freeInstance(instance);
+        }
+    }
+};
@@ -0,0 +1,115 @@
+/*
+  ==============================================================================
+
+    SimdLanes.h
+    Created: 22 Oct 2026 5:02:48pm
+    Author:  70
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+ #include <emmintrin.h>
+ #define CHIPTUNE_SIMD_SSE2 1
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+ #include <arm_neon.h>
+ #define CHIPTUNE_SIMD_NEON 1
+#endif
+
+/**
+ * @brief Four floats processed together, with SSE2 on x86, NEON on ARM, or plain loops elsewhere.
+ *
+ * Only the handful of operations the oscillators need. Comparisons return a mask to pass to select(),
+ * which gives branchless per-lane choices.
+ */
+struct FloatLanes
+{
+    static constexpr int size = 4;
+
+   #if CHIPTUNE_SIMD_SSE2
+    __m128 v;
+
+    static FloatLanes load(const float* p) { return { _mm_load_ps(p) }; }
+    static FloatLanes broadcast(float x) { return { _mm_set1_ps(x) }; }
+    void store(float* p) const { _mm_store_ps(p, v); }
+
+    friend FloatLanes operator+(FloatLanes a, FloatLanes b) { return { _mm_add_ps(a.v, b.v) }; }
+    friend FloatLanes operator-(FloatLanes a, FloatLanes b) { return { _mm_sub_ps(a.v, b.v) }; }
+    friend FloatLanes operator*(FloatLanes a, FloatLanes b) { return { _mm_mul_ps(a.v, b.v) }; }
+
+    static FloatLanes lessThan(FloatLanes a, FloatLanes b) { return { _mm_cmplt_ps(a.v, b.v) }; }
+    static FloatLanes greaterThan(FloatLanes a, FloatLanes b) { return { _mm_cmpgt_ps(a.v, b.v) }; }
+
+    /// Returns a where mask is set, b elsewhere.
+    static FloatLanes select(FloatLanes mask, FloatLanes a, FloatLanes b)
+    {
+        return { _mm_or_ps(_mm_and_ps(mask.v, a.v), _mm_andnot_ps(mask.v, b.v)) };
+    }
+
+    /// Returns the sum of the four lanes.
+    float sum() const
+    {
+        __m128 pairs = _mm_add_ps(v, _mm_movehl_ps(v, v));
+        return _mm_cvtss_f32(_mm_add_ss(pairs, _mm_shuffle_ps(pairs, pairs, 1)));
+    }
+   #elif CHIPTUNE_SIMD_NEON
+    float32x4_t v;
+
+    static FloatLanes load(const float* p) { return { vld1q_f32(p) }; }
+    static FloatLanes broadcast(float x) { return { vdupq_n_f32(x) }; }
+    void store(float* p) const { vst1q_f32(p, v); }
+
+    friend FloatLanes operator+(FloatLanes a, FloatLanes b) { return { vaddq_f32(a.v, b.v) }; }
+    friend FloatLanes operator-(FloatLanes a, FloatLanes b) { return { vsubq_f32(a.v, b.v) }; }
+    friend FloatLanes operator*(FloatLanes a, FloatLanes b) { return { vmulq_f32(a.v, b.v) }; }
+
+    static FloatLanes lessThan(FloatLanes a, FloatLanes b) { return { vreinterpretq_f32_u32(vcltq_f32(a.v, b.v)) }; }
+    static FloatLanes greaterThan(FloatLanes a, FloatLanes b) { return { vreinterpretq_f32_u32(vcgtq_f32(a.v, b.v)) }; }
+
+    static FloatLanes select(FloatLanes mask, FloatLanes a, FloatLanes b)
+    {
+        return { vbslq_f32(vreinterpretq_u32_f32(mask.v), a.v, b.v) };
+    }
+
+    float sum() const
+    {
+        float32x2_t pairs = vadd_f32(vget_low_f32(v), vget_high_f32(v));
+        return vget_lane_f32(vpadd_f32(pairs, pairs), 0);
+    }
+   #else
+    float v[size];
+
+    static FloatLanes load(const float* p) { return { { p[0], p[1], p[2], p[3] } }; }
+    static FloatLanes broadcast(float x) { return { { x, x, x, x } }; }
+    void store(float* p) const { for (int i = 0; i < size; ++i) p[i] = v[i]; }
+
+    template <typename Op>
+    static FloatLanes map(FloatLanes a, FloatLanes b, Op op)
+    {
+        FloatLanes r;
+        for (int i = 0; i < size; ++i)
+            r.v[i] = op(a.v[i], b.v[i]);
+        return r;
+    }
+
+    friend FloatLanes operator+(FloatLanes a, FloatLanes b) { return map(a, b, [](float x, float y) { return x + y; }); }
+    friend FloatLanes operator-(FloatLanes a, FloatLanes b) { return map(a, b, [](float x, float y) { return x - y; }); }
+    friend FloatLanes operator*(FloatLanes a, FloatLanes b) { return map(a, b, [](float x, float y) { return x * y; }); }
+
+    // Masks hold 1 or 0 per lane
+    static FloatLanes lessThan(FloatLanes a, FloatLanes b) { return map(a, b, [](float x, float y) { return x < y ? 1.0f : 0.0f; }); }
+    static FloatLanes greaterThan(FloatLanes a, FloatLanes b) { return map(a, b, [](float x, float y) { return x > y ? 1.0f : 0.0f; }); }
+
+    static FloatLanes select(FloatLanes mask, FloatLanes a, FloatLanes b)
+    {
+        FloatLanes r;
+        for (int i = 0; i < size; ++i)
+            r.v[i] = mask.v[i] != 0.0f ? a.v[i] : b.v[i];
+        return r;
+    }
+
+    float sum() const { return (v[0] + v[2]) + (v[1] + v[3]); }
+   #endif
+};
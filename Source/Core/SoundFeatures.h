@@ -0,0 +1,299 @@
+/*
+  ==============================================================================
+
+    SoundFeatures.h
+    Created: 25 Oct 2026 4:05:38pm
+    Author:  70
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <vector>
+
+/**
+ * @class SoundFeatures
+ *
+ * @brief Describes a short sound as a small vector of numbers, so that sounds that seem alike are close.
+ *
+ * The first 0.64 s of the sound, from its onset, is cut into 16 frames of 40 ms. Each frame gives:
+ * - its loudness, relative to the loudest frame, so the gain of a recording does not matter;
+ * - its spectral centroid, which tells how bright it is;
+ * - its pitch, in octaves from the median pitch of the sound, so a sound matches its transpositions;
+ * - how periodic it is: 1 for a steady tone, near 0 for noise.
+ * The centroid, pitch and periodicity of a frame count less the quieter it is, so a fading tail or a
+ * silent frame weighs little. Two more values give the length of the sound and its median pitch.
+ *
+ * Every value is scaled so that the plain Euclidean distance between two vectors is a fair measure:
+ * a difference of 1 is roughly a clearly audible difference. The pitch is found by autocorrelation,
+ * computed with an FFT of each frame.
+ */
+class SoundFeatures
+{
+public:
+    static constexpr int numFrames = 16;
+    static constexpr double frameSeconds = 0.04;
+    static constexpr int featuresPerFrame = 4;
+    static constexpr int numFeatures = numFrames * featuresPerFrame + 2;
+    static constexpr int version = 1; // Bump when the features change, so saved vectors are recomputed.
+
+    using Vector = std::array<float, numFeatures>;
+
+    /// Extracts the features of a mono sound.
+    static Vector extract(const float* audio, size_t numSamples, double sampleRate)
+    {
+        Vector features {};
+        auto hop = static_cast<size_t>(std::lround(frameSeconds * sampleRate));
+        if (hop < 16 || numSamples == 0)
+            return features;
+
+        // The sound starts at its first sample above -50 dB of its peak, and ends after its last one above -60 dB
+        float peak = 0.0f;
+        for (size_t i = 0; i < numSamples; ++i)
+            peak = std::max(peak, std::abs(audio[i]));
+        if (peak <= 0.0f)
+            return features;
+
+        size_t onset = 0;
+        while (std::abs(audio[onset]) < peak * 0.00316f)
+            ++onset;
+        size_t end = numSamples;
+        while (end > onset && std::abs(audio[end - 1]) < peak * 0.001f)
+            --end;
+
+        audio += onset;
+        size_t length = end - onset;
+
+        Analyser analyser(hop, sampleRate);
+        std::array<Frame, numFrames> frames;
+        float loudest = 0.0f;
+        for (int i = 0; i < numFrames; ++i)
+        {
+            size_t start = static_cast<size_t>(i) * hop;
+            frames[i] = analyser.analyse(audio + std::min(start, length), start < length ? std::min(hop, length - start) : 0);
+            loudest = std::max(loudest, frames[i].rms);
+        }
+
+        // The reference pitch is the median pitch of the periodic frames
+        std::vector<float> pitches;
+        for (const auto& frame : frames)
+            if (frame.periodicity > 0.5f && frame.rms > loudest * 0.1f)
+                pitches.push_back(frame.pitch);
+        float medianPitch = 0.0f;
+        if (! pitches.empty())
+        {
+            std::nth_element(pitches.begin(), pitches.begin() + static_cast<std::ptrdiff_t>(pitches.size() / 2), pitches.end());
+            medianPitch = pitches[pitches.size() / 2];
+        }
+
+        for (int i = 0; i < numFrames; ++i)
+        {
+            const auto& frame = frames[i];
+            float* values = features.data() + i * featuresPerFrame;
+
+            // Loudness from -60 dB (0) to the loudest frame (1)
+            float level = frame.rms > 0.0f && loudest > 0.0f ? 20.0f * std::log10(frame.rms / loudest) : -60.0f;
+            float presence = std::clamp(1.0f + level / 60.0f, 0.0f, 1.0f);
+            bool periodic = frame.periodicity > 0.5f && medianPitch > 0.0f;
+
+            values[0] = presence * loudnessWeight;
+            values[1] = presence * (frame.centroid > 0.0f ? std::log2(frame.centroid / 1000.0f) : 0.0f) * centroidWeight;
+            values[2] = presence * (periodic ? std::clamp(frame.pitch - medianPitch, -2.0f, 2.0f) : 0.0f) * pitchWeight;
+            values[3] = presence * frame.periodicity * periodicityWeight;
+        }
+
+        // Length in octaves of time from 10 ms to 10 s, and median pitch in octaves from middle C
+        float seconds = static_cast<float>(static_cast<double>(length) / sampleRate);
+        features[numFrames * featuresPerFrame] = std::log2(std::clamp(seconds, 0.01f, 10.0f) / 0.01f) * lengthWeight;
+        features[numFrames * featuresPerFrame + 1] = medianPitch > 0.0f ? (medianPitch - std::log2(261.63f)) * notePitchWeight : 0.0f;
+        return features;
+    }
+
+    /// Changes the length of the sound a vector describes, e.g. to search for a shorter version of a sound.
+    static void scaleLength(Vector& features, float factor)
+    {
+        if (factor > 0.0f)
+            features[numFrames * featuresPerFrame] += std::log2(factor) * lengthWeight;
+    }
+
+    /// Returns the squared Euclidean distance between two vectors.
+    static float distance(const Vector& a, const Vector& b)
+    {
+        float sum = 0.0f;
+        for (int i = 0; i < numFeatures; ++i)
+            sum += (a[i] - b[i]) * (a[i] - b[i]);
+        return sum;
+    }
+
+private:
+    // Scales of the features, see the class description
+    static constexpr float loudnessWeight = 1.5f;
+    static constexpr float centroidWeight = 0.5f;    // Per octave of brightness.
+    static constexpr float pitchWeight = 1.0f;       // Per octave of pitch change over the sound.
+    static constexpr float periodicityWeight = 1.0f;
+    static constexpr float lengthWeight = 1.0f;      // Per doubling of the length.
+    static constexpr float notePitchWeight = 0.5f;   // Per octave of the note played.
+
+    struct Frame
+    {
+        float rms = 0.0f;
+        float centroid = 0.0f;    // In Hz.
+        float pitch = 0.0f;       // In octaves (log2 Hz).
+        float periodicity = 0.0f; // Normalised autocorrelation at the pitch period, 0 to 1.
+    };
+
+    /// Analyses frames of one size, reusing its window and FFT buffers.
+    class Analyser
+    {
+    public:
+        Analyser(size_t frameSize, double rate)
+            : size(frameSize), sampleRate(rate), window(frameSize), windowCorrelation(frameSize)
+        {
+            fftSize = 1;
+            while (fftSize < 2 * size)
+                fftSize *= 2;
+            spectrum.resize(fftSize);
+
+            const double pi = 3.14159265358979323846;
+            twiddles.resize(fftSize / 2);
+            for (size_t k = 0; k < fftSize / 2; ++k)
+                twiddles[k] = std::polar(1.0f, static_cast<float>(-2.0 * pi * static_cast<double>(k) / static_cast<double>(fftSize)));
+            for (size_t i = 0; i < size; ++i)
+                window[i] = static_cast<float>(0.5 - 0.5 * std::cos(2.0 * pi * (static_cast<double>(i) + 0.5) / static_cast<double>(size)));
+
+            // The autocorrelation of the window, which tapers the autocorrelation of every frame
+            std::copy(window.begin(), window.end(), spectrum.begin());
+            transform(false);
+            for (auto& value : spectrum)
+                value = std::norm(value);
+            transform(true);
+            for (size_t lag = 0; lag < size; ++lag)
+                windowCorrelation[lag] = spectrum[lag].real();
+        }
+
+        Frame analyse(const float* audio, size_t numSamples)
+        {
+            Frame frame;
+            if (numSamples == 0)
+                return frame;
+
+            // The offset of a pulse wave is not heard, so it is left out of the loudness and the spectrum
+            double sum = 0.0, energy = 0.0;
+            for (size_t i = 0; i < numSamples; ++i)
+            {
+                sum += audio[i];
+                energy += static_cast<double>(audio[i]) * audio[i];
+            }
+            auto mean = static_cast<float>(sum / static_cast<double>(numSamples));
+            energy -= sum * mean;
+            frame.rms = static_cast<float>(std::sqrt(std::max(0.0, energy) / static_cast<double>(size)));
+            if (frame.rms <= 0.0f)
+                return frame;
+
+            std::fill(spectrum.begin(), spectrum.end(), std::complex<float>());
+            for (size_t i = 0; i < numSamples; ++i)
+                spectrum[i] = (audio[i] - mean) * window[i];
+            transform(false);
+
+            // Spectral centroid, then the power spectrum transformed back gives the autocorrelation
+            double weighted = 0.0, total = 0.0;
+            for (size_t bin = 0; bin <= fftSize / 2; ++bin)
+            {
+                double power = std::norm(spectrum[bin]);
+                weighted += power * static_cast<double>(bin);
+                total += power;
+            }
+            frame.centroid = total > 0.0 ? static_cast<float>(weighted / total * sampleRate / static_cast<double>(fftSize)) : 0.0f;
+
+            for (auto& value : spectrum)
+                value = std::norm(value);
+            transform(true);
+            findPitch(frame);
+            return frame;
+        }
+
+    private:
+        size_t size, fftSize = 0;
+        double sampleRate;
+        std::vector<float> window, windowCorrelation;
+        std::vector<std::complex<float>> spectrum;
+        std::vector<std::complex<float>> twiddles; // exp(-2 pi i k / fftSize), for k up to fftSize / 2.
+
+        /// Picks the shortest lag whose correlation is nearly the best, which avoids octave errors.
+        void findPitch(Frame& frame) const
+        {
+            float zeroLag = spectrum[0].real();
+            if (zeroLag <= 0.0f)
+                return;
+
+            auto correlation = [this, zeroLag](size_t lag)
+            {
+                return spectrum[lag].real() / zeroLag * windowCorrelation[0] / windowCorrelation[lag];
+            };
+
+            auto minLag = static_cast<size_t>(sampleRate / maxPitchHz);
+            auto maxLag = std::min(size / 2, static_cast<size_t>(sampleRate / minPitchHz));
+            float best = 0.0f;
+            for (size_t lag = minLag; lag <= maxLag; ++lag)
+                best = std::max(best, correlation(lag));
+            if (best <= 0.0f)
+                return;
+
+            for (size_t lag = minLag; lag <= maxLag; ++lag)
+            {
+                float value = correlation(lag);
+                if (value >= best * 0.9f && value >= correlation(lag - 1) && value >= correlation(lag + 1))
+                {
+                    float before = correlation(lag - 1), after = correlation(lag + 1);
+                    float curvature = before - 2.0f * value + after;
+                    float offset = curvature < 0.0f ? 0.5f * (before - after) / curvature : 0.0f;
+                    frame.pitch = static_cast<float>(std::log2(sampleRate / (static_cast<double>(lag) + offset)));
+                    frame.periodicity = std::clamp(value, 0.0f, 1.0f);
+                    return;
+                }
+            }
+        }
+
+        /// In-place radix-2 FFT of the spectrum buffer. The inverse is not scaled.
+        void transform(bool inverse)
+        {
+            for (size_t i = 1, j = 0; i < fftSize; ++i)
+            {
+                size_t bit = fftSize >> 1;
+                for (; j & bit; bit >>= 1)
+                    j ^= bit;
+                j ^= bit;
+                if (i < j)
+                    std::swap(spectrum[i], spectrum[j]);
+            }
+
+            for (size_t length = 2; length <= fftSize; length <<= 1)
+            {
+                size_t half = length / 2, stride = fftSize / length;
+                for (size_t start = 0; start < fftSize; start += length)
+                {
+                    for (size_t k = 0; k < half; ++k)
+                    {
+                        // Multiplied by hand: std::complex checks for infinities on every product
+                        auto twiddle = twiddles[k * stride];
+                        float twiddleImag = inverse ? -twiddle.imag() : twiddle.imag();
+                        auto even = spectrum[start + k];
+                        auto value = spectrum[start + k + half];
+                        std::complex<float> odd(value.real() * twiddle.real() - value.imag() * twiddleImag,
+                                                value.real() * twiddleImag + value.imag() * twiddle.real());
+                        spectrum[start + k] = even + odd;
+                        spectrum[start + k + half] = even - odd;
+                    }
+                }
+            }
+        }
+    };
+
+    static constexpr double minPitchHz = 50.0;
+    static constexpr double maxPitchHz = 4000.0;
+};
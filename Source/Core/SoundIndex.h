@@ -0,0 +1,207 @@
+/*
+  ==============================================================================
+
+    SoundIndex.h
+    Created: 25 Oct 2026 5:12:54pm
+    Author:  70
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "ChiptuneParameters.h"
+#include "SoundFeatures.h"
+
+/**
+ * @class SoundIndex
+ *
+ * @brief Finds the parameter sets that sound closest to a sound, among parameter sets rendered beforehand.
+ *
+ * Each entry is a parameter set and the SoundFeatures of its render. Parameter sets are stored as text,
+ * listing only the parameters that differ from their default ("pbSwitch=1 pbTime=0.25 ..."). This text
+ * also identifies the entry: adding parameter sets to an index only adds the ones it does not hold,
+ * and a parameter added to the synth later, at a default that leaves the sound unchanged, leaves every
+ * entry valid.
+ *
+ * The search is exact and scans the feature vectors, which are stored one after the other. The distance
+ * to an entry stops being summed as soon as it exceeds the worst of the matches kept, so most entries
+ * cost a few features. With this many dimensions a k-d tree would visit most of its nodes anyway.
+ */
+class SoundIndex
+{
+public:
+    /// One result of a search.
+    struct Match
+    {
+        int index;      // Index of the entry.
+        float distance; // Euclidean distance of its features to the query.
+    };
+
+    /// Returns the number of entries.
+    int size() const { return static_cast<int>(descriptions.size()); }
+
+    /// Returns the parameters of an entry, as written by describe().
+    const std::string& getDescription(int index) const { return descriptions[static_cast<size_t>(index)]; }
+
+    /// Returns the features of an entry.
+    SoundFeatures::Vector getFeatures(int index) const
+    {
+        SoundFeatures::Vector vector;
+        std::copy_n(features.begin() + static_cast<std::ptrdiff_t>(index) * SoundFeatures::numFeatures, SoundFeatures::numFeatures, vector.begin());
+        return vector;
+    }
+
+    /// Returns true if the index holds an entry for these parameters.
+    bool contains(const std::string& description) const { return lookup.count(description) > 0; }
+
+    /// Adds an entry, or replaces the features of the entry with the same parameters.
+    void add(const std::string& description, const SoundFeatures::Vector& vector)
+    {
+        auto found = lookup.find(description);
+        if (found != lookup.end())
+        {
+            std::copy(vector.begin(), vector.end(), features.begin() + static_cast<std::ptrdiff_t>(found->second) * SoundFeatures::numFeatures);
+            return;
+        }
+
+        lookup.emplace(description, size());
+        descriptions.push_back(description);
+        features.insert(features.end(), vector.begin(), vector.end());
+    }
+
+    /// Returns the entries closest to a sound, the closest first.
+    std::vector<Match> search(const SoundFeatures::Vector& query, int count) const
+    {
+        std::vector<Match> matches; // Kept as a max-heap on the distance, the worst match on top
+        auto worse = [](const Match& a, const Match& b) { return a.distance < b.distance; };
+        if (count <= 0)
+            return matches;
+
+        for (int i = 0; i < size(); ++i)
+        {
+            const float* vector = features.data() + static_cast<size_t>(i) * SoundFeatures::numFeatures;
+            float limit = static_cast<int>(matches.size()) < count ? std::numeric_limits<float>::max() : matches.front().distance;
+            float sum = 0.0f;
+            for (int f = 0; f < SoundFeatures::numFeatures && sum < limit; ++f)
+                sum += (vector[f] - query[static_cast<size_t>(f)]) * (vector[f] - query[static_cast<size_t>(f)]);
+            if (sum >= limit)
+                continue;
+
+            if (static_cast<int>(matches.size()) == count)
+            {
+                std::pop_heap(matches.begin(), matches.end(), worse);
+                matches.pop_back();
+            }
+            matches.push_back({ i, sum });
+            std::push_heap(matches.begin(), matches.end(), worse);
+        }
+
+        std::sort_heap(matches.begin(), matches.end(), worse);
+        for (auto& match : matches)
+            match.distance = std::sqrt(match.distance);
+        return matches;
+    }
+
+    //==============================================================================
+    /// Saves the index. Returns false if the file cannot be written.
+    bool save(const std::string& path) const
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        uint32_t header[] = { magic, static_cast<uint32_t>(SoundFeatures::version),
+                              static_cast<uint32_t>(SoundFeatures::numFeatures), static_cast<uint32_t>(size()) };
+        file.write(reinterpret_cast<const char*>(header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(features.data()), static_cast<std::streamsize>(features.size() * sizeof(float)));
+        for (const auto& description : descriptions)
+            file << description << '\n';
+        return static_cast<bool>(file);
+    }
+
+    /**
+     * @brief Loads an index saved by save(), replacing the entries.
+     *
+     * @return false if the file cannot be read, or was saved with other features: its entries must then
+     *         be rendered again
+     */
+    bool load(const std::string& path)
+    {
+        clear();
+        std::ifstream file(path, std::ios::binary);
+        uint32_t header[4] = {};
+        if (! file.read(reinterpret_cast<char*>(header), sizeof(header)) || header[0] != magic
+            || header[1] != static_cast<uint32_t>(SoundFeatures::version) || header[2] != static_cast<uint32_t>(SoundFeatures::numFeatures))
+            return false;
+
+        std::vector<float> loaded(static_cast<size_t>(header[3]) * SoundFeatures::numFeatures);
+        if (! file.read(reinterpret_cast<char*>(loaded.data()), static_cast<std::streamsize>(loaded.size() * sizeof(float))))
+            return false;
+
+        std::string description;
+        SoundFeatures::Vector vector;
+        for (uint32_t i = 0; i < header[3] && std::getline(file, description); ++i)
+        {
+            std::copy_n(loaded.begin() + static_cast<std::ptrdiff_t>(i) * SoundFeatures::numFeatures, SoundFeatures::numFeatures, vector.begin());
+            add(description, vector);
+        }
+        return size() == static_cast<int>(header[3]);
+    }
+
+    /// Removes every entry.
+    void clear()
+    {
+        descriptions.clear();
+        features.clear();
+        lookup.clear();
+    }
+
+    //==============================================================================
+    /// Writes the parameters that differ from their default as "id=value" pairs, in layout order.
+    static std::string describe(const ChiptuneParameters& parameters)
+    {
+        ChiptuneParameters defaults;
+        std::string description;
+        for (int i = 0; i < ChiptuneParameters::numParameters; ++i)
+        {
+            auto index = static_cast<ChiptuneParameters::Index>(i);
+            if (parameters.get(index) == defaults.get(index))
+                continue;
+
+            char value[32];
+            std::snprintf(value, sizeof(value), "%.6g", static_cast<double>(parameters.get(index)));
+            description += (description.empty() ? "" : " ") + std::string(ChiptuneParameters::getId(i)) + "=" + value;
+        }
+        return description;
+    }
+
+    /// Reads parameters written by describe(). Unknown IDs are ignored, the others keep their default.
+    static ChiptuneParameters parse(const std::string& description)
+    {
+        ChiptuneParameters parameters;
+        std::istringstream stream(description);
+        std::string pair;
+        while (stream >> pair)
+        {
+            auto equals = pair.find('=');
+            if (equals != std::string::npos)
+                parameters.set(pair.substr(0, equals).c_str(), std::strtof(pair.c_str() + equals + 1, nullptr));
+        }
+        return parameters;
+    }
+
+private:
+    static constexpr uint32_t magic = 0x58444e53; // "SNDX"
+
+    std::vector<std::string> descriptions;
+    std::vector<float> features;                  // The vectors of the entries, one after the other.
+    std::unordered_map<std::string, int> lookup;  // Entry of each description.
+};
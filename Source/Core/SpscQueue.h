@@ -0,0 +1,87 @@
+/*
+  ==============================================================================
+
+    SpscQueue.h
+    Created: 28 Oct 2026 9:12:44am
+    Author:  70
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+/**
+ * @class SpscQueue
+ *
+ * @brief Bounded FIFO from one producer thread to one consumer thread, wait-free on both sides.
+ *
+ * The slots are allocated by the constructor, so push() and pop() never allocate. Each side owns one
+ * index and only reads the other's, so the two threads never wait for each other; a full queue makes
+ * push() fail instead. pop() moves the item out of its slot, so a slot holding a shared pointer does
+ * not keep it alive once popped.
+ */
+template <typename T>
+class SpscQueue
+{
+public:
+    /// Constructs a queue holding at most capacity items. Allocates.
+    explicit SpscQueue(size_t capacity) : slots(capacity + 1) {}
+
+    /// Producer: appends an item. Returns false, leaving the item untouched, if the queue is full.
+    bool push(T&& item)
+    {
+        size_t tail = writeIndex.load(std::memory_order_relaxed);
+        size_t next = increment(tail);
+        if (next == readIndex.load(std::memory_order_acquire))
+            return false;
+
+        slots[tail] = std::move(item);
+        writeIndex.store(next, std::memory_order_release);
+        return true;
+    }
+
+    bool push(const T& item)
+    {
+        T copy(item);
+        return push(std::move(copy));
+    }
+
+    /// Consumer: takes the oldest item. Returns false if the queue is empty.
+    bool pop(T& item)
+    {
+        size_t head = readIndex.load(std::memory_order_relaxed);
+        if (head == writeIndex.load(std::memory_order_acquire))
+            return false;
+
+        item = std::move(slots[head]);
+        slots[head] = T();
+        readIndex.store(increment(head), std::memory_order_release);
+        return true;
+    }
+
+    /// Returns true if the producer cannot push anything. Exact on the producer side only.
+    bool isFull() const
+    {
+        return increment(writeIndex.load(std::memory_order_relaxed)) == readIndex.load(std::memory_order_acquire);
+    }
+
+    /// Empties the queue. Not thread safe: call it while neither side is using the queue.
+    void clear()
+    {
+        for (auto& slot : slots)
+            slot = T();
+        readIndex.store(0);
+        writeIndex.store(0);
+    }
+
+private:
+    std::vector<T> slots; // One more than the capacity, so that full and empty differ.
+    std::atomic<size_t> readIndex { 0 };  // Written by the consumer only
+    std::atomic<size_t> writeIndex { 0 }; // Written by the producer only
+
+    size_t increment(size_t index) const { return index + 1 < slots.size() ? index + 1 : 0; }
+};
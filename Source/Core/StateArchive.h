@@ -0,0 +1,181 @@
+/*
+  ==============================================================================
+
+    StateArchive.h
+    Created: 27 Oct 2026 10:14:05am
+    Author:  70
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/// True for the modules that list their running state in a transferState() method.
+template <typename T, typename = void>
+struct HasTransferState : std::false_type {};
+
+template <typename T>
+struct HasTransferState<T, std::void_t<decltype(std::declval<T&>().transferState(std::declval<int&>()))>> : std::true_type {};
+
+/**
+ * @class StateWriter
+ *
+ * @brief Saves the running state of the DSP modules: oscillator phases, envelope stages, delay lines.
+ *
+ * Each module lists its state once, in a template that StateReader uses to restore it as well:
+ *
+ *     template <typename Archive>
+ *     void transferState(Archive& archive) { archive(phase, phaseDelta); }
+ *
+ * Plain values and structures are copied as raw bytes, vectors as their length and elements, and
+ * modules through their own transferState(). A module that holds a reference cannot be copied as bytes
+ * and must list its state, which the compiler enforces. The bytes are those of the machine and the
+ * build, so a state only restores in the build that saved it. It is how a session log starts from an
+ * engine that is already playing (see SessionLog).
+ *
+ * Without an output vector, the writer only counts the bytes, so a buffer can be sized beforehand.
+ */
+class StateWriter
+{
+public:
+    explicit StateWriter(std::vector<uint8_t>* output) : out(output) {}
+
+    template <typename... Values>
+    void operator()(Values&... values) { (write(values), ...); }
+
+    /// Returns the number of bytes written, or counted.
+    size_t getSize() const { return size; }
+
+private:
+    std::vector<uint8_t>* out;
+    size_t size = 0;
+
+    template <typename T>
+    void write(T& value)
+    {
+        if constexpr (HasTransferState<T>::value)
+        {
+            value.transferState(*this);
+        }
+        else
+        {
+            static_assert(std::is_trivially_copyable_v<T> && std::is_copy_assignable_v<T>,
+                          "a module with references or containers needs a transferState() method");
+            writeBytes(&value, sizeof(T));
+        }
+    }
+
+    template <typename T, size_t N>
+    void write(T (&values)[N])
+    {
+        for (auto& value : values)
+            write(value);
+    }
+
+    template <typename T>
+    void write(std::vector<T>& values)
+    {
+        auto length = static_cast<uint32_t>(values.size());
+        writeBytes(&length, sizeof(length));
+        if constexpr (std::is_trivially_copyable_v<T> && ! HasTransferState<T>::value)
+            writeBytes(values.data(), values.size() * sizeof(T));
+        else
+            for (auto& value : values)
+                write(value);
+    }
+
+    void writeBytes(const void* data, size_t numBytes)
+    {
+        if (out != nullptr)
+        {
+            auto* bytes = static_cast<const uint8_t*>(data);
+            out->insert(out->end(), bytes, bytes + numBytes);
+        }
+        size += numBytes;
+    }
+};
+
+/**
+ * @class StateReader
+ *
+ * @brief Restores the state saved by StateWriter, through the same transferState() methods.
+ *
+ * Fails, rather than reading past the end, if the data is shorter than the modules expect. Vectors take
+ * the length they were saved with.
+ */
+class StateReader
+{
+public:
+    StateReader(const uint8_t* data, size_t size) : position(data), end(data + size) {}
+
+    template <typename... Values>
+    void operator()(Values&... values) { (read(values), ...); }
+
+    /// Returns true if everything read so far was in the data.
+    bool isValid() const { return valid; }
+
+    /// Returns true if the whole data was read, without error.
+    bool isComplete() const { return valid && position == end; }
+
+private:
+    const uint8_t* position;
+    const uint8_t* end;
+    bool valid = true;
+
+    template <typename T>
+    void read(T& value)
+    {
+        if constexpr (HasTransferState<T>::value)
+        {
+            value.transferState(*this);
+        }
+        else
+        {
+            static_assert(std::is_trivially_copyable_v<T> && std::is_copy_assignable_v<T>,
+                          "a module with references or containers needs a transferState() method");
+            readBytes(&value, sizeof(T));
+        }
+    }
+
+    template <typename T, size_t N>
+    void read(T (&values)[N])
+    {
+        for (auto& value : values)
+            read(value);
+    }
+
+    template <typename T>
+    void read(std::vector<T>& values)
+    {
+        uint32_t length = 0;
+        readBytes(&length, sizeof(length));
+        if (! valid || length > static_cast<size_t>(end - position))
+        {
+            valid = false;
+            return;
+        }
+
+        values.resize(length);
+        if constexpr (std::is_trivially_copyable_v<T> && ! HasTransferState<T>::value)
+            readBytes(values.data(), values.size() * sizeof(T));
+        else
+            for (auto& value : values)
+                read(value);
+    }
+
+    void readBytes(void* data, size_t numBytes)
+    {
+        if (! valid || static_cast<size_t>(end - position) < numBytes)
+        {
+            valid = false;
+            return;
+        }
+        std::memcpy(data, position, numBytes);
+        position += numBytes;
+    }
+};
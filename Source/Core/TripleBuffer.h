@@ -0,0 +1,62 @@
+/*
+  ==============================================================================
+
+    TripleBuffer.h
+    Created: 23 Oct 2026 9:41:17am
+    Author:  70
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <atomic>
+
+/**
+ * @class TripleBuffer
+ *
+ * @brief Hands the latest value from one writer thread to one reader thread, wait-free on both sides.
+ *
+ * There are three slots: the writer fills one, the reader reads another, and the third holds the most
+ * recently published value. Publishing and picking up a value each swap a slot index with a single
+ * atomic exchange, so neither thread ever waits for the other, and the reader never sees a value
+ * being written. Values the reader does not pick up in time are overwritten by newer ones.
+ *
+ * The slots are preallocated, so T should be a plain fixed-size structure.
+ */
+template <typename T>
+class TripleBuffer
+{
+public:
+    //==============================================================================
+    /// Writer: returns the slot to fill. Stays the same until publish().
+    T& getWriteBuffer() { return slots[back]; }
+
+    /// Writer: makes the filled slot the latest value, and takes a free slot to fill next.
+    void publish()
+    {
+        back = middle.exchange(back | freshBit, std::memory_order_acq_rel) & indexMask;
+    }
+
+    //==============================================================================
+    /// Reader: picks up the latest value if one was published since the last call. Returns true if so.
+    bool update()
+    {
+        if ((middle.load(std::memory_order_relaxed) & freshBit) == 0)
+            return false;
+
+        front = middle.exchange(front, std::memory_order_acq_rel) & indexMask;
+        return true;
+    }
+
+    /// Reader: returns the value picked up by the last successful update().
+    const T& getReadBuffer() const { return slots[front]; }
+
+private:
+    static constexpr int indexMask = 3;
+    static constexpr int freshBit = 4; // Set in middle when it holds a value the reader has not picked up
+
+    T slots[3] {};
+    std::atomic<int> middle { 1 }; // Index of the latest published slot, plus freshBit
+    int back = 0;                  // Owned by the writer
+    int front = 2;                 // Owned by the reader
+};
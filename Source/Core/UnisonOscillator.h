@@ -0,0 +1,182 @@
+/*
+  ==============================================================================
+
+    UnisonOscillator.h
+    Created: 22 Oct 2026 4:26:03pm
+    Author:  70
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include "PolyBLEPOscillator.h"
+#include "SimdLanes.h"
+
+/**
+ * @class UnisonOscillator
+ *
+ * @brief A stack of up to eight detuned pulse or triangle oscillators, panned across the stereo field.
+ *
+ * The oscillators are laid out as arrays, one element per oscillator, and processed four at a time,
+ * one SIMD lane per oscillator (see FloatLanes), with no branches. Unused lanes have zero gain. A stack
+ * of up to four oscillators costs one pass, up to eight two passes.
+ *
+ * The oscillators match SquareOsc and TriOsc, including the PolyBLEP correction of the pulse edges.
+ * Detune spreads the oscillators evenly between -detune and +detune cents around the note; spread pans
+ * them evenly from left to right.
+ */
+class UnisonOscillator
+{
+public:
+    static constexpr int maxOscillators = 8;
+
+    enum class Shape { pulse, triangle };
+
+    void setSampleRate(double newSampleRate)
+    {
+        sampleRate = static_cast<float>(newSampleRate);
+    }
+
+    /**
+     * @brief Sets the size of the stack and restarts the phases, staggered so the oscillators do not
+     *        all start on the same edge.
+     */
+    void start(int newNumOscillators)
+    {
+        numOscillators = std::clamp(newNumOscillators, 1, maxOscillators);
+        numActiveLanes = (numOscillators + FloatLanes::size - 1) / FloatLanes::size * FloatLanes::size;
+        for (int i = 0; i < maxOscillators; ++i)
+        {
+            float stagger = 0.618034f * i; // Golden ratio steps never line two phases up
+            phase[i] = stagger - std::floor(stagger);
+        }
+        updateRatios();
+        updateGains();
+    }
+
+    /// Returns the number of oscillators.
+    int getNumOscillators() const { return numOscillators; }
+
+    /// Sets the distance in cents of the outermost oscillators from the note.
+    void setDetune(float newDetuneCents)
+    {
+        if (newDetuneCents != detuneCents)
+        {
+            detuneCents = newDetuneCents;
+            updateRatios();
+        }
+    }
+
+    /// Sets the stereo width, from 0 (every oscillator in the centre) to 1 (hard left to hard right).
+    void setSpread(float newSpread)
+    {
+        if (newSpread != spread)
+        {
+            spread = newSpread;
+            updateGains();
+        }
+    }
+
+    /// Sets the frequency of the note in Hz. Divides, so only call it when the frequency changes.
+    void setFrequency(float frequency)
+    {
+        float delta = frequency / sampleRate;
+        for (int i = 0; i < maxOscillators; ++i)
+        {
+            phaseDelta[i] = delta * ratio[i];
+            inverseDelta[i] = 1.0f / phaseDelta[i];
+        }
+    }
+
+    void setPulseWidth(float newPulseWidth) { pulseWidth = newPulseWidth; }
+
+    /// Enables the PolyBLEP correction of the pulse edges, see SquareOsc::setBandLimited().
+    void setBandLimited(bool shouldBeBandLimited) { bandLimited = shouldBeBandLimited ? 1.0f : 0.0f; }
+
+    /// Advances every oscillator by one sample and returns the left and right mixes.
+    void process(Shape shape, float& left, float& right)
+    {
+        const FloatLanes one = FloatLanes::broadcast(1.0f);
+        const FloatLanes zero = FloatLanes::broadcast(0.0f);
+        const FloatLanes half = FloatLanes::broadcast(0.5f);
+        const FloatLanes width = FloatLanes::broadcast(pulseWidth);
+        const FloatLanes correction = FloatLanes::broadcast(bandLimited);
+
+        FloatLanes sumLeft = zero;
+        FloatLanes sumRight = zero;
+        for (int lane = 0; lane < numActiveLanes; lane += FloatLanes::size)
+        {
+            FloatLanes dt = FloatLanes::load(phaseDelta + lane);
+            FloatLanes p = FloatLanes::load(phase + lane) + dt;
+            p = p - FloatLanes::select(FloatLanes::greaterThan(p, one), one, zero);
+            p.store(phase + lane);
+
+            FloatLanes value;
+            if (shape == Shape::pulse)
+            {
+                FloatLanes inverseDt = FloatLanes::load(inverseDelta + lane);
+                FloatLanes fall = p + (one - width);
+                fall = fall - FloatLanes::select(FloatLanes::lessThan(fall, one), zero, one);
+                FloatLanes naive = FloatLanes::select(FloatLanes::lessThan(p, width), one, zero - one);
+                FloatLanes blep = Phasor::poly_blep(p, dt, inverseDt, one) - Phasor::poly_blep(fall, dt, inverseDt, one);
+                value = naive + correction * blep;
+            }
+            else
+            {
+                FloatLanes t = (p - half) * FloatLanes::broadcast(2.0f);
+                FloatLanes rise = p * FloatLanes::broadcast(4.0f) - one;
+                FloatLanes curve = one - FloatLanes::broadcast(2.0f) * t * t;
+                value = FloatLanes::select(FloatLanes::lessThan(p, half), rise, curve) * half;
+            }
+
+            sumLeft = sumLeft + value * FloatLanes::load(gainLeft + lane);
+            sumRight = sumRight + value * FloatLanes::load(gainRight + lane);
+        }
+        left = sumLeft.sum();
+        right = sumRight.sum();
+    }
+
+private:
+    alignas(32) float phase[maxOscillators] {};
+    alignas(32) float phaseDelta[maxOscillators] {};
+    alignas(32) float inverseDelta[maxOscillators] {};
+    alignas(32) float ratio[maxOscillators] {};     // Frequency of each oscillator relative to the note
+    alignas(32) float gainLeft[maxOscillators] {};  // 0 for the unused lanes
+    alignas(32) float gainRight[maxOscillators] {};
+
+    float sampleRate = 44100.0f;
+    int numOscillators = 1;
+    int numActiveLanes = FloatLanes::size; // Lanes processed, numOscillators rounded up to whole SIMD registers
+    float detuneCents = 0.0f;
+    float spread = 0.0f;
+    float pulseWidth = 0.5f;
+    float bandLimited = 1.0f; // 1 or 0, multiplies the correction so the loop has no branch
+
+    /// Spreads the oscillators evenly between -detune and +detune.
+    void updateRatios()
+    {
+        for (int i = 0; i < maxOscillators; ++i)
+        {
+            float position = numOscillators > 1 ? 2.0f * i / (numOscillators - 1) - 1.0f : 0.0f;
+            ratio[i] = std::exp2(position * detuneCents / 1200.0f);
+        }
+    }
+
+    /// Pans the oscillators evenly across the spread with an equal-power law, scaled so that the
+    /// stack is about as loud as one oscillator.
+    void updateGains()
+    {
+        const float quarterPi = 0.785398163f;
+        float scale = std::sqrt(2.0f / static_cast<float>(numOscillators));
+        for (int i = 0; i < maxOscillators; ++i)
+        {
+            float position = numOscillators > 1 ? 2.0f * i / (numOscillators - 1) - 1.0f : 0.0f;
+            float angle = quarterPi * (1.0f + position * spread);
+            bool used = i < numOscillators;
+            gainLeft[i] = used ? scale * std::cos(angle) : 0.0f;
+            gainRight[i] = used ? scale * std::sin(angle) : 0.0f;
+        }
+    }
+};
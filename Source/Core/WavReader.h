@@ -0,0 +1,115 @@
+/*
+  ==============================================================================
+
+    WavReader.h
+    Created: 25 Oct 2026 3:47:10pm
+    Author:  70
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+/**
+ * @class WavReader
+ *
+ * @brief Reads a whole RIFF WAV file as mono float samples.
+ *
+ * Reads the formats WavWriter writes, 16 or 24-bit PCM and 32-bit float, plus 8 and 32-bit PCM and
+ * the extensible header other tools write. The channels are averaged into one.
+ */
+class WavReader
+{
+public:
+    /// Reads a file. Returns false if it cannot be read or is not an uncompressed WAV file.
+    static bool readMono(const std::string& path, std::vector<float>& samples, double& sampleRate)
+    {
+        std::ifstream file(path, std::ios::binary);
+        std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        if (bytes.size() < 12 || std::memcmp(bytes.data(), "RIFF", 4) != 0 || std::memcmp(bytes.data() + 8, "WAVE", 4) != 0)
+            return false;
+
+        int formatTag = 0, numChannels = 0, bitsPerSample = 0;
+        sampleRate = 0.0;
+        samples.clear();
+
+        // Walk the chunks: "fmt " describes the samples, which "data" holds
+        for (size_t pos = 12; pos + 8 <= bytes.size();)
+        {
+            uint32_t chunkSize = readLE(&bytes[pos + 4], 4);
+            const uint8_t* chunk = &bytes[pos + 8];
+            size_t available = std::min<size_t>(chunkSize, bytes.size() - pos - 8);
+
+            if (std::memcmp(&bytes[pos], "fmt ", 4) == 0 && available >= 16)
+            {
+                formatTag = static_cast<int>(readLE(chunk, 2));
+                numChannels = static_cast<int>(readLE(chunk + 2, 2));
+                sampleRate = static_cast<double>(readLE(chunk + 4, 4));
+                bitsPerSample = static_cast<int>(readLE(chunk + 14, 2));
+                if (formatTag == extensibleFormat && available >= 26)
+                    formatTag = static_cast<int>(readLE(chunk + 24, 2));
+            }
+            else if (std::memcmp(&bytes[pos], "data", 4) == 0)
+            {
+                bool isFloat = formatTag == floatFormat && bitsPerSample == 32;
+                bool isPcm = formatTag == pcmFormat && (bitsPerSample == 8 || bitsPerSample == 16 || bitsPerSample == 24 || bitsPerSample == 32);
+                if (numChannels <= 0 || ! (isFloat || isPcm))
+                    return false;
+
+                int bytesPerSample = bitsPerSample / 8;
+                size_t numFrames = available / static_cast<size_t>(bytesPerSample * numChannels);
+                samples.resize(numFrames);
+                for (size_t i = 0; i < numFrames; ++i)
+                {
+                    float sum = 0.0f;
+                    for (int chan = 0; chan < numChannels; ++chan)
+                        sum += decodeSample(chunk + (i * static_cast<size_t>(numChannels) + static_cast<size_t>(chan)) * static_cast<size_t>(bytesPerSample),
+                                            bitsPerSample, isFloat);
+                    samples[i] = sum / static_cast<float>(numChannels);
+                }
+                return sampleRate > 0.0;
+            }
+
+            pos += 8 + chunkSize + (chunkSize & 1); // Chunks are padded to an even size
+        }
+        return false;
+    }
+
+private:
+    static constexpr int pcmFormat = 1;
+    static constexpr int floatFormat = 3;
+    static constexpr int extensibleFormat = 0xfffe;
+
+    static uint32_t readLE(const uint8_t* data, int numBytes)
+    {
+        uint32_t value = 0;
+        for (int i = numBytes - 1; i >= 0; --i)
+            value = (value << 8) | data[i];
+        return value;
+    }
+
+    static float decodeSample(const uint8_t* data, int bitsPerSample, bool isFloat)
+    {
+        if (isFloat)
+        {
+            uint32_t bits = readLE(data, 4);
+            float value;
+            std::memcpy(&value, &bits, sizeof(value));
+            return value;
+        }
+
+        switch (bitsPerSample)
+        {
+            case 8:  return (static_cast<float>(data[0]) - 128.0f) / 128.0f; // 8-bit WAV is unsigned
+            case 16: return static_cast<float>(static_cast<int16_t>(readLE(data, 2))) / 32768.0f;
+            case 24: return static_cast<float>(static_cast<int32_t>(readLE(data, 3) << 8) >> 8) / 8388608.0f;
+            default: return static_cast<float>(static_cast<int32_t>(readLE(data, 4))) / 2147483648.0f;
+        }
+    }
+};
@@ -0,0 +1,167 @@
+/*
+  ==============================================================================
+
+    WavWriter.h
+    Created: 20 Oct 2026 9:12:05am
+    Author:  70
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+/**
+ * @class WavWriter
+ *
+ * @brief Streams float audio to a RIFF WAV file, as 16 or 24-bit PCM or 32-bit float.
+ *
+ * The header is written when the file is opened and its sizes are patched on close(), so audio can be
+ * appended in blocks of any size without knowing the total length up front. Samples are clipped to
+ * [-1, 1] when converted to PCM.
+ */
+class WavWriter
+{
+public:
+    enum class Format { pcm16, pcm24, float32 };
+
+    WavWriter() = default;
+    ~WavWriter() { close(); }
+
+    WavWriter(const WavWriter&) = delete;
+    WavWriter& operator=(const WavWriter&) = delete;
+
+    /// Creates or overwrites a file. Returns false if it cannot be opened.
+    bool open(const std::string& path, double sampleRate, int numChannels, Format format = Format::pcm16)
+    {
+        close();
+        file = std::fopen(path.c_str(), "wb");
+        if (file == nullptr)
+            return false;
+
+        channels = std::max(1, numChannels);
+        sampleFormat = format;
+        bytesPerSample = format == Format::pcm16 ? 2 : (format == Format::pcm24 ? 3 : 4);
+        dataBytes = 0;
+        writeHeader(static_cast<uint32_t>(sampleRate));
+        return true;
+    }
+
+    /// Returns true while a file is open.
+    bool isOpen() const { return file != nullptr; }
+
+    /// Appends numSamples frames from one pointer per channel.
+    void write(const float* const* data, int numSamples)
+    {
+        if (file == nullptr)
+            return;
+
+        frameBuffer.resize(static_cast<size_t>(numSamples) * channels * bytesPerSample);
+        uint8_t* dest = frameBuffer.data();
+        for (int i = 0; i < numSamples; ++i)
+        {
+            for (int chan = 0; chan < channels; ++chan)
+            {
+                encodeSample(data[chan][i], dest);
+                dest += bytesPerSample;
+            }
+        }
+
+        dataBytes += std::fwrite(frameBuffer.data(), 1, frameBuffer.size(), file);
+    }
+
+    /// Appends mono samples, duplicated to every channel.
+    void writeMono(const float* data, int numSamples)
+    {
+        std::vector<const float*> pointers(static_cast<size_t>(channels), data);
+        write(pointers.data(), numSamples);
+    }
+
+    /// Patches the header sizes and closes the file.
+    void close()
+    {
+        if (file == nullptr)
+            return;
+
+        if ((dataBytes & 1) != 0)
+            std::fputc(0, file); // Chunks are padded to an even size
+
+        uint32_t riffSize = static_cast<uint32_t>(36 + dataBytes + (dataBytes & 1));
+        std::fseek(file, 4, SEEK_SET);
+        writeUint32(riffSize);
+        std::fseek(file, 40, SEEK_SET);
+        writeUint32(static_cast<uint32_t>(dataBytes));
+        std::fclose(file);
+        file = nullptr;
+    }
+
+    /// Returns the number of frames written so far.
+    int64_t getNumFramesWritten() const { return static_cast<int64_t>(dataBytes / (static_cast<uint64_t>(channels) * bytesPerSample)); }
+
+private:
+    std::FILE* file = nullptr;
+    int channels = 1;
+    int bytesPerSample = 2;
+    Format sampleFormat = Format::pcm16;
+    uint64_t dataBytes = 0;
+    std::vector<uint8_t> frameBuffer;
+
+    void writeUint32(uint32_t value)
+    {
+        uint8_t bytes[] = { uint8_t(value), uint8_t(value >> 8), uint8_t(value >> 16), uint8_t(value >> 24) };
+        std::fwrite(bytes, 1, 4, file);
+    }
+
+    void writeUint16(uint16_t value)
+    {
+        uint8_t bytes[] = { uint8_t(value), uint8_t(value >> 8) };
+        std::fwrite(bytes, 1, 2, file);
+    }
+
+    /// Writes the RIFF, fmt and data chunk headers, with zero sizes until close().
+    void writeHeader(uint32_t sampleRate)
+    {
+        std::fwrite("RIFF", 1, 4, file);
+        writeUint32(0);
+        std::fwrite("WAVEfmt ", 1, 8, file);
+        writeUint32(16);
+        writeUint16(sampleFormat == Format::float32 ? 3 : 1); // WAVE_FORMAT_IEEE_FLOAT or WAVE_FORMAT_PCM
+        writeUint16(static_cast<uint16_t>(channels));
+        writeUint32(sampleRate);
+        writeUint32(sampleRate * static_cast<uint32_t>(channels * bytesPerSample));
+        writeUint16(static_cast<uint16_t>(channels * bytesPerSample));
+        writeUint16(static_cast<uint16_t>(bytesPerSample * 8));
+        std::fwrite("data", 1, 4, file);
+        writeUint32(0);
+    }
+
+    /// Converts one sample to little-endian bytes in the output format.
+    void encodeSample(float sample, uint8_t* dest) const
+    {
+        if (sampleFormat == Format::float32)
+        {
+            uint32_t bits;
+            std::memcpy(&bits, &sample, 4);
+            dest[0] = uint8_t(bits); dest[1] = uint8_t(bits >> 8); dest[2] = uint8_t(bits >> 16); dest[3] = uint8_t(bits >> 24);
+            return;
+        }
+
+        sample = std::clamp(sample, -1.0f, 1.0f);
+        if (sampleFormat == Format::pcm16)
+        {
+            auto value = static_cast<int16_t>(std::lrint(sample * 32767.0f));
+            dest[0] = uint8_t(value); dest[1] = uint8_t(value >> 8);
+        }
+        else
+        {
+            auto value = static_cast<int32_t>(std::lrint(sample * 8388607.0f));
+            dest[0] = uint8_t(value); dest[1] = uint8_t(value >> 8); dest[2] = uint8_t(value >> 16);
+        }
+    }
+};
@@ -0,0 +1,196 @@
+/*
+  ==============================================================================
+
+    DiskRecorder.h
+    Created: 21 Oct 2026 10:18:22am
+    Author:  70
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include <atomic>
+
+/**
+ * @class DiskRecorder
+ *
+ * @brief Captures the plugin output to a WAV or FLAC file from a background thread.
+ *
+ * The audio thread only copies each block into a preallocated ring buffer (push()), which never
+ * blocks, locks or allocates. A writer thread drains the ring buffer in large chunks, so the disk sees
+ * few big sequential writes. If the writer falls behind and the ring buffer is full, the block is
+ * dropped rather than waiting; overruns and dropped samples are counted and logged when the recording
+ * stops.
+ *
+ * start() and stop() are called from the message thread. push() may run concurrently with them.
+ */
+class DiskRecorder : private juce::Thread
+{
+public:
+    DiskRecorder() : juce::Thread ("Chiptune Disk Recorder") {}
+    ~DiskRecorder() override { stop(); }
+
+    //==============================================================================
+    /**
+     * @brief Creates or overwrites the file and starts recording. Stops any previous recording first.
+     *
+     * @param file           destination, written as FLAC if its extension is .flac, WAV otherwise
+     * @param sampleRate     sample rate of the audio that will be pushed
+     * @param numChannels    number of channels that will be pushed
+     * @param bitsPerSample  16 or 24
+     * @param bufferSeconds  length of the ring buffer, how long the disk may stall before samples are dropped
+     * @return false if the file cannot be written
+     */
+    bool start (const juce::File& file, double sampleRate, int numChannels, int bitsPerSample = 24, double bufferSeconds = 4.0)
+    {
+        stop();
+
+        std::unique_ptr<juce::AudioFormat> format;
+        if (file.hasFileExtension ("flac"))
+            format = std::make_unique<juce::FlacAudioFormat>();
+        else
+            format = std::make_unique<juce::WavAudioFormat>();
+
+        file.deleteFile();
+        auto stream = file.createOutputStream (1 << 18);
+        if (stream == nullptr)
+            return false;
+
+        writer.reset (format->createWriterFor (stream.get(), sampleRate, static_cast<unsigned int> (numChannels),
+                                               bitsPerSample, {}, 0));
+        if (writer == nullptr)
+            return false;
+        stream.release(); // The writer owns the stream now
+
+        int bufferSize = juce::jmax (1024, static_cast<int> (bufferSeconds * sampleRate));
+        ringBuffer.setSize (numChannels, bufferSize);
+        fifo.setTotalSize (bufferSize);
+        fifo.reset();
+        writeChunkSize = juce::jmin (bufferSize / 4, static_cast<int> (0.5 * sampleRate));
+
+        recordingSampleRate = sampleRate;
+        numOverruns = 0;
+        numDroppedSamples = 0;
+        numSamplesWritten = 0;
+        startThread();
+        recording = true;
+        return true;
+    }
+
+    /// Stops recording, writes everything still buffered and closes the file.
+    void stop()
+    {
+        recording = false;
+        while (numPushing.load() > 0) // Let a push that saw recording == true finish
+            juce::Thread::yield();
+
+        if (writer == nullptr)
+            return;
+
+        stopThread (-1);
+        drain (1);
+        writer.reset();
+
+        if (numOverruns > 0)
+            juce::Logger::writeToLog ("DiskRecorder: " + juce::String (numOverruns.load()) + " overruns, "
+                                      + juce::String (numDroppedSamples.load()) + " samples dropped");
+    }
+
+    /// Returns true while a recording is running.
+    bool isRecording() const { return recording; }
+
+    /// Returns the sample rate of the current or last recording.
+    double getSampleRate() const { return recordingSampleRate; }
+
+    //==============================================================================
+    /**
+     * @brief Copies a block into the ring buffer. Audio thread, wait-free.
+     *
+     * If the ring buffer cannot hold the whole block, it is dropped and counted as an overrun.
+     * Extra channels are ignored, missing channels are written silent.
+     */
+    void push (const juce::AudioBuffer<float>& buffer)
+    {
+        ++numPushing;
+        if (recording)
+        {
+            int numSamples = buffer.getNumSamples();
+            if (fifo.getFreeSpace() < numSamples)
+            {
+                ++numOverruns;
+                numDroppedSamples += numSamples;
+            }
+            else
+            {
+                int start1, size1, start2, size2;
+                fifo.prepareToWrite (numSamples, start1, size1, start2, size2);
+                for (int chan = 0; chan < ringBuffer.getNumChannels(); ++chan)
+                {
+                    if (chan < buffer.getNumChannels())
+                    {
+                        ringBuffer.copyFrom (chan, start1, buffer, chan, 0, size1);
+                        if (size2 > 0)
+                            ringBuffer.copyFrom (chan, start2, buffer, chan, size1, size2);
+                    }
+                    else
+                    {
+                        ringBuffer.clear (chan, start1, size1);
+                        if (size2 > 0)
+                            ringBuffer.clear (chan, start2, size2);
+                    }
+                }
+                fifo.finishedWrite (size1 + size2);
+            }
+        }
+        --numPushing;
+    }
+
+    /// Returns how many blocks were dropped because the ring buffer was full.
+    juce::int64 getNumOverruns() const { return numOverruns; }
+
+    /// Returns how many samples per channel were dropped because the ring buffer was full.
+    juce::int64 getNumDroppedSamples() const { return numDroppedSamples; }
+
+    /// Returns how many samples per channel reached the file.
+    juce::int64 getNumSamplesWritten() const { return numSamplesWritten; }
+
+private:
+    std::unique_ptr<juce::AudioFormatWriter> writer;
+    juce::AudioBuffer<float> ringBuffer;
+    juce::AbstractFifo fifo { 1 };
+    int writeChunkSize = 1;                      // Samples the writer waits for before writing, so writes are large.
+    double recordingSampleRate = 0.0;
+
+    std::atomic<bool> recording { false };
+    std::atomic<int> numPushing { 0 };           // Audio threads currently inside push().
+    std::atomic<juce::int64> numOverruns { 0 };
+    std::atomic<juce::int64> numDroppedSamples { 0 };
+    std::atomic<juce::int64> numSamplesWritten { 0 };
+
+    void run() override
+    {
+        while (! threadShouldExit())
+            if (! drain (writeChunkSize))
+                wait (20);
+    }
+
+    /// Writes what is in the ring buffer if there are at least minSamples. Returns true if it wrote.
+    bool drain (int minSamples)
+    {
+        int numReady = fifo.getNumReady();
+        if (numReady < minSamples || numReady == 0)
+            return false;
+
+        int start1, size1, start2, size2;
+        fifo.prepareToRead (numReady, start1, size1, start2, size2);
+        writer->writeFromAudioSampleBuffer (ringBuffer, start1, size1);
+        if (size2 > 0)
+            writer->writeFromAudioSampleBuffer (ringBuffer, start2, size2);
+        fifo.finishedRead (size1 + size2);
+        numSamplesWritten += size1 + size2;
+        return true;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DiskRecorder)
+};
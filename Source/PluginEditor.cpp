@@ -1,40 +1,42 @@
-/*
-  ==============================================================================
-
-    This file contains the basic framework code for a JUCE plugin editor.
-
-  ==============================================================================
-*/
-
-#include "PluginProcessor.h"
-#include "PluginEditor.h"
-
-//==============================================================================
-AP_assessment3AudioProcessorEditor::AP_assessment3AudioProcessorEditor (AP_assessment3AudioProcessor& p)
-    : AudioProcessorEditor (&p), audioProcessor (p)
-{
-    // Make sure that before the constructor has finished, you've set the
-    // editor's size to whatever you need it to be.
-    setSize (400, 300);
-}
-
-AP_assessment3AudioProcessorEditor::~AP_assessment3AudioProcessorEditor()
-{
-}
-
-//==============================================================================
-void AP_assessment3AudioProcessorEditor::paint (juce::Graphics& g)
-{
-    // (Our component is opaque, so we must completely fill the background with a solid colour)
-    g.fillAll (getLookAndFeel().findColour (juce::ResizableWindow::backgroundColourId));
-
-    g.setColour (juce::Colours::white);
-    g.setFont (15.0f);
-    g.drawFittedText ("Hello World!", getLocalBounds(), juce::Justification::centred, 1);
-}
-
-void AP_assessment3AudioProcessorEditor::resized()
-{
-    // This is generally where you'll want to lay out the positions of any
-    // subcomponents in your editor..
-}
+/*
+  ==============================================================================
+
+    This file contains the basic framework code for a JUCE plugin editor.
+
+  ==============================================================================
+*/
+
+#include "PluginProcessor.h"
+#include "PluginEditor.h"
+
+//==============================================================================
+AP_assessment3AudioProcessorEditor::AP_assessment3AudioProcessorEditor (AP_assessment3AudioProcessor& p)
+    : AudioProcessorEditor (&p), audioProcessor (p),
+      analysisDisplay (p.getAnalysisFeed()),
+      parameterEditor (p)
+{
+    addAndMakeVisible (analysisDisplay);
+    addAndMakeVisible (parameterEditor);
+    
+    // Make sure that before the constructor has finished, you've set the
+    // editor's size to whatever you need it to be.
+    setSize (juce::jmax (displayWidth, parameterEditor.getWidth()), displayHeight + parameterEditor.getHeight());
+}
+
+AP_assessment3AudioProcessorEditor::~AP_assessment3AudioProcessorEditor()
+{
+}
+
+//==============================================================================
+void AP_assessment3AudioProcessorEditor::paint (juce::Graphics& g)
+{
+    // (Our component is opaque, so we must completely fill the background with a solid colour)
+    g.fillAll (getLookAndFeel().findColour (juce::ResizableWindow::backgroundColourId));
+}
+
+void AP_assessment3AudioProcessorEditor::resized()
+{
+    auto area = getLocalBounds();
+    analysisDisplay.setBounds (area.removeFromTop (displayHeight));
+    parameterEditor.setBounds (area);
+}
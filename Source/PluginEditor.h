@@ -1,33 +1,40 @@
-/*
-  ==============================================================================
-
-    This file contains the basic framework code for a JUCE plugin editor.
-
-  ==============================================================================
-*/
-
-#pragma once
-
-#include <JuceHeader.h>
-#include "PluginProcessor.h"
-
-//==============================================================================
-/**
-*/
-class AP_assessment3AudioProcessorEditor  : public juce::AudioProcessorEditor
-{
-public:
-    AP_assessment3AudioProcessorEditor (AP_assessment3AudioProcessor&);
-    ~AP_assessment3AudioProcessorEditor() override;
-
-    //==============================================================================
-    void paint (juce::Graphics&) override;
-    void resized() override;
-
-private:
-    // This reference is provided as a quick way for your editor to
-    // access the processor object that created it.
-    AP_assessment3AudioProcessor& audioProcessor;
-
-    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AP_assessment3AudioProcessorEditor)
-};
+/*
+  ==============================================================================
+
+    This file contains the basic framework code for a JUCE plugin editor.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+#include "AnalysisDisplay.h"
+
+//==============================================================================
+/**
+*/
+class AP_assessment3AudioProcessorEditor  : public juce::AudioProcessorEditor
+{
+public:
+    AP_assessment3AudioProcessorEditor (AP_assessment3AudioProcessor&);
+    ~AP_assessment3AudioProcessorEditor() override;
+
+    //==============================================================================
+    void paint (juce::Graphics&) override;
+    void resized() override;
+
+private:
+    static constexpr int displayWidth = 640;
+    static constexpr int displayHeight = 200;
+    
+    // This reference is provided as a quick way for your editor to
+    // access the processor object that created it.
+    AP_assessment3AudioProcessor& audioProcessor;
+    
+    AnalysisDisplay analysisDisplay;                // Scope, spectrum and voice activity
+    juce::GenericAudioProcessorEditor parameterEditor; // One control per parameter, below the display
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AP_assessment3AudioProcessorEditor)
+};
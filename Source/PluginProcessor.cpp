@@ -1,294 +1,554 @@
-/*
-  ==============================================================================
-
-    This file contains the basic framework code for a JUCE plugin processor.
-
-  ==============================================================================
-*/
-
-#include "PluginProcessor.h"
-#include "PluginEditor.h"
-
-//==============================================================================
-AP_assessment3AudioProcessor::AP_assessment3AudioProcessor()
-#ifndef JucePlugin_PreferredChannelConfigurations
-     : AudioProcessor (BusesProperties()
-                     #if ! JucePlugin_IsMidiEffect
-                      #if ! JucePlugin_IsSynth
-                       .withInput  ("Input",  juce::AudioChannelSet::stereo(), true)
-                      #endif
-                       .withOutput ("Output", juce::AudioChannelSet::stereo(), true)
-                     #endif
-                       ),
-#endif
-apvts(*this, nullptr, "ParamTree", createParameterLayout())
-{
-    // ADSR
-    attackParam = apvts.getRawParameterValue("attack");
-    decayParam = apvts.getRawParameterValue("decay");
-    sustainParam = apvts.getRawParameterValue("sustain");
-    releaseParam = apvts.getRawParameterValue("release");
-    
-    // pulse width
-    pulseWidthParam = apvts.getRawParameterValue("pulseWidth");
-    pwmSustainParam = apvts.getRawParameterValue("pwmSustain");
-    pwmSwitchParam = apvts.getRawParameterValue("pwmSwitch");
-    pwmModeParam = apvts.getRawParameterValue("pwmMode");
-    pwmRateParam = apvts.getRawParameterValue("pwmRate");
-    
-    // Osc & Distortion
-    oscTypeParam = apvts.getRawParameterValue("oscType");
-    triDistortionParam = apvts.getRawParameterValue("triDistortion");
-    noiseDistortionParam = apvts.getRawParameterValue("noiseDistortion");
-    
-    // Pitch Bend
-    pbSwitchParam = apvts.getRawParameterValue("pbSwitch");
-    pbInitPitchParam = apvts.getRawParameterValue("pbInitPitch");
-    pbTimeParam = apvts.getRawParameterValue("pbTime");
-    
-    // Vibrato
-    vibSwitchParam = apvts.getRawParameterValue("vibSwitch");
-    vibSpeedParam = apvts.getRawParameterValue("vibSpeed");
-    vibAmountParam = apvts.getRawParameterValue("vibAmount");
-    vibSustainParam = apvts.getRawParameterValue("vibSustain");
-    
-    // Arpeggiator
-    arpSwitchParam = apvts.getRawParameterValue("arpSwitch");
-    arpPatternParam = apvts.getRawParameterValue("arpPattern");
-    arpOctaveParam = apvts.getRawParameterValue("arpOctave");
-    arpSpeedParam = apvts.getRawParameterValue("arpSpeed");
-    
-    
-    // bitcrusher
-    rateReductionParam = apvts.getRawParameterValue("rateReduction");
-    bitDepthParam = apvts.getRawParameterValue("bitDepth");
-    
-    // delay
-    delayTimeParam = apvts.getRawParameterValue("delayTime");
-    feedbackParam = apvts.getRawParameterValue("feedback");
-    dryWetMixParam = apvts.getRawParameterValue("dryWetMix");
-    
-    // init synth
-    synth.addSound( new ChiptuneSynthSound() );
-    
-    for (int i = 0; i< voiceCount; i++)
-    {
-        synth.addVoice( new ChiptuneSynthVoice(apvts) );
-    }
-}
-
-AP_assessment3AudioProcessor::~AP_assessment3AudioProcessor()
-{
-}
-
-//==============================================================================
-
-const juce::String AP_assessment3AudioProcessor::getName() const
-{
-    return JucePlugin_Name;
-}
-
-bool AP_assessment3AudioProcessor::acceptsMidi() const
-{
-   #if JucePlugin_WantsMidiInput
-    return true;
-   #else
-    return false;
-   #endif
-}
-
-bool AP_assessment3AudioProcessor::producesMidi() const
-{
-   #if JucePlugin_ProducesMidiOutput
-    return true;
-   #else
-    return false;
-   #endif
-}
-
-bool AP_assessment3AudioProcessor::isMidiEffect() const
-{
-   #if JucePlugin_IsMidiEffect
-    return true;
-   #else
-    return false;
-   #endif
-}
-
-double AP_assessment3AudioProcessor::getTailLengthSeconds() const
-{
-    return 0.0;
-}
-
-int AP_assessment3AudioProcessor::getNumPrograms()
-{
-    return 1;   // NB: some hosts don't cope very well if you tell them there are 0 programs,
-                // so this should be at least 1, even if you're not really implementing programs.
-}
-
-int AP_assessment3AudioProcessor::getCurrentProgram()
-{
-    return 0;
-}
-
-void AP_assessment3AudioProcessor::setCurrentProgram (int index)
-{
-}
-
-const juce::String AP_assessment3AudioProcessor::getProgramName (int index)
-{
-    return {};
-}
-
-void AP_assessment3AudioProcessor::changeProgramName (int index, const juce::String& newName)
-{
-}
-
-//==============================================================================
-void AP_assessment3AudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
-{
-    // init synth&smoother
-    synth.setCurrentPlaybackSampleRate(sampleRate);
-    smoothVal.reset(sampleRate, 2.0); // set sample rate and ramp time
-    smoothVal.setCurrentAndTargetValue(1.0); // initialise
-    
-    // init delay
-    int delayCount = 2;
-    delays.clear();
-    for (int i = 0; i < delayCount; i++)
-    {
-        delays.push_back(Delay());
-        delays[i].setSize(sampleRate * 3);
-        delays[i].setDelayTime(sampleRate * 0.5);
-        delays[i].setFeedback(0.1);  // Example feedback value
-        delays[i].setDryWetMix(0.2);
-    }
-    
-    // init bitcrusher
-    int bitcrusherCount = 2;
-    bitcrushers.clear();
-    for (int j = 0; j < bitcrusherCount; j++)
-    {
-        bitcrushers.push_back(Bitcrusher());
-        bitcrushers[j].setSampleRateReduction(1);
-        bitcrushers[j].setBitDepth(24);
-    }
-}
-
-void AP_assessment3AudioProcessor::releaseResources()
-{
-    // When playback stops, you can use this as an opportunity to free up any
-    // spare memory, etc.
-}
-
-#ifndef JucePlugin_PreferredChannelConfigurations
-bool AP_assessment3AudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts) const
-{
-  #if JucePlugin_IsMidiEffect
-    juce::ignoreUnused (layouts);
-    return true;
-  #else
-    // This is the place where you check if the layout is supported.
-    // In this template code we only support mono or stereo.
-    // Some plugin hosts, such as certain GarageBand versions, will only
-    // load plugins that support stereo bus layouts.
-    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::mono()
-     && layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
-        return false;
-
-    // This checks if the input layout matches the output layout
-   #if ! JucePlugin_IsSynth
-    if (layouts.getMainOutputChannelSet() != layouts.getMainInputChannelSet())
-        return false;
-   #endif
-
-    return true;
-  #endif
-}
-#endif
-
-void AP_assessment3AudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
-{
-    // Get the number of input and output channels for the audio buffer
-    juce::ScopedNoDenormals noDenormals;
-    auto totalNumInputChannels  = getTotalNumInputChannels();
-    auto totalNumOutputChannels = getTotalNumOutputChannels();
-
-    // clear buffer
-    for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
-        buffer.clear (i, 0, buffer.getNumSamples());
-
-    // Retrieve pointers to the audio buffer's left and right channels
-    int numSamples = buffer.getNumSamples();
-    float* samplesLeft = buffer.getWritePointer(0);
-    float* samplesRight = buffer.getWritePointer(1);
-    
-    // Render the next block of MIDI data through the synthesizer into our audio buffer
-    synth.renderNextBlock (buffer, midiMessages, 0, buffer.getNumSamples());
-    
-    // update bitcrusher
-    for (int k = 0; k < 2; ++k)
-    {
-        bitcrushers[k].setSampleRateReduction(*rateReductionParam );
-        bitcrushers[k].setBitDepth(*bitDepthParam );
-    }
-    
-    // update delay
-    for (int j = 0; j < 2; ++j)
-    {
-        delays[j].setDelayTime(getSampleRate() * (*delayTimeParam));
-        delays[j].setFeedback(*feedbackParam);
-        delays[j].setDryWetMix(*dryWetMixParam);
-    }
-
-    // Process each sample for DSP effects (bitcrushing followed by delay)
-    for(int i = 0; i< numSamples; ++i)
-    {
-        float processedLeft = bitcrushers[0].process(samplesLeft[i]);
-        float processedRight = bitcrushers[1].process(samplesRight[i]);
-        
-        samplesLeft[i] = delays[0].process(processedLeft);
-        samplesRight[i] = delays[1].process(processedRight);
-        
-//        samplesLeft[i] = delays[0].process(samplesLeft[i]);
-//        samplesRight[i] = delays[1].process(samplesRight[i]);
-    }
-}
-
-//==============================================================================
-bool AP_assessment3AudioProcessor::hasEditor() const
-{
-    return true; // (change this to false if you choose to not supply an editor)
-}
-
-juce::AudioProcessorEditor* AP_assessment3AudioProcessor::createEditor()
-{
-    return new juce::GenericAudioProcessorEditor(*this);
-}
-
-//==============================================================================
-void AP_assessment3AudioProcessor::getStateInformation (juce::MemoryBlock& destData)
-{
-    auto state = apvts.copyState();
-    std::unique_ptr<juce::XmlElement> xml (state.createXml());
-    copyXmlToBinary (*xml, destData);
-}
-
-void AP_assessment3AudioProcessor::setStateInformation (const void* data, int sizeInBytes)
-{
-    std::unique_ptr<juce::XmlElement> xmlState (getXmlFromBinary (data, sizeInBytes));
-    if (xmlState.get() != nullptr)
-    {
-        if (xmlState->hasTagName (apvts.state.getType()))
-        {
-            apvts.replaceState (juce::ValueTree::fromXml (*xmlState));
-        }
-    }
-}
-
-//==============================================================================
-// This creates new instances of the plugin..
-juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
-{
-    return new AP_assessment3AudioProcessor();
-}
+/*
+  ==============================================================================
+
+    This file contains the basic framework code for a JUCE plugin processor.
+
+  ==============================================================================
+*/
+
+#include "PluginProcessor.h"
+#include "PluginEditor.h"
+#include "ChiptuneState.h"
+
+//==============================================================================
+AP_assessment3AudioProcessor::AP_assessment3AudioProcessor()
+#ifndef JucePlugin_PreferredChannelConfigurations
+     : AudioProcessor (BusesProperties()
+                     #if ! JucePlugin_IsMidiEffect
+                      #if ! JucePlugin_IsSynth
+                       .withInput  ("Input",  juce::AudioChannelSet::stereo(), true)
+                      #endif
+                       .withOutput ("Output", juce::AudioChannelSet::stereo(), true)
+                      #if JucePlugin_IsSynth
+                       // Optional dry outputs, one per oscillator type, in the order of ChiptuneVoice::getOscType()
+                       .withOutput ("Pulse", juce::AudioChannelSet::stereo(), false)
+                       .withOutput ("Triangle", juce::AudioChannelSet::stereo(), false)
+                       .withOutput ("Noise", juce::AudioChannelSet::stereo(), false)
+                      #endif
+                     #endif
+                       ),
+#endif
+apvts(*this, nullptr, "ParamTree", createParameterLayout())
+{
+    // live parameter snapshot for the engine
+    for (int i = 0; i < ChiptuneParameters::numParameters; ++i)
+        liveParameterValues[i] = apvts.getRawParameterValue(ChiptuneParameters::getId(i));
+    updateLiveParameters();
+    qualityParameter = apvts.getRawParameterValue ("quality");
+    
+    startTimerHz (2);
+}
+
+AP_assessment3AudioProcessor::~AP_assessment3AudioProcessor()
+{
+    stopTimer();
+    cancelPendingUpdate();
+}
+
+//==============================================================================
+
+const juce::String AP_assessment3AudioProcessor::getName() const
+{
+    return JucePlugin_Name;
+}
+
+bool AP_assessment3AudioProcessor::acceptsMidi() const
+{
+   #if JucePlugin_WantsMidiInput
+    return true;
+   #else
+    return false;
+   #endif
+}
+
+bool AP_assessment3AudioProcessor::producesMidi() const
+{
+   #if JucePlugin_ProducesMidiOutput
+    return true;
+   #else
+    return false;
+   #endif
+}
+
+bool AP_assessment3AudioProcessor::isMidiEffect() const
+{
+   #if JucePlugin_IsMidiEffect
+    return true;
+   #else
+    return false;
+   #endif
+}
+
+double AP_assessment3AudioProcessor::getTailLengthSeconds() const
+{
+    return 0.0;
+}
+
+int AP_assessment3AudioProcessor::getNumPrograms()
+{
+    return juce::jmax (1, programs.getNumPrograms());   // NB: some hosts don't cope very well if you tell them there are 0 programs,
+                                                        // so this should be at least 1, even if you're not really implementing programs.
+}
+
+int AP_assessment3AudioProcessor::getCurrentProgram()
+{
+    return currentProgram.load();
+}
+
+void AP_assessment3AudioProcessor::setCurrentProgram (int index)
+{
+    if (! programs.contains (index))
+        return;
+    
+    currentProgram.store (index);
+    applyProgramToParameters (index);
+}
+
+const juce::String AP_assessment3AudioProcessor::getProgramName (int index)
+{
+    if (! programs.contains (index))
+        return {};
+    return programs.getProgram (index).name;
+}
+
+void AP_assessment3AudioProcessor::changeProgramName (int index, const juce::String& newName)
+{
+}
+
+//==============================================================================
+void AP_assessment3AudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
+{
+    // init voices, bitcrushers and delays, and restart the random streams
+    // so every render starts from the same state
+    engine.prepare(sampleRate);
+    sessionRecorder.writePrepare (sampleRate);
+    
+    // start from the quality of this instance, the governor lowers it again if needed
+    governor.reset();
+    applyRenderQuality();
+    
+    // a recording cannot change its sample rate midway
+    if (recorder.isRecording() && sampleRate != recorder.getSampleRate())
+        recorder.stop();
+    
+    analysisFeed.prepare (sampleRate);
+}
+
+void AP_assessment3AudioProcessor::releaseResources()
+{
+    // When playback stops, you can use this as an opportunity to free up any
+    // spare memory, etc.
+}
+
+#ifndef JucePlugin_PreferredChannelConfigurations
+bool AP_assessment3AudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts) const
+{
+  #if JucePlugin_IsMidiEffect
+    juce::ignoreUnused (layouts);
+    return true;
+  #else
+    // This is the place where you check if the layout is supported.
+    // In this template code we only support mono or stereo.
+    // Some plugin hosts, such as certain GarageBand versions, will only
+    // load plugins that support stereo bus layouts.
+    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::mono()
+     && layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
+        return false;
+
+    // This checks if the input layout matches the output layout
+   #if ! JucePlugin_IsSynth
+    if (layouts.getMainOutputChannelSet() != layouts.getMainInputChannelSet())
+        return false;
+   #endif
+
+    // The aux outputs are either off, mono or stereo
+    for (int bus = 1; bus < layouts.getBusCount (false); ++bus)
+    {
+        auto channelSet = layouts.getChannelSet (false, bus);
+        if (! channelSet.isDisabled()
+         && channelSet != juce::AudioChannelSet::mono()
+         && channelSet != juce::AudioChannelSet::stereo())
+            return false;
+    }
+
+    return true;
+  #endif
+}
+#endif
+
+void AP_assessment3AudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
+{
+    // Get the number of input and output channels for the audio buffer
+    juce::ScopedNoDenormals noDenormals;
+    auto startTicks = juce::Time::getHighResolutionTicks();
+    auto totalNumInputChannels  = getTotalNumInputChannels();
+    auto totalNumOutputChannels = getTotalNumOutputChannels();
+
+    // clear buffer
+    for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
+        buffer.clear (i, 0, buffer.getNumSamples());
+
+    int numSamples = buffer.getNumSamples();
+    auto mainBuffer = getBusBuffer (buffer, false, 0);
+    
+    // Take one snapshot of the parameters for all voices in this block
+    updateLiveParameters();
+    applyRenderQuality();
+    bool loggingSession = beginSessionBlock (buffer);
+    
+    // Render the block in segments, applying each MIDI event at its sample position
+    int startSample = 0;
+    for (const auto metadata : midiMessages)
+    {
+        int eventPos = juce::jlimit (startSample, numSamples, metadata.samplePosition);
+        if (eventPos > startSample)
+        {
+            renderSegment (buffer, startSample, eventPos - startSample);
+            startSample = eventPos;
+        }
+        handleMidiMessage (metadata.getMessage());
+        
+        // A program change sets the parameters, which are logged as changes after the message
+        if (loggingSession)
+        {
+            sessionRecorder.addMidi (eventPos, metadata.data, metadata.numBytes);
+            sessionRecorder.addParameterChanges (eventPos, engine.getParameters());
+        }
+    }
+    
+    if (startSample < numSamples)
+        renderSegment (buffer, startSample, numSamples - startSample);
+    
+    recorder.push (mainBuffer);
+    if (mainBuffer.getNumChannels() > 0)
+        analysisFeed.push (mainBuffer.getReadPointer (0), numSamples, engine);
+    
+    double elapsed = juce::Time::highResolutionTicksToSeconds (juce::Time::getHighResolutionTicks() - startTicks);
+    if (loggingSession)
+        endSessionBlock (buffer, elapsed);
+    updateRenderQuality (elapsed, numSamples);
+}
+
+bool AP_assessment3AudioProcessor::beginSessionBlock (juce::AudioBuffer<float>& buffer)
+{
+    if (! sessionRecorder.isCapturing())
+        return false;
+    
+    SessionLog::BlockInfo info;
+    info.numSamples = static_cast<uint32_t> (buffer.getNumSamples());
+    info.quality = engine.getRenderQuality();
+    if (isNonRealtime())
+        info.flags |= SessionLog::isNonRealtime;
+    
+    if (auto* playHead = getPlayHead())
+    {
+        if (auto position = playHead->getPosition())
+        {
+            if (position->getIsPlaying())
+                info.flags |= SessionLog::isPlaying;
+            if (auto timeInSamples = position->getTimeInSamples())
+            {
+                info.flags |= SessionLog::hasPosition;
+                info.timeInSamples = *timeInSamples;
+            }
+            info.ppqPosition = position->getPpqPosition().orFallback (0.0);
+            info.bpm = position->getBpm().orFallback (0.0);
+        }
+    }
+    
+    // The channels renderSegment() renders, so the replay renders the same buses
+    info.numChannels = static_cast<uint8_t> (juce::jmin (getBusBuffer (buffer, false, 0).getNumChannels(), ChiptuneEngine::maxChannels));
+    for (int type = 0; type < ChiptuneEngine::numOscTypes && type + 1 < getBusCount (false); ++type)
+    {
+        auto* bus = getBus (false, type + 1);
+        if (bus != nullptr && bus->isEnabled())
+            info.auxChannels[type] = static_cast<uint8_t> (juce::jmin (getBusBuffer (buffer, false, type + 1).getNumChannels(), ChiptuneEngine::maxChannels));
+    }
+    
+    if (! sessionRecorder.beginBlock (info))
+        return false;
+    
+    // Parameters set since the last block, by the host or the editor
+    sessionRecorder.addParameterChanges (0, engine.getParameters());
+    return true;
+}
+
+void AP_assessment3AudioProcessor::endSessionBlock (juce::AudioBuffer<float>& buffer, double elapsedSeconds)
+{
+    auto mainBuffer = getBusBuffer (buffer, false, 0);
+    int numChannels = juce::jmin (mainBuffer.getNumChannels(), ChiptuneEngine::maxChannels);
+    auto hash = SessionLog::hashOutput (mainBuffer.getArrayOfReadPointers(), numChannels, 0, buffer.getNumSamples());
+    
+    bool missedDeadline = ! isNonRealtime() && elapsedSeconds * getSampleRate() > buffer.getNumSamples();
+    sessionRecorder.endBlock (elapsedSeconds, missedDeadline, hash);
+}
+
+void AP_assessment3AudioProcessor::renderSegment (juce::AudioBuffer<float>& buffer, int startSample, int numSamples)
+{
+    // The engine renders up to two channels per bus, any further outputs stay silent
+    auto mainBuffer = getBusBuffer (buffer, false, 0);
+    int numChannels = juce::jmin (mainBuffer.getNumChannels(), ChiptuneEngine::maxChannels);
+    float* channels[ChiptuneEngine::maxChannels] = {};
+    for (int chan = 0; chan < numChannels; ++chan)
+        channels[chan] = mainBuffer.getWritePointer (chan, startSample);
+    
+    // The voices of each oscillator type with an enabled aux bus render straight into it
+    float* auxChannels[ChiptuneEngine::numOscTypes][ChiptuneEngine::maxChannels] = {};
+    ChiptuneEngine::AuxOutput auxOutputs[ChiptuneEngine::numOscTypes];
+    for (int type = 0; type < ChiptuneEngine::numOscTypes && type + 1 < getBusCount (false); ++type)
+    {
+        auto* bus = getBus (false, type + 1);
+        if (bus == nullptr || ! bus->isEnabled())
+            continue;
+        
+        auto auxBuffer = getBusBuffer (buffer, false, type + 1);
+        auxOutputs[type].numChannels = juce::jmin (auxBuffer.getNumChannels(), ChiptuneEngine::maxChannels);
+        for (int chan = 0; chan < auxOutputs[type].numChannels; ++chan)
+            auxChannels[type][chan] = auxBuffer.getWritePointer (chan, startSample);
+        auxOutputs[type].channels = auxChannels[type];
+    }
+    
+    engine.render (channels, numChannels, numSamples, auxOutputs);
+}
+
+void AP_assessment3AudioProcessor::applyRenderQuality()
+{
+    int tier = static_cast<int> (qualityParameter->load());
+    auto quality = RenderQuality::forTier (tier).limitedTo (governor.getQuality());
+    if (quality != engine.getRenderQuality())
+        engine.setRenderQuality (quality);
+}
+
+void AP_assessment3AudioProcessor::updateRenderQuality (double elapsedSeconds, int numSamples)
+{
+    // Offline renders have no deadline: always render at the quality of this instance
+    if (isNonRealtime())
+    {
+        governor.reset();
+        return;
+    }
+    
+    governor.update (elapsedSeconds, numSamples, getSampleRate());
+}
+
+void AP_assessment3AudioProcessor::timerCallback()
+{
+    int numTransitions = governor.getNumTransitions();
+    numTransitionsLogged = juce::jmax (numTransitionsLogged, numTransitions - QualityGovernor::logSize);
+    
+    for (; numTransitionsLogged < numTransitions; ++numTransitionsLogged)
+    {
+        auto transition = governor.getTransition (numTransitionsLogged);
+        juce::Logger::writeToLog ("QualityGovernor: tier " + juce::String (transition.fromTier) + " -> "
+                                  + juce::String (transition.toTier) + " at block " + juce::String ((juce::int64) transition.blockIndex)
+                                  + ", load " + juce::String (transition.load, 2));
+    }
+}
+
+void AP_assessment3AudioProcessor::handleMidiMessage (const juce::MidiMessage& message)
+{
+    // Notes, the sustain pedal and all notes off are played by the engine, the same way a session replay plays them
+    if (message.isProgramChange())
+        changeProgramFromMidi (message.getProgramChangeNumber());
+    else
+        engine.handleMidi (message.getRawData(), message.getRawDataSize());
+}
+
+void AP_assessment3AudioProcessor::changeProgramFromMidi (int index)
+{
+    if (! programs.contains (index))
+        return;
+    
+    // A copy of the decoded snapshot, the parameters are updated later on the message thread
+    engine.setParameters (programs.getProgram (index).parameters);
+    currentProgram.store (index);
+    programRequests.fetch_add (1);
+    triggerAsyncUpdate();
+}
+
+void AP_assessment3AudioProcessor::applyProgramToParameters (int index)
+{
+    const auto& parameters = programs.getProgram (index).parameters;
+    for (int i = 0; i < ChiptuneParameters::numParameters; ++i)
+    {
+        if (auto* parameter = apvts.getParameter (ChiptuneParameters::getId (i)))
+            parameter->setValueNotifyingHost (parameter->convertTo0to1 (parameters.get (static_cast<ChiptuneParameters::Index> (i))));
+    }
+}
+
+void AP_assessment3AudioProcessor::handleAsyncUpdate()
+{
+    // Read the request count first: a program change arriving meanwhile triggers another update
+    int requests = programRequests.load();
+    int index = currentProgram.load();
+    if (programs.contains (index))
+        applyProgramToParameters (index);
+    
+    programRequestsApplied.store (requests);
+    updateHostDisplay (juce::AudioProcessorListener::ChangeDetails().withProgramChanged (true));
+}
+
+//==============================================================================
+bool AP_assessment3AudioProcessor::hasEditor() const
+{
+    return true; // (change this to false if you choose to not supply an editor)
+}
+
+juce::AudioProcessorEditor* AP_assessment3AudioProcessor::createEditor()
+{
+    return new AP_assessment3AudioProcessorEditor (*this);
+}
+
+//==============================================================================
+void AP_assessment3AudioProcessor::getStateInformation (juce::MemoryBlock& destData)
+{
+    auto state = apvts.copyState();
+    
+    // store the random seed and the key zones alongside the parameters
+    {
+        const juce::ScopedLock sl (getCallbackLock());
+        state.setProperty ("randomSeed", static_cast<juce::int64> (engine.getRandomSeed()), nullptr);
+        if (engine.getKeyZones().getNumZones() > 0)
+            state.appendChild (ChiptuneState::keyZonesToValueTree (engine.getKeyZones()), nullptr);
+    }
+    
+    std::unique_ptr<juce::XmlElement> xml (state.createXml());
+    copyXmlToBinary (*xml, destData);
+}
+
+void AP_assessment3AudioProcessor::setStateInformation (const void* data, int sizeInBytes)
+{
+    std::unique_ptr<juce::XmlElement> xmlState (getXmlFromBinary (data, sizeInBytes));
+    if (xmlState.get() != nullptr)
+    {
+        if (xmlState->hasTagName (apvts.state.getType()))
+        {
+            auto state = juce::ValueTree::fromXml (*xmlState);
+            
+            // the key zones are not parameters, take them out before handing the tree to the apvts
+            auto zonesTree = state.getChildWithName ("KeyZones");
+            state.removeChild (zonesTree, nullptr);
+            apvts.replaceState (state);
+            
+            if (state.hasProperty ("randomSeed"))
+                setRandomSeed (static_cast<juce::int64> (state.getProperty ("randomSeed")));
+            
+            // decode the zones first, the audio thread is only held up for the swap
+            KeyZoneMap keyZones;
+            ChiptuneState::keyZonesFromValueTree (keyZones, zonesTree);
+            auto zonesRecord = sessionRecorder.encodeKeyZones (keyZones);
+            
+            const juce::ScopedLock sl (getCallbackLock());
+            engine.getKeyZones().swap (keyZones);
+            sessionRecorder.writeKeyZones (zonesRecord);
+        }
+    }
+}
+
+//==============================================================================
+void AP_assessment3AudioProcessor::addKeyZone (int lowNote, int highNote, const juce::ValueTree& presetState, const juce::String& name)
+{
+    auto parameters = ChiptuneState::parametersFromValueTree (presetState);
+    
+    // only the message thread edits the zones, so they can be copied without the lock
+    KeyZoneMap keyZones (engine.getKeyZones());
+    keyZones.addZone (lowNote, highNote, parameters, name.toStdString());
+    auto zonesRecord = sessionRecorder.encodeKeyZones (keyZones);
+    
+    const juce::ScopedLock sl (getCallbackLock());
+    engine.getKeyZones().swap (keyZones);
+    sessionRecorder.writeKeyZones (zonesRecord);
+}
+
+void AP_assessment3AudioProcessor::addKeyZone (int lowNote, int highNote, const void* presetData, int sizeInBytes, const juce::String& name)
+{
+    std::unique_ptr<juce::XmlElement> xmlState (getXmlFromBinary (presetData, sizeInBytes));
+    if (xmlState.get() != nullptr)
+        addKeyZone (lowNote, highNote, juce::ValueTree::fromXml (*xmlState), name);
+}
+
+void AP_assessment3AudioProcessor::clearKeyZones()
+{
+    KeyZoneMap keyZones;
+    auto zonesRecord = sessionRecorder.encodeKeyZones (keyZones);
+    
+    const juce::ScopedLock sl (getCallbackLock());
+    engine.getKeyZones().swap (keyZones);
+    sessionRecorder.writeKeyZones (zonesRecord);
+}
+
+void AP_assessment3AudioProcessor::addProgram (const juce::String& name, const juce::ValueTree& presetState)
+{
+    auto parameters = ChiptuneState::parametersFromValueTree (presetState);
+    
+    {
+        const juce::ScopedLock sl (getCallbackLock());
+        programs.addProgram (name.toStdString(), parameters);
+    }
+    updateHostDisplay (juce::AudioProcessorListener::ChangeDetails().withProgramChanged (true));
+}
+
+void AP_assessment3AudioProcessor::addProgram (const juce::String& name, const void* presetData, int sizeInBytes)
+{
+    std::unique_ptr<juce::XmlElement> xmlState (getXmlFromBinary (presetData, sizeInBytes));
+    if (xmlState.get() != nullptr)
+        addProgram (name, juce::ValueTree::fromXml (*xmlState));
+}
+
+void AP_assessment3AudioProcessor::clearUserPrograms()
+{
+    {
+        const juce::ScopedLock sl (getCallbackLock());
+        programs.clearUserPrograms();
+    }
+    if (! programs.contains (currentProgram.load()))
+        currentProgram.store (0);
+    updateHostDisplay (juce::AudioProcessorListener::ChangeDetails().withProgramChanged (true));
+}
+
+void AP_assessment3AudioProcessor::setRandomSeed (juce::int64 newSeed)
+{
+    const juce::ScopedLock sl (getCallbackLock());
+    engine.setRandomSeed (static_cast<uint64_t> (newSeed));
+    sessionRecorder.writeSeed (engine.getRandomSeed());
+}
+
+bool AP_assessment3AudioProcessor::startRecording (const juce::File& file)
+{
+    double sampleRate = getSampleRate() > 0.0 ? getSampleRate() : 44100.0;
+    return recorder.start (file, sampleRate, juce::jmax (1, getMainBusNumOutputChannels()));
+}
+
+bool AP_assessment3AudioProcessor::startSessionCapture (const juce::File& file)
+{
+    if (getSampleRate() <= 0.0)
+        return false;
+    
+    // The recorder sets up its file and thread first, and only holds the lock to copy the engine as it plays
+    return sessionRecorder.startCapture (file, engine, getSampleRate(), getCallbackLock());
+}
+
+bool AP_assessment3AudioProcessor::startFlightRecorder (const juce::File& directory, double seconds)
+{
+    if (getSampleRate() <= 0.0)
+        return false;
+    
+    return sessionRecorder.startFlightRecorder (directory, seconds, engine, getSampleRate(), getCallbackLock());
+}
+
+void AP_assessment3AudioProcessor::updateLiveParameters()
+{
+    // After a MIDI program change, the engine keeps the program until the parameters have caught up
+    if (programRequestsApplied.load() != programRequests.load())
+        return;
+    
+    for (int i = 0; i < ChiptuneParameters::numParameters; ++i)
+        engine.setParameter (static_cast<ChiptuneParameters::Index> (i), liveParameterValues[i]->load());
+}
+
+//==============================================================================
+// This creates new instances of the plugin..
+juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
+{
+    return new AP_assessment3AudioProcessor();
+}
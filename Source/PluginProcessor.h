@@ -1,195 +1,290 @@
-/*
-  ==============================================================================
-
-    This file contains the basic framework code for a JUCE plugin processor.
-
-  ==============================================================================
-*/
-
-#pragma once
-
-#include <JuceHeader.h>
-#include "ChiptuneSynthesiser.h"
-#include "Bitcrusher.h"
-#include "Delay.h"
-#include <vector>
-
-//==============================================================================
-/**
-*/
-class AP_assessment3AudioProcessor  : public juce::AudioProcessor
-{
-public:
-    //==============================================================================
-    AP_assessment3AudioProcessor();
-    ~AP_assessment3AudioProcessor() override;
-
-    //==============================================================================
-    void prepareToPlay (double sampleRate, int samplesPerBlock) override;
-    void releaseResources() override;
-
-   #ifndef JucePlugin_PreferredChannelConfigurations
-    bool isBusesLayoutSupported (const BusesLayout& layouts) const override;
-   #endif
-
-    void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
-
-    //==============================================================================
-    juce::AudioProcessorEditor* createEditor() override;
-    bool hasEditor() const override;
-
-    //==============================================================================
-    const juce::String getName() const override;
-
-    bool acceptsMidi() const override;
-    bool producesMidi() const override;
-    bool isMidiEffect() const override;
-    double getTailLengthSeconds() const override;
-
-    //==============================================================================
-    int getNumPrograms() override;
-    int getCurrentProgram() override;
-    void setCurrentProgram (int index) override;
-    const juce::String getProgramName (int index) override;
-    void changeProgramName (int index, const juce::String& newName) override;
-
-    //==============================================================================
-    void getStateInformation (juce::MemoryBlock& destData) override;
-    void setStateInformation (const void* data, int sizeInBytes) override;
-
-private:
-    
-    //--------------------------------------------------------------------------
-    // ADSR envelope parameters
-    std::atomic<float>* attackParam;
-    std::atomic<float>* decayParam;
-    std::atomic<float>* sustainParam;
-    std::atomic<float>* releaseParam;
-    
-    //--------------------------------------------------------------------------
-    // Oscillator type selection parameter
-    std::atomic<float>* oscTypeParam;
-    
-    //--------------------------------------------------------------------------
-    // Parameters related to pulse width modulation
-    std::atomic<float>* pulseWidthParam;
-    std::atomic<float>* pwmSwitchParam;
-    std::atomic<float>* pwmSustainParam;
-    std::atomic<float>* pwmModeParam;
-    std::atomic<float>* pwmRateParam;
-    
-    //--------------------------------------------------------------------------
-    // Tri wave distortion enable parameter
-    std::atomic<float>* triDistortionParam;
-    
-    //--------------------------------------------------------------------------
-    // Noise distortion enable parameter
-    std::atomic<float>* noiseDistortionParam;
-    
-    //--------------------------------------------------------------------------
-    // Arpeggiator related parameters
-    std::atomic<float>* arpSwitchParam;
-    std::atomic<float>* arpPatternParam;
-    std::atomic<float>* arpOctaveParam;
-    std::atomic<float>* arpSpeedParam;
-    
-    //--------------------------------------------------------------------------
-    // Pitch Bend related parameters
-    std::atomic<float>* pbSwitchParam;
-    std::atomic<float>* pbInitPitchParam;
-    std::atomic<float>* pbTimeParam;
-    
-    //--------------------------------------------------------------------------
-    // Vibrato related parameters
-    std::atomic<float>* vibSwitchParam;
-    std::atomic<float>* vibSpeedParam;
-    std::atomic<float>* vibAmountParam;
-    std::atomic<float>* vibSustainParam;
-    
-    //--------------------------------------------------------------------------
-    // Bitcrusher parameters
-    std::atomic<float>* rateReductionParam;
-    std::atomic<float>* bitDepthParam;
-    
-    //--------------------------------------------------------------------------
-    // Delay parameters
-    std::atomic<float>* delayTimeParam;
-    std::atomic<float>* feedbackParam;
-    std::atomic<float>* dryWetMixParam;
-    
-    //==============================================================================
-    // Audio processor value tree state to manage and automate plugin parameters.
-    juce::AudioProcessorValueTreeState apvts;
-    
-    juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout()
-    {
-        juce::AudioProcessorValueTreeState::ParameterLayout layout;
-        
-        // Osc type
-        layout.add (std::make_unique <juce::AudioParameterChoice>(juce::ParameterID("oscType", 1), "Osc Type", juce::StringArray({ "Pulse", "Triangle", "Noise"}),0));
-        
-        // Pulse Width Modulation
-        layout.add (std::make_unique <juce::AudioParameterChoice>(juce::ParameterID("pulseWidth", 1), "Pulse Width", juce::StringArray({ "12.5%", "25%", "50%"}),0));
-        layout.add (std::make_unique<juce::AudioParameterBool>(juce::ParameterID{"pwmSwitch", 1},
-            "PW Mod: On/Off", false));
-        layout.add (std::make_unique <juce::AudioParameterFloat> (juce::ParameterID("pwmSustain", 1), "PW Mod: Sustain", 0.0, 1.0, 0.0));
-        layout.add (std::make_unique <juce::AudioParameterChoice>(juce::ParameterID("pwmMode", 1), "PW Mod: Mode", juce::StringArray({ "12.5%to25%", "12.5%to50%", "25%to50%", "25%to12.5%", "50%to25%", "50%to12.5%"}),0));
-        layout.add (std::make_unique <juce::AudioParameterFloat> (juce::ParameterID("pwmRate", 1), "PW Mod: Rate", 0.0, 1.0, 0.5));
-        
-        // triDistortion
-        layout.add (std::make_unique<juce::AudioParameterBool>(juce::ParameterID{"triDistortion", 1},
-            "Tri Distortion",true));
-        
-        // noiseDistortion
-        layout.add (std::make_unique<juce::AudioParameterBool>(juce::ParameterID{"noiseDistortion", 1},
-            "Noisy Noise",true));
-        
-        // Pitch Bend
-        layout.add (std::make_unique<juce::AudioParameterBool>(juce::ParameterID{"pbSwitch", 1},
-            "Bend: On/Off", false));
-        layout.add (std::make_unique <juce::AudioParameterInt> (juce::ParameterID("pbInitPitch", 1), "Bend: Init.Pitch", -24, 24, 0));
-        layout.add (std::make_unique <juce::AudioParameterFloat> (juce::ParameterID("pbTime", 1), "Bend: Time", 0.01, 3.0, 0.0));
-        
-        // Vibrato
-        layout.add (std::make_unique<juce::AudioParameterBool>(juce::ParameterID{"vibSwitch", 1},
-            "Vibrato: On/Off", false));
-        layout.add (std::make_unique <juce::AudioParameterFloat> (juce::ParameterID("vibSpeed", 1), "Vibrato: Speed", 0.0, 1.0, 0.1));
-        layout.add (std::make_unique <juce::AudioParameterFloat> (juce::ParameterID("vibAmount", 1), "Vibrato: Amount", 0.0, 1.0, 0.1));
-        layout.add (std::make_unique <juce::AudioParameterFloat> (juce::ParameterID("vibSustain", 1), "Vibrato: Sustain", 0.0, 1.0, 0.0));
-        
-        // Arpeggiator
-        layout.add (std::make_unique<juce::AudioParameterBool>(juce::ParameterID{"arpSwitch", 1},
-            "Arp: On/Off", false));
-        layout.add (std::make_unique <juce::AudioParameterChoice>(juce::ParameterID("arpPattern", 1), "Arp:Pattern", juce::StringArray({ "Minor3rd", "Major3rd", "Fourth", "Fifth", "Minor triad", "Major triad", "Major 7", "Major 9", "Random"}),0));
-        layout.add (std::make_unique <juce::AudioParameterChoice>(juce::ParameterID("arpOctave", 1), "Arp:LoopMode", juce::StringArray({ "1 Repeat", "1 Octave", "2 Octaves"}),0));
-        layout.add (std::make_unique <juce::AudioParameterFloat> (juce::ParameterID("arpSpeed", 1), "Arp:Speed", 0.0, 1.0, 0.5));
-        
-        // ADSR
-        layout.add (std::make_unique <juce::AudioParameterFloat> (juce::ParameterID("attack", 1), "Envelope: Attack", 0.01, 5.0, 0.01));
-        layout.add (std::make_unique <juce::AudioParameterFloat> (juce::ParameterID("decay", 1), "Envelope: Decay", 0.0, 5.0, 0.0));
-        layout.add (std::make_unique <juce::AudioParameterFloat> (juce::ParameterID("sustain", 1), "Envelope: Sustain", 0.0, 1.0, 1.0));
-        layout.add (std::make_unique <juce::AudioParameterFloat> (juce::ParameterID("release", 1), "Envelope: Release", 0.01, 5.0, 0.01));
-        
-        // Bitcrusher
-        layout.add (std::make_unique <juce::AudioParameterInt> (juce::ParameterID("rateReduction", 1), "Bitcrusher: Rate Reduction", 1, 10, 1));
-        layout.add (std::make_unique <juce::AudioParameterInt> (juce::ParameterID("bitDepth", 1), "Bitcrusher: Bit Depth", 1, 24, 24));
-        
-        // Delay
-        layout.add (std::make_unique <juce::AudioParameterFloat> (juce::ParameterID("delayTime", 1), "Delay: Delay Time", 0.0, 1.0, 0.0));
-        layout.add (std::make_unique <juce::AudioParameterFloat> (juce::ParameterID("feedback", 1), "Delay: Feedback", 0.0, 0.99, 0.0));
-        layout.add (std::make_unique <juce::AudioParameterFloat> (juce::ParameterID("dryWetMix", 1), "Delay: Dry/Wet Mix", 0.0, 1.0, 0.2));
-        
-        return layout;
-    }
-    //==============================================================================
-
-    juce::SmoothedValue<float> smoothVal; // Smoothed value to manage parameter transitions smoothly.
-    std::vector<Delay> delays;
-    std::vector<Bitcrusher> bitcrushers;
-    
-    juce::Synthesiser synth; // Synthesizer instance to manage multiple synthesis voices.
-    int voiceCount = 10; // Number of voices the synthesizer can use.
-    
-    //==============================================================================
-    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AP_assessment3AudioProcessor)
-};
+/*
+  ==============================================================================
+
+    This file contains the basic framework code for a JUCE plugin processor.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "Core/ChiptuneEngine.h"
+#include "Core/QualityGovernor.h"
+#include "Core/AnalysisFeed.h"
+#include "Core/ProgramBank.h"
+#include "DiskRecorder.h"
+#include "SessionRecorder.h"
+#include <array>
+
+//==============================================================================
+/**
+*/
+class AP_assessment3AudioProcessor  : public juce::AudioProcessor,
+                                      private juce::Timer,
+                                      private juce::AsyncUpdater
+{
+public:
+    //==============================================================================
+    AP_assessment3AudioProcessor();
+    ~AP_assessment3AudioProcessor() override;
+
+    //==============================================================================
+    void prepareToPlay (double sampleRate, int samplesPerBlock) override;
+    void releaseResources() override;
+
+   #ifndef JucePlugin_PreferredChannelConfigurations
+    bool isBusesLayoutSupported (const BusesLayout& layouts) const override;
+   #endif
+
+    void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+
+    //==============================================================================
+    juce::AudioProcessorEditor* createEditor() override;
+    bool hasEditor() const override;
+
+    //==============================================================================
+    const juce::String getName() const override;
+
+    bool acceptsMidi() const override;
+    bool producesMidi() const override;
+    bool isMidiEffect() const override;
+    double getTailLengthSeconds() const override;
+
+    //==============================================================================
+    int getNumPrograms() override;
+    int getCurrentProgram() override;
+    void setCurrentProgram (int index) override;
+    const juce::String getProgramName (int index) override;
+    void changeProgramName (int index, const juce::String& newName) override;
+
+    //==============================================================================
+    void getStateInformation (juce::MemoryBlock& destData) override;
+    void setStateInformation (const void* data, int sizeInBytes) override;
+
+    //==============================================================================
+    /** Maps a range of MIDI notes to a preset, so one instance can play a whole drum kit.
+        @param lowNote      lowest MIDI note of the zone (inclusive)
+        @param highNote     highest MIDI note of the zone (inclusive)
+        @param presetState  parameter tree of the preset, in the format written by getStateInformation
+        @param name         display name of the zone
+    */
+    void addKeyZone (int lowNote, int highNote, const juce::ValueTree& presetState, const juce::String& name = {});
+    
+    /// Same as above, taking a binary preset blob as produced by getStateInformation.
+    void addKeyZone (int lowNote, int highNote, const void* presetData, int sizeInBytes, const juce::String& name = {});
+    
+    /// Removes all key zones, so every note plays the live parameters again.
+    void clearKeyZones();
+    
+    /// Returns the current key zones. Read-only, use the methods above to edit them.
+    const KeyZoneMap& getKeyZones() { return engine.getKeyZones(); }
+    
+    //==============================================================================
+    /** Adds a user program after the factory programs. The preset is decoded here, once, so that
+        switching to it from a MIDI program change costs nothing on the audio thread.
+        @param name         display name of the program
+        @param presetState  parameter tree of the preset, in the format written by getStateInformation
+    */
+    void addProgram (const juce::String& name, const juce::ValueTree& presetState);
+    
+    /// Same as above, taking a binary preset blob as produced by getStateInformation.
+    void addProgram (const juce::String& name, const void* presetData, int sizeInBytes);
+    
+    /// Removes the user programs, keeping the Init and factory programs.
+    void clearUserPrograms();
+    
+    /// Returns the programs. Read-only, use the methods above to edit them.
+    const ProgramBank& getPrograms() const { return programs; }
+    
+    //==============================================================================
+    /** Sets the seed of this instance. Every voice and random feature derives its own stream from it,
+        so offline renders of the same session are bit-identical. The seed is saved with the state.
+    */
+    void setRandomSeed (juce::int64 newSeed);
+    
+    /// Returns the seed of this instance.
+    juce::int64 getRandomSeed() { return static_cast<juce::int64> (engine.getRandomSeed()); }
+    
+    //==============================================================================
+    /** Starts capturing the plugin output to a file, WAV or FLAC depending on its extension.
+        The file is written from a background thread, see DiskRecorder. Returns false if it cannot be created.
+    */
+    bool startRecording (const juce::File& file);
+    
+    /// Stops the recording and closes the file.
+    void stopRecording() { recorder.stop(); }
+    
+    /// Returns the recorder, for its state and overrun counters.
+    const DiskRecorder& getRecorder() const { return recorder; }
+    
+    //==============================================================================
+    /** Starts logging every block, with its MIDI, parameter changes and playhead, so the session can be
+        replayed offline and profiled with Tools/ChiptuneReplay.cpp. The log starts with the engine as it
+        is playing, sounding notes and delay tails included, so the replay starts from the same state and
+        the capture does not interrupt playback. Returns false if the plugin is not prepared or the file
+        cannot be created.
+    */
+    bool startSessionCapture (const juce::File& file);
+    
+    /** Keeps the last seconds of the session in memory, and writes them to a new log in directory
+        whenever a block misses its deadline, see SessionRecorder.
+    */
+    bool startFlightRecorder (const juce::File& directory, double seconds = 30.0);
+    
+    /// Stops the session capture or the flight recorder.
+    void stopSessionCapture() { sessionRecorder.stop(); }
+    
+    /// Returns the session recorder, for its state and counters.
+    const SessionRecorder& getSessionRecorder() const { return sessionRecorder; }
+    
+    /// Returns the governor that lowers the render quality when blocks come close to their deadline.
+    const QualityGovernor& getQualityGovernor() const { return governor; }
+    
+    /// Returns the feed of output frames for the visualisations, see SignalAnalyser.
+    AnalysisFeed& getAnalysisFeed() { return analysisFeed; }
+
+private:
+    
+    //==============================================================================
+    // Audio processor value tree state to manage and automate plugin parameters.
+    juce::AudioProcessorValueTreeState apvts;
+    
+    juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout()
+    {
+        juce::AudioProcessorValueTreeState::ParameterLayout layout;
+        
+        // Osc type
+        layout.add (std::make_unique <juce::AudioParameterChoice>(juce::ParameterID("oscType", 1), "Osc Type", juce::StringArray({ "Pulse", "Triangle", "Noise"}),0));
+        
+        // Pulse Width Modulation
+        layout.add (std::make_unique <juce::AudioParameterChoice>(juce::ParameterID("pulseWidth", 1), "Pulse Width", juce::StringArray({ "12.5%", "25%", "50%"}),0));
+        layout.add (std::make_unique<juce::AudioParameterBool>(juce::ParameterID{"pwmSwitch", 1},
+            "PW Mod: On/Off", false));
+        layout.add (std::make_unique <juce::AudioParameterFloat> (juce::ParameterID("pwmSustain", 1), "PW Mod: Sustain", 0.0, 1.0, 0.0));
+        layout.add (std::make_unique <juce::AudioParameterChoice>(juce::ParameterID("pwmMode", 1), "PW Mod: Mode", juce::StringArray({ "12.5%to25%", "12.5%to50%", "25%to50%", "25%to12.5%", "50%to25%", "50%to12.5%"}),0));
+        layout.add (std::make_unique <juce::AudioParameterFloat> (juce::ParameterID("pwmRate", 1), "PW Mod: Rate", 0.0, 1.0, 0.5));
+        layout.add (std::make_unique <juce::AudioParameterChoice>(juce::ParameterID("pwmShape", 1), "PW Mod: Shape", juce::StringArray({ "Stepped", "Continuous"}),0));
+        
+        // triDistortion
+        layout.add (std::make_unique<juce::AudioParameterBool>(juce::ParameterID{"triDistortion", 1},
+            "Tri Distortion",true));
+        
+        // noiseDistortion
+        layout.add (std::make_unique<juce::AudioParameterBool>(juce::ParameterID{"noiseDistortion", 1},
+            "Noisy Noise",true));
+        
+        // Unison
+        layout.add (std::make_unique <juce::AudioParameterInt> (juce::ParameterID("unison", 1), "Unison: Voices", 1, 8, 1));
+        layout.add (std::make_unique <juce::AudioParameterFloat> (juce::ParameterID("unisonDetune", 1), "Unison: Detune", 0.0, 50.0, 15.0));
+        layout.add (std::make_unique <juce::AudioParameterFloat> (juce::ParameterID("unisonSpread", 1), "Unison: Spread", 0.0, 1.0, 0.5));
+        
+        // Pitch Bend
+        layout.add (std::make_unique<juce::AudioParameterBool>(juce::ParameterID{"pbSwitch", 1},
+            "Bend: On/Off", false));
+        layout.add (std::make_unique <juce::AudioParameterInt> (juce::ParameterID("pbInitPitch", 1), "Bend: Init.Pitch", -24, 24, 0));
+        layout.add (std::make_unique <juce::AudioParameterFloat> (juce::ParameterID("pbTime", 1), "Bend: Time", 0.01, 3.0, 0.0));
+        layout.add (std::make_unique <juce::AudioParameterInt> (juce::ParameterID("pbEndPitch", 1), "Bend: End Pitch", -24, 24, 0));
+        layout.add (std::make_unique <juce::AudioParameterFloat> (juce::ParameterID("pbEndTime", 1), "Bend: End Time", 0.0, 3.0, 0.1));
+        
+        // Vibrato
+        layout.add (std::make_unique<juce::AudioParameterBool>(juce::ParameterID{"vibSwitch", 1},
+            "Vibrato: On/Off", false));
+        layout.add (std::make_unique <juce::AudioParameterFloat> (juce::ParameterID("vibSpeed", 1), "Vibrato: Speed", 0.0, 1.0, 0.1));
+        layout.add (std::make_unique <juce::AudioParameterFloat> (juce::ParameterID("vibAmount", 1), "Vibrato: Amount", 0.0, 1.0, 0.1));
+        layout.add (std::make_unique <juce::AudioParameterFloat> (juce::ParameterID("vibSustain", 1), "Vibrato: Sustain", 0.0, 1.0, 0.0));
+        
+        // Arpeggiator
+        layout.add (std::make_unique<juce::AudioParameterBool>(juce::ParameterID{"arpSwitch", 1},
+            "Arp: On/Off", false));
+        layout.add (std::make_unique <juce::AudioParameterChoice>(juce::ParameterID("arpPattern", 1), "Arp:Pattern", juce::StringArray({ "Minor3rd", "Major3rd", "Fourth", "Fifth", "Minor triad", "Major triad", "Major 7", "Major 9", "Random"}),0));
+        layout.add (std::make_unique <juce::AudioParameterChoice>(juce::ParameterID("arpOctave", 1), "Arp:LoopMode", juce::StringArray({ "1 Repeat", "1 Octave", "2 Octaves"}),0));
+        layout.add (std::make_unique <juce::AudioParameterFloat> (juce::ParameterID("arpSpeed", 1), "Arp:Speed", 0.0, 1.0, 0.5));
+        
+        // ADSR
+        layout.add (std::make_unique <juce::AudioParameterFloat> (juce::ParameterID("attack", 1), "Envelope: Attack", 0.01, 5.0, 0.01));
+        layout.add (std::make_unique <juce::AudioParameterFloat> (juce::ParameterID("decay", 1), "Envelope: Decay", 0.0, 5.0, 0.0));
+        layout.add (std::make_unique <juce::AudioParameterFloat> (juce::ParameterID("sustain", 1), "Envelope: Sustain", 0.0, 1.0, 1.0));
+        layout.add (std::make_unique <juce::AudioParameterFloat> (juce::ParameterID("release", 1), "Envelope: Release", 0.01, 5.0, 0.01));
+        layout.add (std::make_unique <juce::AudioParameterChoice>(juce::ParameterID("envCurve", 1), "Envelope: Curve", juce::StringArray({ "Linear", "Exponential", "NES Steps"}),0));
+        
+        // Mixer, see Core/NesMixer.h
+        layout.add (std::make_unique <juce::AudioParameterChoice>(juce::ParameterID("mixer", 1), "Mixer", juce::StringArray({ "Linear", "NES"}),0));
+        
+        // Bitcrusher
+        layout.add (std::make_unique <juce::AudioParameterInt> (juce::ParameterID("rateReduction", 1), "Bitcrusher: Rate Reduction", 1, 10, 1));
+        layout.add (std::make_unique <juce::AudioParameterInt> (juce::ParameterID("bitDepth", 1), "Bitcrusher: Bit Depth", 1, 24, 24));
+        
+        // Render quality of this instance, see Core/RenderQuality.h
+        layout.add (std::make_unique <juce::AudioParameterChoice>(juce::ParameterID("quality", 1), "Quality", juce::StringArray({ "Eco", "Standard", "High"}), RenderQuality::standard));
+        
+        // Delay
+        layout.add (std::make_unique <juce::AudioParameterFloat> (juce::ParameterID("delayTime", 1), "Delay: Delay Time", 0.0, 1.0, 0.0));
+        layout.add (std::make_unique <juce::AudioParameterFloat> (juce::ParameterID("feedback", 1), "Delay: Feedback", 0.0, 0.99, 0.0));
+        layout.add (std::make_unique <juce::AudioParameterFloat> (juce::ParameterID("dryWetMix", 1), "Delay: Dry/Wet Mix", 0.0, 1.0, 0.2));
+        
+        return layout;
+    }
+    //==============================================================================
+    // The synthesizer itself, see Core/ChiptuneEngine.h. The plugin only feeds it parameters and MIDI.
+    ChiptuneEngine engine;
+    std::array<std::atomic<float>*, ChiptuneParameters::numParameters> liveParameterValues;
+    
+    /// Copies the current parameter values into the engine's live parameters.
+    void updateLiveParameters();
+    
+    /// Passes one MIDI message on to the engine.
+    void handleMidiMessage (const juce::MidiMessage& message);
+    
+    /// Renders a stretch of the block to the main bus, and to the aux bus of each oscillator type that has one enabled.
+    void renderSegment (juce::AudioBuffer<float>& buffer, int startSample, int numSamples);
+    
+    // Factory and user programs, see Core/ProgramBank.h. A MIDI program change switches the engine at once,
+    // and the parameters follow on the message thread; until they do, the engine keeps the program.
+    ProgramBank programs;
+    std::atomic<int> currentProgram { 0 };
+    std::atomic<int> programRequests { 0 };        // Program changes made from MIDI
+    std::atomic<int> programRequestsApplied { 0 }; // Of those, the number copied into the parameters
+    
+    /// Switches to a program from a MIDI program change, on the audio thread.
+    void changeProgramFromMidi (int index);
+    
+    /// Sets the plugin parameters to the values of a program, on the message thread.
+    void applyProgramToParameters (int index);
+    
+    /// Copies the program chosen from MIDI into the plugin parameters.
+    void handleAsyncUpdate() override;
+    
+    // Captures the output to disk when recording.
+    DiskRecorder recorder;
+    
+    // Hands the output to the editor's scope and spectrum, one copy per block.
+    AnalysisFeed analysisFeed;
+    
+    // Lowers the render quality under CPU pressure, see Core/QualityGovernor.h.
+    // Only used in real time, offline renders always use the best tier.
+    QualityGovernor governor;
+    int numTransitionsLogged = 0;
+    std::atomic<float>* qualityParameter = nullptr; // Tier chosen for this instance, which the governor can only lower.
+    
+    /// Applies the tier of this instance, lowered to the governor's current tier.
+    void applyRenderQuality();
+    
+    /// Feeds the time the block took to the governor.
+    void updateRenderQuality (double elapsedSeconds, int numSamples);
+    
+    /// Logs the quality transitions of the governor, from the message thread.
+    void timerCallback() override;
+    
+    // Logs the session for an offline replay, see SessionRecorder.
+    SessionRecorder sessionRecorder;
+    
+    /// Starts logging the block if a capture is running, with the playhead, the quality and the bus layout.
+    bool beginSessionBlock (juce::AudioBuffer<float>& buffer);
+    
+    /// Completes the logged block with its timing and a hash of the main output.
+    void endSessionBlock (juce::AudioBuffer<float>& buffer, double elapsedSeconds);
+    
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AP_assessment3AudioProcessor)
+};
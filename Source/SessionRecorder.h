@@ -0,0 +1,521 @@
+/*
+  ==============================================================================
+
+    SessionRecorder.h
+    Created: 26 Oct 2026 4:52:06pm
+    Author:  70
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include <atomic>
+#include <cmath>
+#include <deque>
+#include <vector>
+#include "Core/ChiptuneEngine.h"
+#include "Core/SessionLog.h"
+
+/**
+ * @class SessionRecorder
+ *
+ * @brief Logs everything processBlock() feeds the engine, so a session can be replayed offline (see SessionPlayer).
+ *
+ * The audio thread encodes each block into a fixed buffer and copies the record into a preallocated
+ * byte ring, never blocking, locking or allocating. If the ring is full the block is dropped and counted
+ * as an overrun; the next block is flagged, and carries every parameter again. A writer thread drains
+ * the ring, either:
+ * - to a file (startCapture()), which replays the whole session;
+ * - or into a window of the last few seconds (startFlightRecorder()), written out to a file when a
+ *   block misses its deadline, at most once per window length. Records that leave the window are
+ *   folded into the state at its start, so a dump replays from that state. The voices and effects
+ *   are only logged when the recorder starts, so a dump matches the capture bit for bit while its
+ *   window reaches back to the start, or to a prepare.
+ *
+ * Start and stop run on the message thread. The file, the ring and the writer thread are set up
+ * without the processor's callback lock. It is only held to copy the engine as it is playing, voices
+ * and delay lines included (see ChiptuneEngine::saveState()), into a buffer sized beforehand, and to
+ * switch logging on: the audio thread waits for that copy at most, and no note is cut. The writer
+ * thread writes the copy before the first block. The write...() methods log state changes; they run
+ * with the callback lock held or in prepareToPlay(), so they never write the ring at the same time as
+ * the audio thread. They only copy a record into the ring: small records are encoded into a buffer
+ * reserved by start(), and the key zones, which can be large, are encoded by encodeKeyZones() before
+ * the lock is taken.
+ */
+class SessionRecorder : private juce::Thread
+{
+public:
+    SessionRecorder() : juce::Thread ("Chiptune Session Recorder") {}
+    ~SessionRecorder() override { stop(); }
+
+    //==============================================================================
+    /**
+     * @brief Creates or overwrites the file and starts logging. Stops any previous capture first.
+     *
+     * @param file          destination, conventionally with the .chiptunelog extension
+     * @param engine        the engine, as it is playing
+     * @param sampleRate    sample rate it was prepared at
+     * @param callbackLock  the lock processBlock() renders the engine under
+     * @param bufferBytes   size of the ring, at about 55 bytes per block without events
+     * @return false if the file cannot be written
+     */
+    bool startCapture (const juce::File& file, ChiptuneEngine& engine, double sampleRate, const juce::CriticalSection& callbackLock,
+                       int bufferBytes = 1 << 22)
+    {
+        stop();
+
+        file.deleteFile();
+        stream = file.createOutputStream (1 << 18);
+        if (stream == nullptr)
+            return false;
+
+        std::vector<uint8_t> header;
+        SessionLog::writeHeader (header);
+        stream->write (header.data(), header.size());
+
+        flightWindowSamples = 0;
+        start (engine, sampleRate, callbackLock, bufferBytes);
+        return true;
+    }
+
+    /**
+     * @brief Starts keeping the last seconds of the session, written to a new file in directory on a deadline miss.
+     *
+     * Dumps are named chiptune-flight-<date>-<time>.chiptunelog.
+     */
+    bool startFlightRecorder (const juce::File& directory, double seconds, ChiptuneEngine& engine, double sampleRate,
+                              const juce::CriticalSection& callbackLock, int bufferBytes = 1 << 22)
+    {
+        stop();
+
+        if (! directory.createDirectory())
+            return false;
+
+        flightDirectory = directory;
+        flightWindowSamples = juce::jmax ((juce::int64) 1, static_cast<juce::int64> (seconds * sampleRate));
+        start (engine, sampleRate, callbackLock, bufferBytes);
+        return true;
+    }
+
+    /// Stops logging and closes the file, after writing everything still buffered.
+    void stop()
+    {
+        capturing = false;
+        while (numPushing.load() > 0) // Let a block that saw capturing == true finish
+            juce::Thread::yield();
+
+        if (! isThreadRunning())
+            return;
+
+        stopThread (-1);
+        drain();
+        stream.reset();
+        window.clear();
+
+        if (numOverruns > 0)
+            juce::Logger::writeToLog ("SessionRecorder: " + juce::String (numOverruns.load()) + " overruns");
+    }
+
+    /// Returns true while logging.
+    bool isCapturing() const { return capturing; }
+
+    /// Returns how many records were dropped because the ring was full.
+    juce::int64 getNumOverruns() const { return numOverruns; }
+
+    /// Returns how many blocks reached the file or the window.
+    juce::int64 getNumBlocks() const { return numBlocks; }
+
+    /// Returns how many flight recorder dumps were written.
+    int getNumDumps() const { return numDumps; }
+
+    //==============================================================================
+    /// Logs a prepareToPlay(). Call after preparing the engine.
+    void writePrepare (double sampleRate)
+    {
+        writeState ([&] (std::vector<uint8_t>& out) { SessionLog::writeValueRecord (out, SessionLog::prepareRecord, sampleRate); });
+    }
+
+    /// Logs a new random seed.
+    void writeSeed (uint64_t seed)
+    {
+        writeState ([&] (std::vector<uint8_t>& out) { SessionLog::writeValueRecord (out, SessionLog::seedRecord, seed); });
+    }
+
+    /// Encodes the record of edited key zones for writeKeyZones(). Call it before taking the callback lock,
+    /// as it allocates. Returns an empty record while not logging.
+    std::vector<uint8_t> encodeKeyZones (const KeyZoneMap& keyZones) const
+    {
+        std::vector<uint8_t> record;
+        if (capturing)
+            SessionLog::writeKeyZonesRecord (record, keyZones);
+        return record;
+    }
+
+    /// Logs edited key zones, from the record encodeKeyZones() made of them.
+    void writeKeyZones (const std::vector<uint8_t>& record)
+    {
+        if (! capturing || record.empty())
+            return;
+
+        if (! push (record.data(), record.size()))
+            markGap();
+    }
+
+    //==============================================================================
+    /**
+     * @brief Starts logging a block. Audio thread, wait-free.
+     *
+     * @return true if the block is logged: then call the add...() methods and endBlock()
+     */
+    bool beginBlock (const SessionLog::BlockInfo& info)
+    {
+        ++numPushing;
+        if (! capturing)
+        {
+            --numPushing;
+            return false;
+        }
+
+        blockWriter.begin (info);
+        return true;
+    }
+
+    /// Logs a MIDI message, after it was handled.
+    void addMidi (int position, const uint8_t* data, int numBytes)
+    {
+        blockWriter.addMidi (position, data, numBytes);
+    }
+
+    /// Logs the parameters of the engine that changed since they were last logged.
+    void addParameterChanges (int position, const ChiptuneParameters& parameters)
+    {
+        blockWriter.addParameterChanges (position, parameters, loggedParameters);
+    }
+
+    /// Completes the block, once rendered, and hands it to the writer thread.
+    void endBlock (double elapsedSeconds, bool missedDeadline, uint64_t outputHash)
+    {
+        uint8_t flags = missedDeadline ? SessionLog::missedDeadline : 0;
+        if (gapPending)
+            flags |= SessionLog::afterGap;
+
+        auto elapsed = static_cast<uint32_t> (juce::jlimit (0.0, 4.0e9, elapsedSeconds * 1.0e9));
+        if (blockWriter.finish (elapsed, flags, outputHash) && push (blockWriter.getData(), blockWriter.getSize()))
+            gapPending = false;
+        else
+            markGap();
+
+        --numPushing;
+    }
+
+private:
+    // Ring of encoded records, written by the audio thread (and by the write...() methods), read by the writer thread
+    std::vector<uint8_t> ringBuffer;
+    juce::AbstractFifo fifo { 1 };
+    SessionLog::BlockWriter blockWriter;
+    ChiptuneParameters loggedParameters;         // Parameters as the log has them, for the changes of the next block.
+
+    std::atomic<bool> capturing { false };
+    std::atomic<bool> gapPending { false };      // A record was lost, flag the next block.
+    std::atomic<int> numPushing { 0 };           // Audio threads between beginBlock() and endBlock().
+    std::atomic<juce::int64> numOverruns { 0 };
+    std::atomic<juce::int64> numBlocks { 0 };
+    std::atomic<int> numDumps { 0 };
+
+    std::vector<uint8_t> stateRecord;            // Encoding buffer of writePrepare() and writeSeed(), reserved by start().
+
+    // Writer thread
+    std::vector<uint8_t> startRecords;           // The state the log starts from, written before the ring.
+    std::unique_ptr<juce::FileOutputStream> stream; // The capture file, nullptr for the flight recorder.
+    std::vector<uint8_t> pending;                // Bytes read from the ring, up to the last complete record.
+
+    // Flight recorder, on the writer thread
+    struct WindowRecord
+    {
+        std::vector<uint8_t> bytes;
+        uint32_t numSamples = 0;                 // 0 for a state record.
+    };
+
+    juce::File flightDirectory;
+    juce::int64 flightWindowSamples = 0;         // Length of the window, 0 when capturing to a file.
+    std::deque<WindowRecord> window;
+    juce::int64 windowSamples = 0;
+    juce::int64 samplesSinceDump = 0;
+    bool windowIsExact = true;                   // True while the window starts at the start of the recorder, or a prepare.
+    std::vector<uint8_t> baseSeed, baseKeyZones, baseQuality, basePrepare, baseEngineState; // State at the start of the window, as records.
+    ChiptuneParameters baseParameters;
+    std::vector<int> identityMap;
+
+    //==============================================================================
+    /// Records beside the engine state in startRecords: the seed, parameters, key zones, quality and prepare.
+    static constexpr size_t startRecordsSlack = 1 << 16;
+
+    /// Largest record writeState() encodes: a header and one value.
+    static constexpr size_t stateRecordBytes = 64;
+
+    /// Sets up the ring, copies the state of the engine under the callback lock, and starts the writer thread.
+    void start (ChiptuneEngine& engine, double sampleRate, const juce::CriticalSection& callbackLock, int bufferBytes)
+    {
+        ringBuffer.assign (static_cast<size_t> (bufferBytes), 0);
+        fifo.setTotalSize (bufferBytes);
+        fifo.reset();
+        pending.clear();
+        window.clear();
+        windowSamples = 0;
+        samplesSinceDump = flightWindowSamples;
+        windowIsExact = true;
+        baseSeed.clear();
+        baseKeyZones.clear();
+        baseQuality.clear();
+        basePrepare.clear();
+        baseEngineState.clear();
+        identityMap.resize (ChiptuneParameters::numParameters);
+        for (int i = 0; i < ChiptuneParameters::numParameters; ++i)
+            identityMap[i] = i;
+
+        stateRecord.reserve (stateRecordBytes);
+        numOverruns = 0;
+        numBlocks = 0;
+        numDumps = 0;
+        gapPending = false;
+
+        // The voices and delay lines only change size in prepareToPlay(), so the copy below fits in this
+        // buffer, unless the engine is prepared again in between
+        size_t stateBytes = 0;
+        {
+            const juce::ScopedLock sl (callbackLock);
+            stateBytes = engine.saveState (nullptr);
+        }
+        startRecords.clear();
+        startRecords.reserve (stateBytes + startRecordsSlack);
+
+        // The state the replay sets up, then prepares its engine and restores the voices and effects into it
+        {
+            const juce::ScopedLock sl (callbackLock);
+            loggedParameters = engine.getParameters();
+            SessionLog::writeValueRecord (startRecords, SessionLog::seedRecord, engine.getRandomSeed());
+            SessionLog::writeParametersRecord (startRecords, engine.getParameters());
+            SessionLog::writeKeyZonesRecord (startRecords, engine.getKeyZones());
+            SessionLog::writeQualityRecord (startRecords, engine.getRenderQuality());
+            SessionLog::writeValueRecord (startRecords, SessionLog::prepareRecord, sampleRate);
+            SessionLog::writeEngineStateRecord (startRecords, engine);
+            capturing = true;
+        }
+
+        startThread();
+    }
+
+    /// Encodes a small state record into stateRecord and pushes it, from the message thread. Does not allocate.
+    template <typename Encode>
+    void writeState (Encode encode)
+    {
+        if (! capturing)
+            return;
+
+        stateRecord.clear();
+        encode (stateRecord);
+        if (! push (stateRecord.data(), stateRecord.size()))
+            markGap();
+    }
+
+    /// Copies whole records into the ring. Returns false, copying nothing, if they do not fit.
+    bool push (const uint8_t* data, size_t numBytes)
+    {
+        if (fifo.getFreeSpace() < static_cast<int> (numBytes))
+            return false;
+
+        int start1, size1, start2, size2;
+        fifo.prepareToWrite (static_cast<int> (numBytes), start1, size1, start2, size2);
+        std::memcpy (ringBuffer.data() + start1, data, static_cast<size_t> (size1));
+        if (size2 > 0)
+            std::memcpy (ringBuffer.data() + start2, data + size1, static_cast<size_t> (size2));
+        fifo.finishedWrite (size1 + size2);
+        return true;
+    }
+
+    /// Counts a lost record. The next block is flagged and logs every parameter again.
+    void markGap()
+    {
+        ++numOverruns;
+        gapPending = true;
+        for (int i = 0; i < ChiptuneParameters::numParameters; ++i)
+            loggedParameters.set (static_cast<ChiptuneParameters::Index> (i), std::nanf (""));  // Differs from any value
+    }
+
+    //==============================================================================
+    void run() override
+    {
+        // The start state goes before the blocks the audio thread pushed while the thread was starting
+        consume (startRecords.data(), startRecords.size());
+        startRecords.clear();
+        startRecords.shrink_to_fit();
+
+        while (! threadShouldExit())
+            if (! drain())
+                wait (20);
+    }
+
+    /// Takes what is in the ring and writes or keeps its complete records. Returns true if there was anything.
+    bool drain()
+    {
+        int numReady = fifo.getNumReady();
+        if (numReady == 0)
+            return false;
+
+        int start1, size1, start2, size2;
+        fifo.prepareToRead (numReady, start1, size1, start2, size2);
+        pending.insert (pending.end(), ringBuffer.data() + start1, ringBuffer.data() + start1 + size1);
+        pending.insert (pending.end(), ringBuffer.data() + start2, ringBuffer.data() + start2 + size2);
+        fifo.finishedRead (size1 + size2);
+
+        size_t position = consume (pending.data(), pending.size());
+        pending.erase (pending.begin(), pending.begin() + static_cast<std::ptrdiff_t> (position));
+        return true;
+    }
+
+    /// Writes or keeps the complete records at the start of data. Returns how many bytes they take.
+    size_t consume (const uint8_t* data, size_t size)
+    {
+        size_t position = 0;
+        SessionLog::Record record;
+        while (size_t recordSize = SessionLog::readRecord (data + position, size - position, record))
+        {
+            if (stream != nullptr)
+                stream->write (data + position, recordSize);
+            else
+                addToWindow (data + position, recordSize, record);
+
+            if (record.type == SessionLog::blockRecord)
+                ++numBlocks;
+            position += recordSize;
+        }
+        return position;
+    }
+
+    /// Adds a record to the flight recorder window, and dumps the window if the record missed its deadline.
+    void addToWindow (const uint8_t* data, size_t numBytes, const SessionLog::Record& record)
+    {
+        // The engine starts over at a prepare: the window can start there, exactly
+        if (record.type == SessionLog::prepareRecord)
+        {
+            while (! window.empty())
+                evictFirstRecord();
+            basePrepare.assign (data, data + numBytes);
+            baseEngineState.clear();
+            windowIsExact = true;
+            return;
+        }
+
+        // Follows the prepare record when the recorder starts, with the window still empty
+        if (record.type == SessionLog::engineStateRecord)
+        {
+            baseEngineState.assign (data, data + numBytes);
+            return;
+        }
+
+        WindowRecord windowRecord;
+        windowRecord.bytes.assign (data, data + numBytes);
+        SessionLog::BlockInfo info;
+        bool isBlock = record.type == SessionLog::blockRecord && SessionLog::readBlockInfo (record, info);
+        if (isBlock)
+            windowRecord.numSamples = info.numSamples;
+        window.push_back (std::move (windowRecord));
+
+        windowSamples += window.back().numSamples;
+        samplesSinceDump += window.back().numSamples;
+        while (! window.empty() && windowSamples - window.front().numSamples >= flightWindowSamples)
+            evictFirstRecord();
+
+        if (isBlock && (info.flags & SessionLog::missedDeadline) != 0 && samplesSinceDump >= flightWindowSamples)
+        {
+            dumpWindow();
+            samplesSinceDump = 0;
+        }
+    }
+
+    /// Folds the oldest record of the window into the state at its start.
+    void evictFirstRecord()
+    {
+        auto& bytes = window.front().bytes;
+        SessionLog::Record record;
+        SessionLog::readRecord (bytes.data(), bytes.size(), record);
+
+        switch (record.type)
+        {
+            case SessionLog::seedRecord:       baseSeed = bytes; break;
+            case SessionLog::keyZonesRecord:   baseKeyZones = bytes; break;
+            case SessionLog::qualityRecord:    baseQuality = bytes; break;
+            case SessionLog::parametersRecord: SessionLog::readParametersRecord (record, identityMap, baseParameters); break;
+
+            case SessionLog::blockRecord:
+            {
+                SessionLog::BlockInfo info;
+                if (SessionLog::readBlockInfo (record, info))
+                {
+                    baseQuality.clear();
+                    SessionLog::writeQualityRecord (baseQuality, info.quality);
+                }
+
+                SessionLog::EventReader events (record);
+                SessionLog::Event event;
+                while (events.next (event))
+                    if (event.type == SessionLog::parameterEvent && event.parameterIndex < ChiptuneParameters::numParameters)
+                        baseParameters.set (static_cast<ChiptuneParameters::Index> (event.parameterIndex), event.value);
+
+                // The voices at the start of the window are no longer known
+                windowIsExact = false;
+                baseEngineState.clear();
+                break;
+            }
+
+            default:
+                break;
+        }
+
+        windowSamples -= window.front().numSamples;
+        window.pop_front();
+    }
+
+    /// Writes the state at the start of the window, then the window, to a new file.
+    void dumpWindow()
+    {
+        auto file = flightDirectory.getChildFile ("chiptune-flight-" + juce::Time::getCurrentTime().formatted ("%Y%m%d-%H%M%S") + ".chiptunelog");
+        file.deleteFile();
+        auto output = file.createOutputStream();
+        if (output == nullptr)
+            return;
+
+        std::vector<uint8_t> state;
+        SessionLog::writeHeader (state);
+        state.insert (state.end(), baseSeed.begin(), baseSeed.end());
+        SessionLog::writeParametersRecord (state, baseParameters);
+        state.insert (state.end(), baseKeyZones.begin(), baseKeyZones.end());
+        state.insert (state.end(), baseQuality.begin(), baseQuality.end());
+        state.insert (state.end(), basePrepare.begin(), basePrepare.end());
+        state.insert (state.end(), baseEngineState.begin(), baseEngineState.end());
+        output->write (state.data(), state.size());
+
+        bool flagged = windowIsExact;
+        for (const auto& record : window)
+        {
+            // Unless the window starts at a prepare, its first block does not follow on from the state above
+            if (! flagged && record.numSamples > 0)
+            {
+                auto firstBlock = record.bytes;
+                SessionLog::addBlockFlags (firstBlock.data(), SessionLog::afterGap);
+                output->write (firstBlock.data(), firstBlock.size());
+                flagged = true;
+                continue;
+            }
+            output->write (record.bytes.data(), record.bytes.size());
+        }
+        output->flush();
+
+        ++numDumps;
+        juce::Logger::writeToLog ("SessionRecorder: deadline miss, wrote the last "
+                                  + juce::String (windowSamples) + " samples to " + file.getFullPathName());
+    }
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SessionRecorder)
+};
@@ -0,0 +1,127 @@
+/*
+  ==============================================================================
+
+    SignalAnalyser.h
+    Created: 23 Oct 2026 10:36:45am
+    Author:  70
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+#include "Core/AnalysisFeed.h"
+
+/**
+ * @class SignalAnalyser
+ *
+ * @brief Turns the frames of an AnalysisFeed into a scope trace, a spectrum and voice levels, on its
+ *        own thread.
+ *
+ * The thread wakes up at most maxFramesPerSecond times per second, and only analyses a frame when the
+ * audio thread has published a new one. The results are copied out under a lock that only this thread
+ * and the message thread take; the audio thread is never involved.
+ */
+class SignalAnalyser : private juce::Thread
+{
+public:
+    static constexpr int fftOrder = 11;
+    static constexpr int fftSize = 1 << fftOrder;
+    static constexpr int scopeSize = 512;
+    static_assert (fftSize == AnalysisFrame::size, "The spectrum analyses a whole frame");
+
+    /// What the editor draws.
+    struct Snapshot
+    {
+        std::array<float, scopeSize> scope {};        // Samples from a rising zero crossing, so periodic sounds stand still
+        std::array<float, fftSize / 2> spectrumDb {}; // Magnitude of each FFT bin in dB, floored at -100
+        std::array<float, AnalysisFrame::maxVoices> voiceLevels {};
+        std::array<int, AnalysisFrame::maxVoices> voiceNotes {};
+        int numVoices = 0;
+        double sampleRate = 44100.0;
+        juce::uint64 frameIndex = 0;
+        bool valid = false;                           // False until the first frame has been analysed
+    };
+
+    SignalAnalyser (AnalysisFeed& feedToRead, double maxFramesPerSecond = 30.0)
+        : juce::Thread ("Chiptune Signal Analyser"),
+          feed (feedToRead),
+          frameIntervalMs (1000.0 / maxFramesPerSecond)
+    {
+        startThread();
+    }
+
+    ~SignalAnalyser() override { stopThread (1000); }
+
+    /// Message thread: copies the latest results if they are newer than the snapshot. Returns true if so.
+    bool getLatest (Snapshot& snapshot)
+    {
+        const juce::ScopedLock lock (resultLock);
+        if (! results.valid || (snapshot.valid && snapshot.frameIndex == results.frameIndex))
+            return false;
+
+        snapshot = results;
+        return true;
+    }
+
+private:
+    AnalysisFeed& feed;
+    double frameIntervalMs;
+
+    juce::dsp::FFT fft { fftOrder };
+    juce::dsp::WindowingFunction<float> window { (size_t) fftSize, juce::dsp::WindowingFunction<float>::hann };
+    std::array<float, 2 * fftSize> fftData {};
+    Snapshot working;                // Filled by this thread
+    Snapshot results;                // Last complete analysis, guarded by resultLock
+    juce::CriticalSection resultLock;
+
+    void run() override
+    {
+        while (! threadShouldExit())
+        {
+            double startMs = juce::Time::getMillisecondCounterHiRes();
+            if (feed.update())
+            {
+                analyse (feed.getFrame());
+                const juce::ScopedLock lock (resultLock);
+                results = working;
+            }
+
+            double elapsedMs = juce::Time::getMillisecondCounterHiRes() - startMs;
+            wait (juce::jmax (1, (int) (frameIntervalMs - elapsedMs)));
+        }
+    }
+
+    void analyse (const AnalysisFrame& frame)
+    {
+        // Scope: start on the first rising zero crossing that leaves room for a whole trace
+        int trigger = 0;
+        for (int i = 1; i <= AnalysisFrame::size - scopeSize; ++i)
+        {
+            if (frame.samples[i - 1] < 0.0f && frame.samples[i] >= 0.0f)
+            {
+                trigger = i;
+                break;
+            }
+        }
+        std::copy (frame.samples + trigger, frame.samples + trigger + scopeSize, working.scope.begin());
+
+        // Spectrum: Hann window, magnitudes scaled so a full-scale sine reads about 0 dB
+        std::copy (frame.samples, frame.samples + fftSize, fftData.begin());
+        std::fill (fftData.begin() + fftSize, fftData.end(), 0.0f);
+        window.multiplyWithWindowingTable (fftData.data(), (size_t) fftSize);
+        fft.performFrequencyOnlyForwardTransform (fftData.data());
+        for (int bin = 0; bin < fftSize / 2; ++bin)
+            working.spectrumDb[(size_t) bin] = juce::Decibels::gainToDecibels (fftData[(size_t) bin] * 4.0f / fftSize, -100.0f);
+
+        working.numVoices = frame.numVoices;
+        std::copy (frame.voiceLevels, frame.voiceLevels + frame.numVoices, working.voiceLevels.begin());
+        std::copy (frame.voiceNotes, frame.voiceNotes + frame.numVoices, working.voiceNotes.begin());
+        working.sampleRate = frame.sampleRate;
+        working.frameIndex = frame.frameIndex;
+        working.valid = true;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SignalAnalyser)
+};
@@ -0,0 +1,274 @@
+/*
+  ==============================================================================
+
+    FixedPointTest.cpp
+    Created: 17 Oct 2026 9:41:53am
+    Author:  70
+
+  ==============================================================================
+*/
+
+// Compares the fixed-point render path (FixedPoint.h, FixedPointOscillator.h, FixedPointDsp.h) with
+// the float classes it replaces, block by block, and fails if they drift further apart than the 4-bit
+// chip sound can hide. Runs on any host:
+//
+//   chiptune_fixed_point_test
+//
+// Every check prints its RMS and peak difference on the float scale. The oscillators are compared over
+// a short window, because the float phasor accumulates rounding that the integer one does not, which
+// moves the edges by a sample after a few thousand cycles; that is a difference of the float path.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+#include "Bitcrusher.h"
+#include "Delay.h"
+#include "Envelope.h"
+#include "FixedPoint.h"
+#include "FixedPointDsp.h"
+#include "FixedPointOscillator.h"
+#include "Noise.h"
+#include "PolyBLEPOscillator.h"
+
+namespace
+{
+    const float sampleRate = 44100.0f;
+    const int numSamples = 4096;
+    int numFailures = 0;
+
+    /// Prints the difference between two renderings and counts a failure if it is over the tolerance.
+    void compare(const char* name, const std::vector<float>& floatOutput, const std::vector<float>& fixedOutput,
+                 double maxRms, double maxPeak)
+    {
+        double sumSquares = 0.0, peak = 0.0;
+        for (size_t i = 0; i < floatOutput.size(); ++i)
+        {
+            double difference = std::abs(static_cast<double>(floatOutput[i]) - fixedOutput[i]);
+            sumSquares += difference * difference;
+            peak = std::max(peak, difference);
+        }
+        double rms = std::sqrt(sumSquares / static_cast<double>(floatOutput.size()));
+
+        bool passed = rms <= maxRms && peak <= maxPeak;
+        std::printf("%-34s rms %.6f (max %.6f)  peak %.6f (max %.6f)  %s\n", name, rms, maxRms, peak, maxPeak,
+                    passed ? "ok" : "FAILED");
+        if (! passed)
+            ++numFailures;
+    }
+
+    void testSquare(float frequency, float pulseWidth)
+    {
+        SquareOsc reference;
+        FixedSquareOsc fixed;
+        reference.setSampleRate(sampleRate);
+        fixed.setSampleRate(sampleRate);
+        reference.setFrequency(frequency);
+        fixed.setFrequency(frequency);
+        reference.setPulseWidth(pulseWidth);
+        fixed.setPulseWidth(pulseWidth);
+
+        std::vector<float> a(numSamples), b(numSamples);
+        for (int i = 0; i < numSamples; ++i)
+        {
+            a[i] = reference.process();
+            b[i] = FixedPoint::q15ToFloat(fixed.process());
+        }
+
+        char name[64];
+        std::snprintf(name, sizeof(name), "pulse %.0f Hz, width %.3f", frequency, pulseWidth);
+        compare(name, a, b, 0.002, 0.02);
+    }
+
+    void testTriangle(float frequency)
+    {
+        TriOsc reference;
+        FixedTriOsc fixed;
+        reference.setSampleRate(sampleRate);
+        fixed.setSampleRate(sampleRate);
+        reference.setFrequency(frequency);
+        fixed.setFrequency(frequency);
+
+        std::vector<float> a(numSamples), b(numSamples);
+        for (int i = 0; i < numSamples; ++i)
+        {
+            a[i] = reference.process();
+            b[i] = FixedPoint::q15ToFloat(fixed.process());
+        }
+
+        char name[64];
+        std::snprintf(name, sizeof(name), "triangle %.0f Hz", frequency);
+        compare(name, a, b, 0.002, 0.01);
+    }
+
+    void testNoise(float frequency)
+    {
+        Noise reference;
+        FixedNoise fixed;
+        reference.setSeed(1234);
+        fixed.setSeed(1234);
+        reference.setSampleRate(sampleRate);
+        fixed.setSampleRate(sampleRate);
+        reference.setFrequency(frequency);
+        fixed.setFrequency(frequency);
+
+        std::vector<float> a(numSamples), b(numSamples);
+        for (int i = 0; i < numSamples; ++i)
+        {
+            a[i] = reference.process();
+            b[i] = FixedPoint::q15ToFloat(fixed.process());
+        }
+
+        // The table index of the float path is a double, that of the fixed path 16.16, so they step to
+        // the next entry a sample apart once in a while; count those samples rather than their size
+        int numDifferent = 0;
+        for (int i = 0; i < numSamples; ++i)
+            numDifferent += a[i] != b[i] ? 1 : 0;
+
+        double fraction = static_cast<double>(numDifferent) / numSamples;
+        bool passed = fraction <= 0.02;
+        std::printf("noise %-28.0f %.2f%% of the samples differ (max 2%%)  %s\n", frequency, fraction * 100.0, passed ? "ok" : "FAILED");
+        if (! passed)
+            ++numFailures;
+    }
+
+    void testEnvelope(float attack, float decay, float sustain, float release)
+    {
+        Envelope reference;
+        FixedEnvelope fixed;
+        reference.setSampleRate(sampleRate);
+        fixed.setSampleRate(sampleRate);
+        reference.setParameters({ attack, decay, sustain, release });
+        fixed.setParameters({ attack, decay, sustain, release });
+
+        // Held for half of the render, then released
+        int length = static_cast<int>((attack + decay + release) * sampleRate) * 2 + 64;
+        std::vector<float> a(static_cast<size_t>(length)), b(static_cast<size_t>(length));
+        reference.noteOn();
+        fixed.noteOn();
+        for (int i = 0; i < length; ++i)
+        {
+            if (i == length / 2)
+            {
+                reference.noteOff();
+                fixed.noteOff();
+            }
+            a[i] = reference.getNextSample();
+            b[i] = static_cast<float>(fixed.getNextSample()) / 2147483648.0f;
+        }
+
+        char name[64];
+        std::snprintf(name, sizeof(name), "envelope %.3f/%.3f/%.2f/%.3f", attack, decay, sustain, release);
+        compare(name, a, b, 0.001, 0.005);
+    }
+
+    void testBitcrusher(int bitDepth, int reduction)
+    {
+        Bitcrusher reference;
+        FixedBitcrusher fixed;
+        reference.setBitDepth(bitDepth);
+        fixed.setBitDepth(bitDepth);
+        reference.setSampleRateReduction(reduction);
+        fixed.setSampleRateReduction(reduction);
+
+        std::vector<float> a(numSamples), b(numSamples);
+        for (int i = 0; i < numSamples; ++i)
+        {
+            float input = 0.45f * std::sin(static_cast<float>(i) * 0.01f);
+            a[i] = reference.process(input);
+            b[i] = FixedPoint::q15ToFloat(fixed.process(FixedPoint::floatToQ15(input)));
+        }
+
+        // A sample right on a quantization threshold may round either way, which is one level
+        char name[64];
+        std::snprintf(name, sizeof(name), "bitcrusher %d bits, /%d", bitDepth, reduction);
+        double level = bitDepth < 15 ? 0.5 / ((1 << bitDepth) - 1) : 1.0 / 32768.0;
+        compare(name, a, b, level * 0.1 + 1.0e-4, level + 1.0e-4);
+    }
+
+    void testDelay(float delaySamples, float feedback)
+    {
+        int size = static_cast<int>(sampleRate) * 3;
+        Delay reference;
+        FixedDelay fixed;
+        reference.setSize(size);
+        fixed.setSize(size);
+        reference.setFeedback(feedback);
+        fixed.setFeedback(feedback);
+        reference.setDryWetMix(0.5f);
+        fixed.setDryWetMix(0.5f);
+        reference.setDelayTime(delaySamples);
+        fixed.setDelayTime(delaySamples);
+
+        // Short bursts, so the echoes and their feedback are all in the render
+        int length = static_cast<int>(delaySamples) * 4 + numSamples;
+        std::vector<float> a(static_cast<size_t>(length)), b(static_cast<size_t>(length));
+        for (int i = 0; i < length; ++i)
+        {
+            float input = i < numSamples ? 0.4f * std::sin(static_cast<float>(i) * 0.05f) : 0.0f;
+            a[i] = reference.process(input);
+            b[i] = FixedPoint::q15ToFloat(fixed.process(FixedPoint::floatToQ15(input)));
+        }
+
+        char name[64];
+        std::snprintf(name, sizeof(name), "delay %.2f samples, feedback %.2f", delaySamples, feedback);
+        compare(name, a, b, 0.0005, 0.002);
+    }
+
+    void testMixer()
+    {
+        // Channel gains of the float voice: pulse / 2, triangle * 1.2, noise / 2, then the voice gain of 0.5
+        const float channelGains[] = { 0.5f, 1.2f, 0.5f };
+        FixedMixer fixed;
+
+        for (int channel = 0; channel < 3; ++channel)
+        {
+            std::vector<float> a(numSamples), b(numSamples);
+            for (int i = 0; i < numSamples; ++i)
+            {
+                float sample = 0.9f * std::sin(static_cast<float>(i) * 0.02f);
+                float envelope = static_cast<float>(i) / numSamples;
+                a[i] = sample * channelGains[channel] * 0.5f * envelope;
+                b[i] = FixedPoint::q15ToFloat(fixed.process(channel, FixedPoint::floatToQ15(sample), FixedPoint::floatToQ31(envelope)));
+            }
+
+            char name[64];
+            std::snprintf(name, sizeof(name), "mixer channel %d", channel);
+            compare(name, a, b, 0.0002, 0.001);
+        }
+    }
+}
+
+int main()
+{
+    for (float frequency : { 110.0f, 440.0f, 1760.0f, 7040.0f })
+        for (float pulseWidth : { 0.125f, 0.25f, 0.5f })
+            testSquare(frequency, pulseWidth);
+
+    for (float frequency : { 55.0f, 440.0f, 3520.0f })
+        testTriangle(frequency);
+
+    for (float frequency : { 110.0f, 880.0f })
+        testNoise(frequency);
+
+    testEnvelope(0.01f, 0.1f, 0.6f, 0.2f);
+    testEnvelope(0.0f, 0.05f, 0.3f, 0.01f);
+    testEnvelope(0.2f, 0.0f, 1.0f, 0.5f);
+
+    for (int bitDepth : { 4, 8, 12, 24 })
+        testBitcrusher(bitDepth, bitDepth == 4 ? 4 : 1);
+
+    testDelay(1000.0f, 0.5f);
+    testDelay(2205.37f, 0.8f);
+    testDelay(100000.5f, 0.3f);
+
+    testMixer();
+
+    if (numFailures > 0)
+    {
+        std::printf("%d checks failed\n", numFailures);
+        return 1;
+    }
+    std::printf("all checks passed\n");
+    return 0;
+}
@@ -0,0 +1,140 @@
+/*
+  ==============================================================================
+
+    ChiptuneExport.cpp
+    Created: 20 Oct 2026 11:02:17am
+    Author:  70
+
+  ==============================================================================
+*/
+
+// Command-line multi-sample export: renders a preset to WAV, IMA ADPCM or SNES BRR samples and an SFZ instrument.
+//
+//   chiptune_export <preset> <output dir> [--name N] [--notes 36-96] [--step 3] [--velocities 64,127]
+//                   [--hold 2] [--rate 44100] [--threads 0] [--bits 16|24|32] [--codec wav|adpcm|brr] [--no-loops]
+//                   [--library <folder or .RPL> [--cache <index file>]]
+//
+// With --library, <preset> is the name of a preset of the library rather than a file.
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "PresetLibrary.h"
+#include "PresetReader.h"
+#include "SampleExporter.h"
+
+static int printUsage()
+{
+    std::fprintf(stderr,
+                 "usage: chiptune_export <preset> <output dir> [--name N] [--notes 36-96] [--step 3]\n"
+                 "                       [--velocities 64,127] [--hold 2] [--rate 44100] [--threads 0]\n"
+                 "                       [--bits 16|24|32] [--codec wav|adpcm|brr] [--no-loops]\n"
+                 "                       [--library <folder or .RPL> [--cache <index file>]]\n");
+    return 1;
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 3)
+        return printUsage();
+
+    std::string presetPath = argv[1];
+    std::string directory = argv[2];
+    std::string name = "chiptune";
+    std::vector<std::string> libraryLocations;
+    std::string libraryCache;
+    SampleExporter::Settings settings;
+
+    for (int i = 3; i < argc; ++i)
+    {
+        std::string option = argv[i];
+        if (option == "--no-loops")
+        {
+            settings.detectLoops = false;
+            continue;
+        }
+        if (i + 1 >= argc)
+            return printUsage();
+
+        const char* value = argv[++i];
+        if (option == "--name")
+            name = value;
+        else if (option == "--notes")
+        {
+            settings.lowNote = std::atoi(value);
+            const char* dash = std::strchr(value, '-');
+            settings.highNote = dash != nullptr ? std::atoi(dash + 1) : settings.lowNote;
+        }
+        else if (option == "--library")
+            libraryLocations.push_back(value);
+        else if (option == "--cache")
+            libraryCache = value;
+        else if (option == "--step")
+            settings.noteStep = std::atoi(value);
+        else if (option == "--velocities")
+        {
+            settings.velocities.clear();
+            for (const char* p = value; p != nullptr; p = std::strchr(p, ','))
+                settings.velocities.push_back(std::atoi(*p == ',' ? ++p : p));
+        }
+        else if (option == "--hold")
+            settings.holdSeconds = static_cast<float>(std::atof(value));
+        else if (option == "--rate")
+            settings.sampleRate = std::atof(value);
+        else if (option == "--threads")
+            settings.numThreads = std::atoi(value);
+        else if (option == "--bits")
+            settings.format = std::atoi(value) == 24 ? WavWriter::Format::pcm24
+                            : std::atoi(value) == 32 ? WavWriter::Format::float32 : WavWriter::Format::pcm16;
+        else if (option == "--codec")
+        {
+            std::string codec = value;
+            if (codec == "wav")
+                settings.codec = SampleExporter::Codec::wav;
+            else if (codec == "adpcm")
+                settings.codec = SampleExporter::Codec::imaAdpcm;
+            else if (codec == "brr")
+                settings.codec = SampleExporter::Codec::brr;
+            else
+                return printUsage();
+        }
+        else
+            return printUsage();
+    }
+
+    ChiptuneParameters parameters;
+    if (! libraryLocations.empty())
+    {
+        PresetLibrary library;
+        library.open(libraryLocations, libraryCache);
+        int index = library.indexOf(presetPath);
+        if (index < 0 || ! library.load(index, parameters))
+        {
+            std::fprintf(stderr, "cannot find a preset named %s in the library (%d presets)\n",
+                         presetPath.c_str(), library.getNumPresets());
+            return 1;
+        }
+    }
+    else if (! PresetReader::load(presetPath, parameters))
+    {
+        std::fprintf(stderr, "cannot read a preset from %s\n", presetPath.c_str());
+        return 1;
+    }
+
+    auto result = SampleExporter::exportSfz(parameters, settings, directory, name);
+    if (! result.ok)
+    {
+        std::fprintf(stderr, "export failed: %s\n", result.error.c_str());
+        return 1;
+    }
+
+    if (settings.codec != SampleExporter::Codec::wav)
+        for (const auto& sample : result.samples)
+            std::printf("%s: SNR %.1f dB\n", sample.fileName.c_str(), sample.snr);
+
+    std::printf("%s: %d samples (%d looped) in %.2f s on %d threads\n",
+                result.sfzPath.c_str(), result.numSamples, result.numLooped, result.seconds, result.numThreads);
+    return 0;
+}
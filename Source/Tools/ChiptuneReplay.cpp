@@ -0,0 +1,169 @@
+/*
+  ==============================================================================
+
+    ChiptuneReplay.cpp
+    Created: 26 Oct 2026 7:14:40pm
+    Author:  70
+
+  ==============================================================================
+*/
+
+// Command-line session replay: plays a log written by the plugin's session capture or flight recorder
+// (see SessionRecorder.h) through the engine, offline, so a real session can be run under a profiler.
+//
+//   chiptune_replay <log> [--repeat 1] [--top 10] [--output <file.wav>]
+//
+// Every block is rendered the way processBlock() rendered it, and checked bit for bit against the
+// capture. The tool prints whether the replay matched, the replay time per block, and the blocks that
+// took longest in the capture, with their replay time. --repeat plays the log several times, for a
+// profiler to collect more samples; --output writes the replayed main output of the first pass.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include "SessionPlayer.h"
+#include "WavWriter.h"
+
+namespace
+{
+    int printUsage()
+    {
+        std::fprintf(stderr, "usage: chiptune_replay <log> [--repeat 1] [--top 10] [--output <file.wav>]\n");
+        return 1;
+    }
+
+    /// A block of the first pass, for the report.
+    struct BlockTiming
+    {
+        int64_t index;
+        uint32_t numSamples;
+        double capturedSeconds;
+        double replaySeconds;
+        bool missedDeadline;
+        bool matches;
+    };
+
+    double percentile(std::vector<double> values, double fraction)
+    {
+        if (values.empty())
+            return 0.0;
+        size_t rank = std::min(values.size() - 1, static_cast<size_t>(fraction * static_cast<double>(values.size())));
+        std::nth_element(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(rank), values.end());
+        return values[rank];
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2)
+        return printUsage();
+
+    std::string logPath = argv[1];
+    std::string outputPath;
+    int numPasses = 1;
+    int numTop = 10;
+    for (int i = 2; i + 1 < argc; i += 2)
+    {
+        std::string option = argv[i];
+        const char* value = argv[i + 1];
+        if (option == "--repeat")
+            numPasses = std::max(1, std::atoi(value));
+        else if (option == "--top")
+            numTop = std::max(0, std::atoi(value));
+        else if (option == "--output")
+            outputPath = value;
+        else
+            return printUsage();
+    }
+
+    SessionPlayer player;
+    if (! player.load(logPath))
+    {
+        std::fprintf(stderr, "cannot read a session log from %s\n", logPath.c_str());
+        return 1;
+    }
+
+    std::vector<BlockTiming> blocks;
+    std::vector<double> replayTimes;
+    WavWriter writer;
+    int64_t numSamples = 0;
+    int numMissed = 0;
+    double capturedSeconds = 0.0, replaySeconds = 0.0, audioSeconds = 0.0;
+
+    auto startTime = std::chrono::steady_clock::now();
+    for (int pass = 0; pass < numPasses; ++pass)
+    {
+        player.rewind();
+        SessionPlayer::Block block;
+        while (player.next(block))
+        {
+            replayTimes.push_back(block.seconds);
+            replaySeconds += block.seconds;
+            if (pass > 0)
+                continue;
+
+            bool missed = (block.info.flags & SessionLog::missedDeadline) != 0;
+            blocks.push_back({ block.index, block.info.numSamples, block.info.elapsedNanoseconds * 1.0e-9,
+                               block.seconds, missed, block.matches });
+            numSamples += block.info.numSamples;
+            numMissed += missed ? 1 : 0;
+            capturedSeconds += block.info.elapsedNanoseconds * 1.0e-9;
+            audioSeconds += block.info.numSamples / player.getSampleRate();
+
+            // The file keeps the sample rate of the first block, the capture may have changed it later
+            if (! outputPath.empty() && ! writer.isOpen()
+                && ! writer.open(outputPath, player.getSampleRate(), std::max(1, player.getNumOutputChannels()), WavWriter::Format::float32))
+            {
+                std::fprintf(stderr, "cannot write %s\n", outputPath.c_str());
+                return 1;
+            }
+            if (writer.isOpen() && player.getNumOutputChannels() > 0)
+            {
+                const float* channels[ChiptuneEngine::maxChannels] = { player.getOutput(0), player.getOutput(1) };
+                if (channels[1] == nullptr)
+                    channels[1] = channels[0];
+                writer.write(channels, static_cast<int>(block.info.numSamples));
+            }
+        }
+
+        if (pass == 0 && player.getNumMismatches() > 0)
+            std::printf("%lld of %zu blocks differ from the capture%s\n", static_cast<long long>(player.getNumMismatches()), blocks.size(),
+                        player.isExact() ? "" : ", after blocks lost by the capture or outside a flight recorder window, or an engine state from another build");
+    }
+    double totalSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    writer.close();
+
+    if (blocks.empty())
+    {
+        std::printf("no blocks in %s\n", logPath.c_str());
+        return 0;
+    }
+
+    int numMatching = static_cast<int>(std::count_if(blocks.begin(), blocks.end(), [] (const BlockTiming& b) { return b.matches; }));
+    std::printf("%zu blocks, %lld samples, %.1f s of audio at %.0f Hz\n", blocks.size(), static_cast<long long>(numSamples),
+                audioSeconds, player.getSampleRate());
+    std::printf("bit-exact: %s (%d of %zu blocks)\n", numMatching == static_cast<int>(blocks.size()) ? "yes" : "no", numMatching, blocks.size());
+    std::printf("captured: %.3f s rendering, %d blocks missed their deadline\n", capturedSeconds, numMissed);
+    std::printf("replay:   %.3f s rendering over %d pass%s (%.1fx real time), %.3f s in total\n", replaySeconds, numPasses,
+                numPasses > 1 ? "es" : "", audioSeconds * numPasses / std::max(replaySeconds, 1.0e-9), totalSeconds);
+    std::printf("per block: mean %.1f us, p99 %.1f us, max %.1f us\n", replaySeconds / replayTimes.size() * 1.0e6,
+                percentile(replayTimes, 0.99) * 1.0e6, *std::max_element(replayTimes.begin(), replayTimes.end()) * 1.0e6);
+
+    // The slowest blocks of the capture, which are the ones to profile
+    numTop = std::min(numTop, static_cast<int>(blocks.size()));
+    std::partial_sort(blocks.begin(), blocks.begin() + numTop, blocks.end(),
+                      [] (const BlockTiming& a, const BlockTiming& b) { return a.capturedSeconds > b.capturedSeconds; });
+    if (numTop > 0)
+        std::printf("\n   block  samples  captured us  replay us\n");
+    for (int i = 0; i < numTop; ++i)
+    {
+        const auto& block = blocks[i];
+        std::printf("%8lld  %7u  %11.1f  %9.1f%s%s\n", static_cast<long long>(block.index), block.numSamples,
+                    block.capturedSeconds * 1.0e6, block.replaySeconds * 1.0e6,
+                    block.missedDeadline ? "  missed" : "", block.matches ? "" : "  differs");
+    }
+    return numMatching == static_cast<int>(blocks.size()) ? 0 : 2;
+}
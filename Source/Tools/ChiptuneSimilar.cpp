@@ -0,0 +1,323 @@
+/*
+  ==============================================================================
+
+    ChiptuneSimilar.cpp
+    Created: 25 Oct 2026 6:20:31pm
+    Author:  70
+
+  ==============================================================================
+*/
+
+// Command-line sound search: finds the parameter sets that sound closest to a WAV file or a preset.
+//
+//   chiptune_similar build <index> [--variations 200] [--preset <file>]... [--library <folder or .RPL>]...
+//                          [--threads 0] [--seed N]
+//   chiptune_similar query <index> <reference .wav or preset> [--count 5] [--length 1]
+//
+// build renders variations of the built-in programs and of the given presets, each a note held for
+// 0.3 s then released, and adds the ones the index does not hold yet. query prints the closest parameter sets; --length 0.5 looks for a sound half
+// as long as the reference, --length 2 for one twice as long.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+#include "ChiptuneRandom.h"
+#include "PresetLibrary.h"
+#include "PresetReader.h"
+#include "ProgramBank.h"
+#include "SampleExporter.h"
+#include "SoundFeatures.h"
+#include "SoundIndex.h"
+#include "WavReader.h"
+
+namespace
+{
+    const double sampleRate = 44100.0;
+    const int note = 60;
+    const float holdSeconds = 0.3f;
+
+    /// A parameter the variations change, with the range of the plugin's parameter layout.
+    struct Dimension
+    {
+        ChiptuneParameters::Index index;
+        float minValue, maxValue;
+        bool isStepped; // Switches, choices and integers.
+        bool isLog;     // Times, which vary by ratios.
+    };
+
+    const Dimension dimensions[] =
+    {
+        { ChiptuneParameters::pulseWidth,  0.0f,   2.0f,  true,  false },
+        { ChiptuneParameters::pwmSwitch,   0.0f,   1.0f,  true,  false },
+        { ChiptuneParameters::pwmMode,     0.0f,   5.0f,  true,  false },
+        { ChiptuneParameters::pwmRate,     0.0f,   1.0f,  false, false },
+        { ChiptuneParameters::pbSwitch,    0.0f,   1.0f,  true,  false },
+        { ChiptuneParameters::pbInitPitch, -24.0f, 24.0f, true,  false },
+        { ChiptuneParameters::pbTime,      0.01f,  3.0f,  false, true  },
+        { ChiptuneParameters::pbEndPitch,  -24.0f, 24.0f, true,  false },
+        { ChiptuneParameters::pbEndTime,   0.01f,  3.0f,  false, true  },
+        { ChiptuneParameters::vibSwitch,   0.0f,   1.0f,  true,  false },
+        { ChiptuneParameters::vibSpeed,    0.0f,   1.0f,  false, false },
+        { ChiptuneParameters::vibAmount,   0.0f,   1.0f,  false, false },
+        { ChiptuneParameters::arpSwitch,   0.0f,   1.0f,  true,  false },
+        { ChiptuneParameters::arpPattern,  0.0f,   8.0f,  true,  false },
+        { ChiptuneParameters::arpSpeed,    0.0f,   1.0f,  false, false },
+        { ChiptuneParameters::attack,      0.01f,  5.0f,  false, true  },
+        { ChiptuneParameters::decay,       0.01f,  5.0f,  false, true  },
+        { ChiptuneParameters::sustain,     0.0f,   1.0f,  false, false },
+        { ChiptuneParameters::release,     0.01f,  5.0f,  false, true  },
+        { ChiptuneParameters::envCurve,    0.0f,   2.0f,  true,  false },
+    };
+
+    /// Rounds to 3 significant digits, so the parameter sets stay short and readable.
+    float roundValue(float value)
+    {
+        if (value == 0.0f)
+            return 0.0f;
+        float scale = std::pow(10.0f, 2.0f - std::floor(std::log10(std::abs(value))));
+        return std::round(value * scale) / scale;
+    }
+
+    /// Returns a variation of a parameter set, changing 1 to 3 of the dimensions. The same seed gives the same variation.
+    ChiptuneParameters makeVariation(const ChiptuneParameters& base, uint64_t seed)
+    {
+        ChiptuneRandom random(seed);
+        ChiptuneParameters parameters = base;
+        int numChanges = random.nextInt(1, 3);
+        const int numDimensions = static_cast<int>(sizeof(dimensions) / sizeof(dimensions[0]));
+        for (int i = 0; i < numChanges; ++i)
+        {
+            const auto& dimension = dimensions[random.nextInt(numDimensions)];
+            float value = parameters.get(dimension.index);
+            if (dimension.isStepped)
+                value = static_cast<float>(random.nextInt(static_cast<int>(dimension.minValue), static_cast<int>(dimension.maxValue)));
+            else if (dimension.isLog)
+                value = std::max(value, dimension.minValue) * std::exp2(random.nextFloat() * 4.0f - 2.0f); // Within two octaves
+            else
+                value += (random.nextFloat() - 0.5f) * 0.5f * (dimension.maxValue - dimension.minValue);
+            parameters.set(dimension.index, roundValue(std::clamp(value, dimension.minValue, dimension.maxValue)));
+        }
+        return parameters;
+    }
+
+    /// Returns a hash of a text that does not change between runs, unlike std::hash (FNV-1a).
+    uint64_t hashText(const std::string& text)
+    {
+        uint64_t hash = 0xcbf29ce484222325;
+        for (char c : text)
+            hash = (hash ^ static_cast<uint8_t>(c)) * 0x100000001b3;
+        return hash;
+    }
+
+    /// Renders a note held for holdSeconds, then released, and returns its features.
+    SoundFeatures::Vector renderFeatures(const ChiptuneParameters& parameters, uint64_t seed)
+    {
+        SampleExporter::Settings settings;
+        settings.sampleRate = sampleRate;
+        settings.holdSeconds = holdSeconds;
+        settings.detectLoops = false;
+
+        SampleExporter::Sample sample;
+        sample.note = note;
+        SampleExporter::renderSample(parameters, settings, seed, sample);
+        return SoundFeatures::extract(sample.audio.data(), sample.audio.size(), sampleRate);
+    }
+
+    int printUsage()
+    {
+        std::fprintf(stderr,
+                     "usage: chiptune_similar build <index> [--variations 200] [--preset <file>]... [--library <folder or .RPL>]...\n"
+                     "                              [--threads 0] [--seed N]\n"
+                     "       chiptune_similar query <index> <reference .wav or preset> [--count 5] [--length 1]\n");
+        return 1;
+    }
+
+    double secondsSince(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    //==============================================================================
+    int build(const std::string& indexPath, int argc, char* argv[])
+    {
+        int numVariations = 200;
+        int numThreads = 0;
+        uint64_t seed = 0x43686970;
+        std::vector<ChiptuneParameters> bases;
+        std::vector<std::string> libraryLocations;
+
+        ProgramBank programs;
+        for (int i = 0; i < programs.getNumPrograms(); ++i)
+            bases.push_back(programs.getProgram(i).parameters);
+
+        for (int i = 0; i + 1 < argc; i += 2)
+        {
+            std::string option = argv[i];
+            const char* value = argv[i + 1];
+            if (option == "--variations")
+                numVariations = std::max(0, std::atoi(value));
+            else if (option == "--threads")
+                numThreads = std::atoi(value);
+            else if (option == "--seed")
+                seed = std::strtoull(value, nullptr, 0);
+            else if (option == "--library")
+                libraryLocations.push_back(value);
+            else if (option == "--preset")
+            {
+                ChiptuneParameters parameters;
+                if (! PresetReader::load(value, parameters))
+                {
+                    std::fprintf(stderr, "cannot read a preset from %s\n", value);
+                    return 1;
+                }
+                bases.push_back(parameters);
+            }
+            else
+                return printUsage();
+        }
+        if (argc % 2 != 0)
+            return printUsage();
+
+        if (! libraryLocations.empty())
+        {
+            PresetLibrary library;
+            library.open(libraryLocations, {});
+            for (int i = 0; i < library.getNumPresets(); ++i)
+            {
+                ChiptuneParameters parameters;
+                if (library.load(i, parameters))
+                    bases.push_back(parameters);
+            }
+        }
+
+        // Variation 0 of a base is the base itself. Each variation is seeded by its base, so the same base always
+        // gives the same variations, and only the parameter sets the index lacks are rendered.
+        SoundIndex index;
+        index.load(indexPath);
+        int numReused = 0;
+        std::vector<std::string> pending;
+        std::unordered_set<std::string> pendingSet;
+        for (size_t b = 0; b < bases.size(); ++b)
+        {
+            auto baseSeed = ChiptuneRandom::deriveSeed(seed, hashText(SoundIndex::describe(bases[b])));
+            for (int v = 0; v <= numVariations; ++v)
+            {
+                auto variation = v == 0 ? bases[b] : makeVariation(bases[b], ChiptuneRandom::deriveSeed(baseSeed, static_cast<uint64_t>(v)));
+                auto description = SoundIndex::describe(variation);
+                if (index.contains(description))
+                    ++numReused;
+                else if (pendingSet.insert(description).second)
+                    pending.push_back(description);
+            }
+        }
+
+        // Render on a pool of threads, each taking the next parameter set
+        auto startTime = std::chrono::steady_clock::now();
+        numThreads = numThreads > 0 ? numThreads : std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+        numThreads = std::max(1, std::min(numThreads, static_cast<int>(pending.size())));
+        std::vector<SoundFeatures::Vector> rendered(pending.size());
+        std::atomic<int> nextJob { 0 };
+        auto worker = [&]()
+        {
+            for (int job = nextJob++; job < static_cast<int>(pending.size()); job = nextJob++)
+            {
+                const auto& description = pending[static_cast<size_t>(job)];
+                rendered[static_cast<size_t>(job)] = renderFeatures(SoundIndex::parse(description), hashText(description));
+            }
+        };
+
+        std::vector<std::thread> threads;
+        for (int i = 1; i < numThreads; ++i)
+            threads.emplace_back(worker);
+        worker();
+        for (auto& thread : threads)
+            thread.join();
+
+        for (size_t i = 0; i < pending.size(); ++i)
+            index.add(pending[i], rendered[i]);
+
+        if (! index.save(indexPath))
+        {
+            std::fprintf(stderr, "cannot write %s\n", indexPath.c_str());
+            return 1;
+        }
+
+        std::printf("%s: %d parameter sets, %d rendered in %.2f s on %d threads, %d reused\n",
+                    indexPath.c_str(), index.size(), static_cast<int>(pending.size()), secondsSince(startTime), numThreads, numReused);
+        return 0;
+    }
+
+    //==============================================================================
+    int query(const std::string& indexPath, const std::string& referencePath, int argc, char* argv[])
+    {
+        int count = 5;
+        float lengthFactor = 1.0f;
+        for (int i = 0; i + 1 < argc; i += 2)
+        {
+            std::string option = argv[i];
+            if (option == "--count")
+                count = std::atoi(argv[i + 1]);
+            else if (option == "--length")
+                lengthFactor = static_cast<float>(std::atof(argv[i + 1]));
+            else
+                return printUsage();
+        }
+        if (argc % 2 != 0)
+            return printUsage();
+
+        SoundIndex index;
+        if (! index.load(indexPath))
+        {
+            std::fprintf(stderr, "cannot read %s, or it was built by another version: run build again\n", indexPath.c_str());
+            return 1;
+        }
+
+        // The reference is a recording, or a preset rendered like the entries
+        SoundFeatures::Vector reference;
+        std::vector<float> audio;
+        double referenceRate = 0.0;
+        ChiptuneParameters parameters;
+        if (WavReader::readMono(referencePath, audio, referenceRate))
+            reference = SoundFeatures::extract(audio.data(), audio.size(), referenceRate);
+        else if (PresetReader::load(referencePath, parameters))
+            reference = renderFeatures(parameters, hashText(SoundIndex::describe(parameters)));
+        else
+        {
+            std::fprintf(stderr, "cannot read a WAV file or a preset from %s\n", referencePath.c_str());
+            return 1;
+        }
+        SoundFeatures::scaleLength(reference, lengthFactor);
+
+        auto startTime = std::chrono::steady_clock::now();
+        auto matches = index.search(reference, count);
+        double searchSeconds = secondsSince(startTime);
+
+        for (const auto& match : matches)
+        {
+            const auto& description = index.getDescription(match.index);
+            std::printf("%6.3f  %s\n", match.distance, description.empty() ? "(defaults)" : description.c_str());
+        }
+        std::printf("searched %d parameter sets in %.3f ms\n", index.size(), searchSeconds * 1000.0);
+        return 0;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 3)
+        return printUsage();
+
+    std::string command = argv[1];
+    if (command == "build")
+        return build(argv[2], argc - 3, argv + 3);
+    if (command == "query" && argc >= 4)
+        return query(argv[2], argv[3], argc - 4, argv + 4);
+    return printUsage();
+}